@@ -0,0 +1,70 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rbdyn/RobotLoader.h>
+#include <mc_rbdyn/Robots.h>
+#include <mc_solver/CollisionsConstraint.h>
+#include <mc_solver/TVMQPSolver.h>
+#include <mc_tasks/PostureTask.h>
+
+#include <spdlog/spdlog.h>
+
+#include "benchmark/benchmark.h"
+
+/** Run the TVM solver with a self-collision constraint on JVRC1
+ *
+ * Arguments: number of collision pairs, number of threads
+ */
+static void BM_CollisionsConstraint(benchmark::State & state)
+{
+  spdlog::set_level(spdlog::level::err);
+  auto rm = mc_rbdyn::RobotLoader::get_robot_module("JVRC1");
+  mc_solver::TVMQPSolver solver(0.005);
+  solver.robots().load(*rm);
+  solver.realRobots().load(*rm);
+  const auto & robot = solver.robot();
+
+  // Pairs of convexes attached to bodies that are not directly connected
+  auto adjacent = [&](const std::string & b1, const std::string & b2)
+  {
+    auto i1 = static_cast<int>(robot.bodyIndexByName(b1));
+    auto i2 = static_cast<int>(robot.bodyIndexByName(b2));
+    return i1 == i2 || robot.mb().parent(i1) == i2 || robot.mb().parent(i2) == i1;
+  };
+  std::vector<mc_rbdyn::Collision> cols;
+  auto nPairs = static_cast<size_t>(state.range(0));
+  for(auto c1 = robot.convexes().begin(); c1 != robot.convexes().end() && cols.size() < nPairs; ++c1)
+  {
+    for(auto c2 = std::next(c1); c2 != robot.convexes().end() && cols.size() < nPairs; ++c2)
+    {
+      if(adjacent(c1->second.first, c2->second.first)) { continue; }
+      cols.push_back({c1->first, c2->first, 0.1, 0.05, 0.0});
+    }
+  }
+  if(cols.size() < nPairs)
+  {
+    state.SkipWithError("Not enough convexes in JVRC1");
+    return;
+  }
+
+  mc_solver::CollisionsConstraint constraint(solver.robots(), 0, 0, solver.dt());
+  constraint.automaticMonitor(false);
+  // Evaluate every pair in the narrow phase
+  constraint.broadPhase(false);
+  constraint.threads(static_cast<size_t>(state.range(1)));
+  solver.addConstraintSet(constraint);
+  constraint.addCollisions(solver, cols);
+
+  auto posture = std::make_shared<mc_tasks::PostureTask>(solver, 0, 1.0, 1.0);
+  solver.addTask(posture);
+
+  for(auto _ : state) { solver.run(); }
+  state.counters["pairs"] = static_cast<double>(cols.size());
+}
+BENCHMARK(BM_CollisionsConstraint)
+    ->ArgNames({"pairs", "threads"})
+    ->ArgsProduct({{25, 100, 400}, {1, 2, 4}})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_control/mc_global_controller.h>
+#include <mc_solver/CollisionsConstraint.h>
+#include <mc_tasks/EndEffectorTask.h>
+
+#include <spdlog/spdlog.h>
+
+#include "benchmark/benchmark.h"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+
+namespace bfs = boost::filesystem;
+
+/** Runs MCGlobalController headless on the sample controllers
+ *
+ * Arguments:
+ * - number of extra end-effector tasks added to the controller
+ * - number of self-collisions added to the controller (capped by the robot's common self-collisions)
+ *
+ * Counters report the mean time per iteration (ms) of each phase of MCGlobalController::run and of the solver.
+ */
+
+namespace
+{
+
+std::string makeConfig(const std::string & controller, const bfs::path & logDirectory)
+{
+  mc_rtc::Configuration config;
+  config.add("MainRobot", "JVRC1");
+  config.add("Enabled", std::vector<std::string>{controller});
+  config.add("Timestep", 0.005);
+  config.add("Log", true);
+  config.add("LogPolicy", "non-threaded");
+  config.add("LogDirectory", logDirectory.string());
+  config.add("LogTemplate", "mc-rtc-bench");
+  config.add("ClearControllerModulePath", true);
+  // Libraries and etc folders of the sample controllers in the build tree, the configurations of the FSM samples
+  // refer to the install tree and are replaced by build-tree configurations generated for this benchmark
+  config.add("ControllerModulePaths",
+             std::vector<std::string>{"@CMAKE_BINARY_DIR@/src/mc_control/samples/Posture",
+                                      "@CMAKE_BINARY_DIR@/src/mc_control/samples/CoM",
+                                      "@CMAKE_BINARY_DIR@/src/mc_control/samples/EndEffector",
+                                      "@CMAKE_BINARY_DIR@/src/mc_control/samples/FSM/src",
+                                      "@CMAKE_BINARY_DIR@/src/mc_control/samples/LIPMStabilizer/src",
+                                      "@CMAKE_CURRENT_BINARY_DIR@/benchGlobalController"});
+  config.add("ClearRobotModulePath", true);
+  config.add("RobotModulePaths", std::vector<std::string>{"@CMAKE_BINARY_DIR@/src/mc_robots"});
+  config.add("ClearObserverModulePath", true);
+  config.add("ObserverModulePaths", std::vector<std::string>{"@CMAKE_BINARY_DIR@/src/mc_observers"});
+  config.add("GUIServer").add("Enable", false);
+  auto path = (bfs::temp_directory_path() / bfs::unique_path("mc-rtc-bench-%%%%-%%%%.yaml")).string();
+  config.save(path);
+  return path;
+}
+
+void addTasks(mc_control::MCController & ctl, size_t nTasks, std::vector<std::shared_ptr<mc_tasks::MetaTask>> & out)
+{
+  const auto & bodies = ctl.robot().mb().bodies();
+  for(size_t i = 0; i < nTasks; ++i)
+  {
+    const auto & body = bodies[1 + i % (bodies.size() - 1)];
+    auto task = std::make_shared<mc_tasks::EndEffectorTask>(body.name(), ctl.robots(), ctl.robot().robotIndex(), 2.0,
+                                                            1.0);
+    task->name(fmt::format("bench_{}_{}", body.name(), i));
+    ctl.solver().addTask(task);
+    out.push_back(task);
+  }
+}
+
+void BM_GlobalController(benchmark::State & state, const std::string & controller)
+{
+  spdlog::set_level(spdlog::level::err);
+  // The logs are written as part of the benchmarked loop but they are not kept
+  auto logDirectory = bfs::temp_directory_path() / bfs::unique_path("mc-rtc-bench-%%%%-%%%%");
+  bfs::create_directories(logDirectory);
+  auto config = makeConfig(controller, logDirectory);
+  std::unique_ptr<mc_control::MCGlobalController> gc;
+  try
+  {
+    gc = std::make_unique<mc_control::MCGlobalController>(config);
+    gc->init();
+  }
+  catch(const std::exception & exc)
+  {
+    gc.reset();
+    bfs::remove(config);
+    bfs::remove_all(logDirectory);
+    mc_rtc::log::error_and_throw("[benchGlobalController] Failed to start {}: {}", controller, exc.what());
+  }
+  bfs::remove(config);
+
+  auto & ctl = gc->controller();
+  mc_solver::QPSolver::context_backend(ctl.solver().backend());
+  std::vector<std::shared_ptr<mc_tasks::MetaTask>> tasks;
+  addTasks(ctl, static_cast<size_t>(state.range(0)), tasks);
+  const auto & collisions = ctl.robot().module().commonSelfCollisions();
+  auto nCollisions = std::min(static_cast<size_t>(state.range(1)), collisions.size());
+  mc_solver::CollisionsConstraint selfCollisions(ctl.robots(), ctl.robot().robotIndex(), ctl.robot().robotIndex(),
+                                                 ctl.solver().dt());
+  if(nCollisions)
+  {
+    selfCollisions.addCollisions(ctl.solver(), {collisions.begin(), collisions.begin() + nCollisions});
+    ctl.solver().addConstraintSet(selfCollisions);
+  }
+
+  mc_solver::QPSolver::Timings solverTimings;
+  gc->resetLatencyStats();
+  bool failed = false;
+  for(auto _ : state)
+  {
+    if(!gc->run())
+    {
+      failed = true;
+      break;
+    }
+    const auto & t = ctl.solver().timings();
+    solverTimings.update += t.update;
+    solverTimings.build += t.build;
+    solverTimings.solve += t.solve;
+    solverTimings.robots += t.robots;
+  }
+
+  double iterations = static_cast<double>(std::max<benchmark::IterationCount>(state.iterations(), 1));
+  state.counters["solver_update"] = solverTimings.update / iterations;
+  state.counters["solver_build"] = solverTimings.build / iterations;
+  state.counters["solver_solve"] = solverTimings.solve / iterations;
+  state.counters["solver_robots"] = solverTimings.robots / iterations;
+  for(const auto & phase : gc->latencyStats().phases)
+  {
+    if(phase.second.total.count()) { state.counters[phase.first] = phase.second.total.mean(); }
+  }
+  state.counters["collisions"] = static_cast<double>(nCollisions);
+
+  if(nCollisions) { ctl.solver().removeConstraintSet(selfCollisions); }
+  for(auto & t : tasks) { ctl.solver().removeTask(t); }
+  gc.reset();
+  bfs::remove_all(logDirectory);
+  if(failed) { mc_rtc::log::error_and_throw("[benchGlobalController] {} failed to run", controller); }
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+  for(const auto & controller : {"Posture", "CoM", "EndEffector", "LIPMStabilizer", "FSM"})
+  {
+    for(const auto & suffix : {"", "_TVM"})
+    {
+      std::string name = std::string(controller) + suffix;
+      auto * bench = benchmark::RegisterBenchmark(("BM_GlobalController/" + name).c_str(), BM_GlobalController, name);
+      for(int nTasks : {0, 8, 32})
+      {
+        for(int nCollisions : {0, 16}) { bench->Args({nTasks, nCollisions}); }
+      }
+      bench->ArgNames({"tasks", "collisions"})->Unit(benchmark::kMillisecond);
+    }
+  }
+  benchmark::Initialize(&argc, argv);
+  if(benchmark::ReportUnrecognizedArguments(argc, argv)) { return 1; }
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
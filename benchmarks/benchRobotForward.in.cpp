@@ -0,0 +1,56 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rbdyn/RobotLoader.h>
+#include <mc_rbdyn/Robots.h>
+
+#include <spdlog/spdlog.h>
+
+#include "benchmark/benchmark.h"
+
+/** Compare the sequential forwardKinematics/forwardVelocity/forwardAcceleration to the fused forwardAll
+ *
+ * JVRC1 (with its fingers) is the 40+ DoF case, the dof counter reports the size of each model
+ */
+
+static mc_rbdyn::RobotsPtr loadRobot(const std::string & module)
+{
+  static bool initialized = []()
+  {
+    spdlog::set_level(spdlog::level::err);
+    mc_rbdyn::RobotLoader::clear();
+    mc_rtc::Loader::debug_suffix = "";
+    mc_rbdyn::RobotLoader::update_robot_module_path({"@CMAKE_CURRENT_BINARY_DIR@/../src/mc_robots"});
+    return true;
+  }();
+  (void)initialized;
+  return mc_rbdyn::loadRobot(*mc_rbdyn::RobotLoader::get_robot_module(module));
+}
+
+static void BM_Sequential(benchmark::State & state, const std::string & module)
+{
+  auto robots = loadRobot(module);
+  auto & robot = robots->robot();
+  for(auto _ : state)
+  {
+    robot.forwardKinematics();
+    robot.forwardVelocity();
+    robot.forwardAcceleration();
+  }
+  state.counters["dof"] = static_cast<double>(robot.mb().nrDof());
+}
+BENCHMARK_CAPTURE(BM_Sequential, JVRC1NoHands, std::string("JVRC1NoHands"))->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_Sequential, JVRC1, std::string("JVRC1"))->Unit(benchmark::kMicrosecond);
+
+static void BM_ForwardAll(benchmark::State & state, const std::string & module)
+{
+  auto robots = loadRobot(module);
+  auto & robot = robots->robot();
+  for(auto _ : state) { robot.forwardAll(); }
+  state.counters["dof"] = static_cast<double>(robot.mb().nrDof());
+}
+BENCHMARK_CAPTURE(BM_ForwardAll, JVRC1NoHands, std::string("JVRC1NoHands"))->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ForwardAll, JVRC1, std::string("JVRC1"))->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
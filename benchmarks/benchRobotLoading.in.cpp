@@ -4,8 +4,11 @@
 
 #include <mc_rbdyn/RobotLoader.h>
 #include <mc_rbdyn/Robots.h>
+#include <mc_rtc/path.h>
 #include <mc_rtc/pragma.h>
 
+#include <boost/filesystem.hpp>
+
 #include <spdlog/spdlog.h>
 
 #include "benchmark/benchmark.h"
@@ -37,6 +40,19 @@ BENCHMARK_DEFINE_F(RobotLoadingFixture, RobotModuleLoading)(benchmark::State & s
 }
 BENCHMARK_REGISTER_F(RobotLoadingFixture, RobotModuleLoading)->Unit(benchmark::kMicrosecond);
 
+BENCHMARK_DEFINE_F(RobotLoadingFixture, RobotModuleLoadingFromBundle)(benchmark::State & state)
+{
+  auto bundles_dir = mc_rtc::temp_directory_path("mc_rtc_bench_robot_bundles");
+  boost::filesystem::remove_all(bundles_dir);
+  mc_rbdyn::RobotLoader::enable_bundles(bundles_dir);
+  // Produce the bundle
+  mc_rbdyn::RobotLoader::get_robot_module("JVRC1");
+  while(state.KeepRunning()) { auto rm = mc_rbdyn::RobotLoader::get_robot_module("JVRC1"); }
+  mc_rbdyn::RobotLoader::disable_bundles();
+  boost::filesystem::remove_all(bundles_dir);
+}
+BENCHMARK_REGISTER_F(RobotLoadingFixture, RobotModuleLoadingFromBundle)->Unit(benchmark::kMicrosecond);
+
 BENCHMARK_DEFINE_F(RobotLoadingFixture, RobotCreation)(benchmark::State & state)
 {
   auto rm = mc_rbdyn::RobotLoader::get_robot_module("JVRC1");
@@ -49,11 +65,25 @@ BENCHMARK_DEFINE_F(RobotLoadingFixture, RobotCopy)(benchmark::State & state)
   auto rm = mc_rbdyn::RobotLoader::get_robot_module("JVRC1");
   auto robots_ptr = mc_rbdyn::loadRobot(*rm);
   const auto & robots = *robots_ptr;
+  size_t shared_modules = 0;
+  size_t shared_graphs = 0;
   while(state.KeepRunning())
   {
     auto robots_copy = mc_rbdyn::Robots::make();
     for(const auto & r : robots) { robots_copy->robotCopy(r, r.name()); }
+    state.PauseTiming();
+    const auto & copies = *robots_copy;
+    for(size_t i = 0; i < robots.size(); ++i)
+    {
+      shared_modules += &robots.robot(i).module() == &copies.robot(i).module();
+      shared_graphs += &robots.robot(i).mbg() == &copies.robot(i).mbg();
+    }
+    state.ResumeTiming();
   }
+  // Number of module and graph copies avoided per robot copy
+  double n_copies = static_cast<double>(state.iterations()) * static_cast<double>(robots.size());
+  state.counters["SharedModules"] = static_cast<double>(shared_modules) / n_copies;
+  state.counters["SharedGraphs"] = static_cast<double>(shared_graphs) / n_copies;
 }
 BENCHMARK_REGISTER_F(RobotLoadingFixture, RobotCopy)->Unit(benchmark::kMicrosecond);
 
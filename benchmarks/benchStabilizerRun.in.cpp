@@ -0,0 +1,103 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rbdyn/RobotLoader.h>
+#include <mc_rbdyn/Robots.h>
+#include <mc_rtc/AllocationTracker.h>
+#include <mc_rtc/constants.h>
+#include <mc_solver/TasksQPSolver.h>
+#include <mc_tasks/MetaTaskLoader.h>
+#include <mc_tasks/lipm_stabilizer/StabilizerTask.h>
+
+#include <spdlog/spdlog.h>
+
+#include "benchmark/benchmark.h"
+
+/** Benchmark StabilizerTask::run() in double support (wrench distribution or CoP distribution over a horizon) and in
+ * single support (wrench saturation)
+ *
+ * The allocs counter reports the number of memory allocations per iteration (see mc_rtc::AllocationTracker)
+ */
+
+using StabilizerTask = mc_tasks::lipm_stabilizer::StabilizerTask;
+using ContactState = mc_tasks::lipm_stabilizer::ContactState;
+
+class StabilizerFixture : public benchmark::Fixture
+{
+public:
+  StabilizerFixture()
+  {
+    spdlog::set_level(spdlog::level::err);
+    mc_rbdyn::RobotLoader::clear();
+    mc_rtc::Loader::debug_suffix = "";
+    mc_rbdyn::RobotLoader::update_robot_module_path({"@CMAKE_CURRENT_BINARY_DIR@/../src/mc_robots"});
+    auto rm = mc_rbdyn::RobotLoader::get_robot_module("JVRC1");
+    solver.robots().load(*rm);
+    solver.realRobots().load(*rm);
+  }
+
+  void SetUp(const ::benchmark::State &) override
+  {
+    stabilizer = mc_tasks::MetaTaskLoader::load<StabilizerTask>(
+        solver, mc_rtc::Configuration("@CMAKE_CURRENT_SOURCE_DIR@/config_lipm.yaml"));
+    stabilizer->staticTarget(solver.robot().com());
+    // Each foot carries half of the robot weight
+    for(auto * robot : {&solver.robot(), &solver.realRobot()})
+    {
+      auto & data = *robot->data();
+      for(const auto & sensor : {"LeftFootForceSensor", "RightFootForceSensor"})
+      {
+        data.forceSensors[data.forceSensorsIndex.at(sensor)].wrench(
+            {Eigen::Vector3d::Zero(), {0, 0, 0.5 * robot->mass() * mc_rtc::constants::GRAVITY}});
+      }
+    }
+  }
+
+  void TearDown(const ::benchmark::State &) override { stabilizer.reset(); }
+
+  /** Run the stabilizer and report the allocations, \p before is called before each run */
+  template<typename BeforeT>
+  void run(benchmark::State & state, BeforeT && before)
+  {
+    // Reach a steady state
+    for(size_t i = 0; i < 10; ++i)
+    {
+      before();
+      stabilizer->run();
+    }
+    mc_rtc::AllocationTracker::reset();
+    for(auto _ : state)
+    {
+      before();
+      mc_rtc::AllocationTracker::start();
+      stabilizer->run();
+      mc_rtc::AllocationTracker::stop();
+    }
+    state.counters["allocs"] = benchmark::Counter(static_cast<double>(mc_rtc::AllocationTracker::allocations()),
+                                                  benchmark::Counter::kAvgIterations);
+  }
+
+  mc_solver::TasksQPSolver solver{0.005};
+  std::shared_ptr<StabilizerTask> stabilizer;
+};
+
+BENCHMARK_F(StabilizerFixture, DoubleSupport)(benchmark::State & state)
+{
+  run(state, []() {});
+}
+
+BENCHMARK_F(StabilizerFixture, SingleSupport)(benchmark::State & state)
+{
+  stabilizer->setContacts({ContactState::Left});
+  run(state, []() {});
+}
+
+BENCHMARK_DEFINE_F(StabilizerFixture, Horizon)(benchmark::State & state)
+{
+  std::vector<Eigen::Vector2d> zmpRef(static_cast<size_t>(state.range(0)), solver.robot().com().head<2>());
+  run(state, [&]() { stabilizer->horizonReference(zmpRef, 0.1); });
+}
+BENCHMARK_REGISTER_F(StabilizerFixture, Horizon)->Arg(4)->Arg(10)->Arg(20)->Arg(40);
+
+BENCHMARK_MAIN();
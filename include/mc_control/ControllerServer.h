@@ -58,9 +58,19 @@ struct MC_CONTROL_DLLAPI ControllerServer
   /** Handle requests from raw data */
   void handle_requests(mc_rtc::gui::StateBuilder & gui, const char * data);
 
-  /** Publish the current GUI state */
+  /** Publish the current GUI state, equivalent to update() followed by send() */
   void publish(mc_rtc::gui::StateBuilder & gui_builder);
 
+  /** Serialize the current GUI state if it should be published in this iteration
+   *
+   * The serialized state is sent by send() which does not access \p gui_builder
+   * so it can be called from another thread as long as update() is not called concurrently
+   */
+  void update(mc_rtc::gui::StateBuilder & gui_builder);
+
+  /** Send the state serialized by the last call to update(), does nothing if there is nothing to send */
+  void send();
+
   /** Get latest published data */
   std::pair<const char *, size_t> data() const;
 
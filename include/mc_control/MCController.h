@@ -12,6 +12,7 @@
 #include <mc_rbdyn/RobotConverter.h>
 #include <mc_rbdyn/Robots.h>
 
+#include <mc_rtc/ConcurrentDataStore.h>
 #include <mc_rtc/DataStore.h>
 #include <mc_rtc/gui.h>
 #include <mc_rtc/log/Logger.h>
@@ -351,6 +352,16 @@ public:
   /** Provides access to the shared datastore (const) */
   const mc_rtc::DataStore & datastore() const noexcept { return datastore_; }
 
+  /** Provides access to the datastore shared with threads outside of the control loop
+   *
+   * Use this to publish values from perception/planning threads without
+   * blocking the control thread, see \ref mc_rtc::ConcurrentDataStore
+   */
+  inline mc_rtc::ConcurrentDataStore & concurrentDatastore() noexcept { return concurrent_datastore_; }
+
+  /** Provides access to the concurrent datastore (const) */
+  inline const mc_rtc::ConcurrentDataStore & concurrentDatastore() const noexcept { return concurrent_datastore_; }
+
   /**
    * @name Accessors to the real robots
    * @{
@@ -649,6 +660,11 @@ protected:
   mc_rbdyn::RobotsPtr outputRealRobots_;
   /** Control to canonical converters */
   std::vector<mc_rbdyn::RobotConverter> converters_;
+  /** Lazy evaluation of the control and real robots' kinematics (LazyKinematics option)
+   *
+   * The output robots are always up-to-date since they are read directly by the interfaces
+   */
+  bool lazyKinematics_ = false;
 
   /** State observation pipelines for this controller */
   std::vector<mc_observers::ObserverPipeline> observerPipelines_;
@@ -665,6 +681,9 @@ protected:
    * framework (states...) */
   mc_rtc::DataStore datastore_;
 
+  /** Lock-free datastore to receive data from other threads */
+  mc_rtc::ConcurrentDataStore concurrent_datastore_;
+
   /** Holds dynamics, kinematics and contact constraints that are added
    * from the start by the controller */
   std::vector<mc_solver::ConstraintSetPtr> constraints_;
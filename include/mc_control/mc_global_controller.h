@@ -11,10 +11,15 @@
 
 #include <mc_rbdyn/RobotModule.h>
 
+#include <mc_rtc/LatencyHistogram.h>
 #include <mc_rtc/loader.h>
 #include <mc_rtc/log/Logger.h>
 
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace mc_control
 {
@@ -77,7 +82,11 @@ public:
   /*! \brief Destructor */
   ~MCGlobalController();
 
-  /*! \brief Returns a list of enabled controllers */
+  /*! \brief Returns a list of enabled controllers
+   *
+   * This includes controllers that are still being created in the background
+   * when GlobalConfiguration::lazy_controllers_creation is enabled
+   */
   std::vector<std::string> enabled_controllers() const;
 
   /*! \brief Returns a list of all the loaded controllers, whether they
@@ -633,6 +642,114 @@ public:
    * \throws If the specified robot does not exist
    */
   void setJointMotorStatuses(const std::string & robotName, const std::map<std::string, bool> & statuses);
+
+  /*! \brief Pre-resolved sensor layout used by the bulk sensor setters
+   *
+   * The interface creates a layout once with makeSensorLayout() and then
+   * provides sensor values every iteration as contiguous arrays ordered like
+   * the layout. Sensor indices are resolved when the layout is created and
+   * again when the active controller changes or when robots are loaded or
+   * removed (see mc_rbdyn::Robots::generation) so the bulk setters perform no
+   * allocation and no name lookup in the common case.
+   *
+   * The names must not be modified after the layout is created, create a new
+   * layout instead.
+   */
+  struct MC_CONTROL_DLLAPI SensorLayout
+  {
+    /** Robot the sensors belong to */
+    std::string robot;
+    /** Force sensors names, order expected by setWrenches(SensorLayout &, ...) */
+    std::vector<std::string> forceSensors;
+    /** Joints names, order expected by the joint sensors bulk setters */
+    std::vector<std::string> joints;
+    /** Body sensors names, order expected by setSensorOrientations(SensorLayout &, ...) */
+    std::vector<std::string> bodySensors;
+
+  private:
+    friend struct MCGlobalController;
+    /** Value of MCGlobalController::controller_generation_ when the indices were resolved */
+    uint64_t generation_ = 0;
+    /** Robots the indices were resolved with and their generation at that time */
+    const mc_rbdyn::Robots * robots_ = nullptr;
+    uint64_t robotsGeneration_ = 0;
+    unsigned int robotIndex_ = 0;
+    std::vector<size_t> forceSensorsIdx_;
+    std::vector<size_t> jointSensorsIdx_;
+    std::vector<size_t> bodySensorsIdx_;
+  };
+
+  /*! \brief Create a sensor layout for the bulk sensor setters
+   *
+   * \param robot Name of the robot the sensors belong to
+   * \param forceSensors Force sensors provided by setWrenches(SensorLayout &, ...)
+   * \param joints Joints whose sensors are provided by the joint sensors bulk setters
+   * \param bodySensors Body sensors provided by setSensorOrientations(SensorLayout &, ...)
+   * \throws If the robot or any of the sensors does not exist
+   */
+  SensorLayout makeSensorLayout(const std::string & robot,
+                                const std::vector<std::string> & forceSensors,
+                                const std::vector<std::string> & joints = {},
+                                const std::vector<std::string> & bodySensors = {});
+
+  /*! \brief Set force sensors' wrenches in the order given by layout.forceSensors
+   *
+   * \param wrenches Pointer to \p size contiguous wrenches
+   * \throws If size does not match the layout or the sensors no longer exist
+   */
+  void setWrenches(SensorLayout & layout, const sva::ForceVecd * wrenches, size_t size);
+
+  /*! \brief Set motor temperatures in the order given by layout.joints
+   *
+   * \param temperatures Pointer to \p size contiguous values
+   * \throws If size does not match the layout or the sensors no longer exist
+   */
+  void setJointMotorTemperatures(SensorLayout & layout, const double * temperatures, size_t size);
+
+  /*! \brief Set driver temperatures in the order given by layout.joints
+   *
+   * \param temperatures Pointer to \p size contiguous values
+   * \throws If size does not match the layout or the sensors no longer exist
+   */
+  void setJointDriverTemperatures(SensorLayout & layout, const double * temperatures, size_t size);
+
+  /*! \brief Set motor currents in the order given by layout.joints
+   *
+   * \param currents Pointer to \p size contiguous values
+   * \throws If size does not match the layout or the sensors no longer exist
+   */
+  void setJointMotorCurrents(SensorLayout & layout, const double * currents, size_t size);
+
+  /*! \brief Set body sensors' orientations in the order given by layout.bodySensors
+   *
+   * \param oris Pointer to \p size contiguous orientations
+   * \throws If size does not match the layout or the sensors no longer exist
+   */
+  void setSensorOrientations(SensorLayout & layout, const Eigen::Quaterniond * oris, size_t size);
+
+  /** Convenience overloads for std::vector inputs */
+  inline void setWrenches(SensorLayout & layout, const std::vector<sva::ForceVecd> & wrenches)
+  {
+    setWrenches(layout, wrenches.data(), wrenches.size());
+  }
+  inline void setJointMotorTemperatures(SensorLayout & layout, const std::vector<double> & temperatures)
+  {
+    setJointMotorTemperatures(layout, temperatures.data(), temperatures.size());
+  }
+  inline void setJointDriverTemperatures(SensorLayout & layout, const std::vector<double> & temperatures)
+  {
+    setJointDriverTemperatures(layout, temperatures.data(), temperatures.size());
+  }
+  inline void setJointMotorCurrents(SensorLayout & layout, const std::vector<double> & currents)
+  {
+    setJointMotorCurrents(layout, currents.data(), currents.size());
+  }
+  inline void setSensorOrientations(
+      SensorLayout & layout,
+      const std::vector<Eigen::Quaterniond, Eigen::aligned_allocator<Eigen::Quaterniond>> & oris)
+  {
+    setSensorOrientations(layout, oris.data(), oris.size());
+  }
   /** @} */
 
 protected:
@@ -673,12 +790,23 @@ public:
    */
   bool run();
 
+  /*! \brief Wait for the asynchronous post-run stage to complete
+   *
+   * When AsyncPostRun is enabled, the GUI state and log data of an iteration
+   * are serialized by run() and sent/written on a worker thread after run()
+   * returns. This waits for that work to complete, it is called automatically
+   * by every member that accesses the controller. It does nothing if the
+   * post-run stage is synchronous.
+   */
+  void waitPostRun() const noexcept;
+
   /*! \brief Access the server */
   ControllerServer & server();
 
   /*! \brief Access the current controller */
   inline MCController & controller() noexcept
   {
+    waitPostRun();
     assert(controller_ != nullptr);
     return *controller_;
   }
@@ -686,6 +814,7 @@ public:
   /*! \brief Const access to current controller */
   inline const MCController & controller() const noexcept
   {
+    waitPostRun();
     assert(controller_ != nullptr);
     return *controller_;
   }
@@ -772,6 +901,9 @@ public:
    * running then this call has no effect. Otherwise, it will trigger a
    * controller switch at the next run call.
    *
+   * If the controller is still being created in the background, the switch
+   * happens at the first run call after it is ready.
+   *
    * \param name Name of the new controller to load
    */
   bool EnableController(const std::string & name);
@@ -835,6 +967,85 @@ public:
    */
   void refreshLog();
 
+  /*! \brief Latency statistics of one phase of run() */
+  struct MC_CONTROL_DLLAPI PhaseLatency
+  {
+    /** Samples in the current window */
+    mc_rtc::LatencyHistogram window;
+    /** Samples of the last complete window */
+    mc_rtc::LatencyHistogram last_window;
+    /** All samples since the statistics were last reset */
+    mc_rtc::LatencyHistogram total;
+
+    inline void record(double ms) noexcept
+    {
+      window.record(ms);
+      total.record(ms);
+    }
+
+    /** p50, p99, p99.9 and max of the last complete window
+     *
+     * This is computed on the first call after a window completes
+     */
+    const std::array<double, 4> & lastWindowSummary() const noexcept;
+
+    /** Rotate the windows, the summary of the new last window is computed on demand */
+    void rollover() noexcept;
+
+  private:
+    mutable std::array<double, 4> last_window_summary_ = {0, 0, 0, 0};
+    mutable bool last_window_summary_valid_ = true;
+  };
+
+  /*! \brief Latency statistics of run()
+   *
+   * Phases are named after their log entry: GlobalRun, ObserversRun,
+   * ControllerRun, Conversion, Gui, Log, Plugins_[name]_before and
+   * Plugins_[name]_after
+   *
+   * The summary of the last complete window of each phase is also logged as
+   * perf_Latency_[phase]_{p50,p99,p999,max}
+   */
+  struct LatencyStats
+  {
+    /** Statistics for each phase */
+    std::map<std::string, PhaseLatency> phases;
+    /** Control deadline (ms), 0 if deadline tracking is disabled */
+    double deadline = 0;
+    /** Number of iterations in a rolling window */
+    uint64_t window_size = 1;
+    /** Number of iterations recorded */
+    uint64_t iterations = 0;
+    /** Number of iterations that exceeded the deadline */
+    uint64_t deadline_misses = 0;
+    /** Number of consecutive iterations that exceeded the deadline up to now */
+    uint64_t consecutive_misses = 0;
+    /** Longest sequence of consecutive iterations that exceeded the deadline */
+    uint64_t max_consecutive_misses = 0;
+    /** Largest overrun of the deadline (ms) */
+    double worst_overrun = 0;
+  };
+
+  /*! \brief Access the latency statistics of run() */
+  inline const LatencyStats & latencyStats() const noexcept { return latency_stats_; }
+
+  /*! \brief Reset the latency statistics of run() */
+  void resetLatencyStats() noexcept;
+
+  /*! \brief Print a summary of the latency statistics to the console */
+  void printLatencyStats() const;
+
+  /*! \brief Number of memory allocations during the last call to run()
+   *
+   * Always zero unless TrackAllocations is enabled and the allocator hooks are
+   * loaded, see mc_rtc::AllocationTracker for details. The allocations are
+   * charged to the same phases as the latency statistics. When AsyncPostRun
+   * is enabled, the GUI state and the log are still serialized (and tracked)
+   * in run(), only sending the GUI state and writing the log on the post-run
+   * thread are not tracked
+   */
+  inline uint64_t lastRunAllocations() const noexcept { return last_run_allocations_; }
+
 private:
   /** Initialize all robots */
   void init(const std::map<std::string, std::vector<double>> & initqs,
@@ -919,6 +1130,25 @@ public:
     std::string log_directory;
     std::string log_template = "mc-control";
 
+    /** If true, the GUI state and log data are sent/written on a worker thread after run() returns
+     *
+     * GUI requests are then handled at the start of run() and the data is still serialized by run()
+     */
+    bool async_post_run = false;
+
+    /** If true, enabled controllers are created concurrently */
+    bool parallel_controllers_creation = false;
+    /** If true, only the initial controller is created in the constructor, others are created in the background */
+    bool lazy_controllers_creation = false;
+
+    /** Control deadline (s) used for deadline miss accounting, defaults to timestep, 0 disables it */
+    double latency_deadline = -1;
+    /** Duration (s) of the rolling window used for latency statistics */
+    double latency_window = 1.0;
+
+    /** If true, track the memory allocations in run() with mc_rtc::AllocationTracker */
+    bool track_allocations = false;
+
     bool enable_gui_server = true;
     ControllerServerConfiguration gui_server_configuration;
 
@@ -963,6 +1193,9 @@ private:
   {
     GlobalPlugin * plugin;
     duration_ms plugin_before_dt;
+    PhaseLatency * latency;
+    /** Phase name, owned by latency_stats_ */
+    const char * phase;
   };
   std::vector<PluginBefore> plugins_before_;
   std::vector<GlobalPlugin *> plugins_before_always_;
@@ -970,6 +1203,9 @@ private:
   {
     GlobalPlugin * plugin;
     duration_ms plugin_after_dt;
+    PhaseLatency * latency;
+    /** Phase name, owned by latency_stats_ */
+    const char * phase;
   };
   std::vector<PluginAfter> plugins_after_;
   std::vector<GlobalPlugin *> plugins_after_always_;
@@ -978,6 +1214,26 @@ private:
 
   void start_log();
   void setup_log();
+  /** Handle GUI requests, used at the start of run() when AsyncPostRun is enabled */
+  void handleGUIRequests();
+  /** Handle GUI requests and publish the GUI state
+   *
+   * If \p deferSend is true the requests are not handled and the state is only serialized, it is sent by the post-run
+   * worker
+   */
+  void publishGUI(bool deferSend);
+  /** Log the current iteration
+   *
+   * If \p deferWrite is true the data is only serialized, it is written by the post-run worker
+   */
+  void logRun(bool deferWrite);
+  /** Resolve the sensor indices of a layout for the current controller and robots if needed
+   *
+   * \returns The data of the robot the layout refers to
+   */
+  mc_rbdyn::RobotData & resolveSensorLayout(SensorLayout & layout);
+  /** Incremented every time the active controller changes or is reset, starts at 1 */
+  uint64_t controller_generation_ = 1;
   void setup_plugin_log();
   std::map<std::string, bool> setup_logger_;
 
@@ -985,12 +1241,79 @@ private:
   duration_ms global_run_dt{0};
   duration_ms controller_run_dt{0};
   duration_ms observers_run_dt{0};
+  duration_ms conversion_dt{0};
   duration_ms log_dt{0};
   duration_ms gui_dt{0};
   double solver_build_and_solve_t = 0;
   double solver_solve_t = 0;
   double framework_cost = 0;
 
+  /** Latency statistics */
+  LatencyStats latency_stats_;
+  PhaseLatency * global_run_latency_;
+  PhaseLatency * controller_run_latency_;
+  PhaseLatency * observers_run_latency_;
+  PhaseLatency * conversion_latency_;
+  PhaseLatency * gui_latency_;
+  PhaseLatency * log_latency_;
+  uint64_t latency_window_iter_ = 0;
+  /** True when the latency windows must be rotated, this is done at the start of run() so that it is measured */
+  bool latency_rollover_ = false;
+  /** Record the timings of the last iteration in latency_stats_ */
+  void recordLatency() noexcept;
+  /** Log the summary of the last complete window of a latency phase */
+  void addLatencyLogEntries(const std::string & phase, const PhaseLatency & latency, bool overwrite);
+  /** Allocations during the last run() */
+  uint64_t last_run_allocations_ = 0;
+  /** Reset/report requests from the GUI, handled by run() once the tracking is stopped */
+  std::atomic<bool> reset_allocations_requested_{false};
+  std::atomic<bool> print_allocations_requested_{false};
+  /** Handle the allocation tracker requests, called between two iterations */
+  void handleAllocationsRequests();
+
+  /** Asynchronous post-run stage */
+  std::thread post_run_thread_;
+  mutable std::mutex post_run_mutex_;
+  mutable std::condition_variable post_run_cv_;
+  /** True from the moment the post-run stage is requested until it completes */
+  std::atomic<bool> post_run_pending_{false};
+  bool post_run_requested_ = false;
+  bool post_run_stop_ = false;
+  /** Request the worker to run the post-run stage */
+  void startPostRun();
+  /** Worker loop */
+  void postRunLoop();
+
+  /** Create a controller and prepare it to be added to the enabled controllers
+   *
+   * This does not modify the global controller state so it can be called from
+   * multiple threads at once
+   *
+   * \returns nullptr if the controller is not available
+   */
+  std::shared_ptr<MCController> createController(const std::string & name,
+                                                 const mc_rtc::Configuration & ctl_config);
+  /** Create the provided controllers, concurrently if parallel_controllers_creation is true
+   *
+   * \throws If any of the controllers throws during its creation, the first exception is re-thrown once all
+   * creations are done
+   */
+  std::vector<std::shared_ptr<MCController>> createControllers(
+      const std::vector<std::pair<std::string, mc_rtc::Configuration>> & ctls);
+
+  /** Lazy creation of the controllers */
+  std::thread lazy_controllers_thread_;
+  std::mutex lazy_controllers_mutex_;
+  /** Controllers created by the background thread that have not been added yet, nullptr if the creation failed */
+  std::vector<std::pair<std::string, std::shared_ptr<MCController>>> lazy_controllers_ready_;
+  std::atomic<bool> lazy_controllers_has_ready_{false};
+  /** Controllers that are still being created (only accessed from the control thread) */
+  std::vector<std::string> lazy_controllers_pending_;
+  /** Add the controllers created in the background, switch to the next controller if it became ready */
+  void adoptLazyControllers();
+  /** Wait for the background creation to finish and add all the controllers */
+  void waitLazyControllers();
+
   /** Reset controller-specific plugins
    *
    * When switching controllers, plugins that are enabled in both controllers are reset, new plugins are init
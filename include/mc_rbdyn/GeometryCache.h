@@ -0,0 +1,52 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#pragma once
+
+#include <mc_rbdyn/Surface.h>
+#include <mc_rbdyn/api.h>
+
+#include <sch/S_Polyhedron/S_Polyhedron.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mc_rbdyn
+{
+
+/**
+ * @brief Process-wide cache of the geometry loaded from files by mc_rbdyn::Robot
+ *
+ * Convex files and RSDF directories are parsed once and the parsed result is
+ * kept in memory. Subsequent requests for the same file return a copy of the
+ * parsed object so that every robot keeps its own transformation. Entries are
+ * invalidated when the file modification time or size changes.
+ *
+ * All functions are thread-safe.
+ */
+struct MC_RBDYN_DLLAPI GeometryCache
+{
+  /** Returns a new polyhedron loaded from \p path
+   *
+   * This is equivalent to sch::mc_rbdyn::Polyhedron(path) but the file is only
+   * parsed the first time
+   */
+  static std::shared_ptr<sch::S_Polyhedron> polyhedron(const std::string & path);
+
+  /** Returns new surfaces loaded from the RSDF files in \p dirname
+   *
+   * This is equivalent to readRSDFFromDir(dirname) but the files are only
+   * parsed the first time
+   */
+  static std::vector<SurfacePtr> rsdf(const std::string & dirname);
+
+  /** Number of entries in the cache */
+  static size_t size() noexcept;
+
+  /** Release every entry in the cache, copies returned previously are not affected */
+  static void clear() noexcept;
+};
+
+} // namespace mc_rbdyn
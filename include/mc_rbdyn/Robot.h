@@ -17,6 +17,7 @@
 #include <RBDyn/MultiBodyConfig.h>
 #include <RBDyn/MultiBodyGraph.h>
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <unordered_map>
@@ -1022,6 +1023,70 @@ public:
   void forwardAcceleration(rbd::MultiBodyConfig & mbc,
                            const sva::MotionVecd & A_0 = sva::MotionVecd(Eigen::Vector6d::Zero())) const;
 
+  /** Highest order computed by forwardAll() */
+  enum class ForwardOrder
+  {
+    /** Forward kinematics */
+    Kinematics,
+    /** Forward kinematics and velocity */
+    Velocity,
+    /** Forward kinematics, velocity and acceleration */
+    Acceleration
+  };
+
+  /** Apply forward kinematics, velocity and acceleration (up to \p order) to the robot
+   *
+   * This is equivalent to calling forwardKinematics(), forwardVelocity() and
+   * forwardAcceleration() in sequence but goes through the robot's joints
+   * only once
+   */
+  void forwardAll(ForwardOrder order = ForwardOrder::Acceleration,
+                  const sva::MotionVecd & A_0 = sva::MotionVecd(Eigen::Vector6d::Zero()));
+  /** Apply forward kinematics, velocity and acceleration (up to \p order) to \p mbc using the robot's mb() */
+  void forwardAll(rbd::MultiBodyConfig & mbc,
+                  ForwardOrder order = ForwardOrder::Acceleration,
+                  const sva::MotionVecd & A_0 = sva::MotionVecd(Eigen::Vector6d::Zero())) const;
+
+  /** Enable or disable the lazy evaluation of the robot's kinematics (disabled by default)
+   *
+   * In lazy mode, forwardKinematics(), forwardVelocity(), forwardAcceleration()
+   * and forwardAll() only mark the corresponding quantities as outdated. They
+   * are computed (with the state at that time) when they are accessed through
+   * the robot: bodyPosW(), bodyVelW(), bodyVelB(), bodyAccB(), posW(), velW(),
+   * accW(), com(), comVelocity(), comAcceleration(), convex(), convexes() and
+   * the frames' position() and velocity(). Accessing a single body only
+   * computes the kinematic chain from the root to this body.
+   *
+   * Reading the kinematics through mbc() does not trigger the computation,
+   * call updateKinematics() before handing the robot's mbc() to code that
+   * reads it directly (e.g. Tasks or RBDyn algorithms). The solver, the
+   * observer pipelines and the output robots conversion already do so.
+   *
+   * Since const accessors may update the robot, a lazy robot must not be read
+   * from multiple threads: the kinematics must be up-to-date before entering a
+   * parallel section (e.g. a mc_rtc::WorkerPool job), this is asserted in
+   * debug builds.
+   *
+   * Disabling the lazy mode computes the outdated quantities.
+   */
+  void lazyKinematics(bool lazy);
+
+  /** True if the kinematics are lazily evaluated */
+  inline bool lazyKinematics() const noexcept { return lazyKinematics_; }
+
+  /** In lazy mode, compute the outdated kinematics (up to \p order) of every body, no effect otherwise */
+  inline void updateKinematics(ForwardOrder order = ForwardOrder::Acceleration) const
+  {
+    if(lazyKinematics_) { updateLazyKinematics(order); }
+  }
+
+  /** In lazy mode, compute the outdated kinematics (up to \p order) from the root to body \p bodyIdx, no effect
+   * otherwise */
+  inline void updateKinematics(unsigned int bodyIdx, ForwardOrder order) const
+  {
+    if(lazyKinematics_) { updateLazyKinematics(bodyIdx, order); }
+  }
+
   /** Apply Euler integration to the robot using \p step timestep */
   void eulerIntegration(double step);
   /** Apply Euler integration to \p mbc using the robot's mb() and \p step timestep */
@@ -1220,6 +1285,25 @@ private:
    */
   void name(const std::string & n);
 
+  /** Update the convexes' transformations from \p mbc body positions */
+  void updateConvexes(const rbd::MultiBodyConfig & mbc) const;
+
+  /** Lazy evaluation of the kinematics, see lazyKinematics(bool) */
+  bool lazyKinematics_ = false;
+  /** For each body, bitmask of the up-to-date quantities (in lazy mode) */
+  mutable std::vector<uint8_t> kinematicsValid_;
+  /** True if the convexes' transformations are up-to-date (in lazy mode) */
+  mutable bool convexesValid_ = true;
+  /** Base acceleration of the last forward acceleration (in lazy mode) */
+  sva::MotionVecd lazyA_0_ = sva::MotionVecd(Eigen::Vector6d::Zero());
+
+  /** Mark quantities (bitmask) outdated for every body */
+  void invalidateKinematics(uint8_t mask);
+
+  void updateLazyKinematics(ForwardOrder order) const;
+  void updateLazyKinematics(unsigned int bodyIdx, ForwardOrder order) const;
+  void updateLazyConvexes() const;
+
   /** Parameters passed at creation time */
   LoadRobotParameters load_params_;
 };
@@ -84,7 +84,7 @@ public:
       if(rm->_canonicalParameters.empty()) { rm->_canonicalParameters = rm->_parameters; }
       if(!rm->controlToCanonicalPostProcess)
       {
-        rm->controlToCanonicalPostProcess = [](const mc_rbdyn::Robot &, mc_rbdyn::Robot &) {};
+        rm->controlToCanonicalPostProcess = mc_rbdyn::RobotModule::DefaultControlToCanonicalPostProcess{};
       }
     };
     if(aliases.count(name))
@@ -164,6 +164,27 @@ public:
    */
   static void load_aliases(const std::string & fname);
 
+  /** Enable RobotModule bundles
+   *
+   * When enabled, modules created from a library are saved as binary bundles
+   * (see RobotModuleBundle) and subsequent requests for the same module (in
+   * this process or another) load the bundle instead of running the module
+   * constructor as long as the library, the URDF or any parameter that names
+   * an existing file are unchanged.
+   *
+   * Bundles only contain data: modules that provide devices or a custom
+   * RobotModule::controlToCanonicalPostProcess are never bundled.
+   *
+   * \param directory Where bundles are stored, defaults to a directory in the OS temporary directory
+   */
+  static void enable_bundles(const std::string & directory = "");
+
+  /** Disable RobotModule bundles, existing bundles are kept on disk */
+  static void disable_bundles();
+
+  /** Returns the directory where bundles are stored, empty if bundles are disabled */
+  static std::string bundles_directory();
+
 private:
   static void init(bool skip_default_path = false);
 
@@ -188,15 +209,43 @@ private:
       for(const auto & r : available_robots()) { mc_rtc::log::info("- {}", r); }
       mc_rtc::log::error_and_throw<mc_rtc::LoaderException>("Cannot load the requested robot: {}", name);
     }
-    mc_rbdyn::RobotModulePtr rm = robot_loader->create_object(name, args...);
-    if(!rm) { mc_rtc::log::error_and_throw("Failed to load {}", name); }
+    std::vector<std::string> params = {name, args...};
+    std::string bundle_path;
+    mc_rbdyn::RobotModulePtr rm = load_bundle(params, bundle_path);
+    if(!rm)
+    {
+      rm = robot_loader->create_object(name, args...);
+      if(!rm) { mc_rtc::log::error_and_throw("Failed to load {}", name); }
+      // A custom post-processing callback cannot be stored in a bundle
+      if(bundle_path.size() && rm->hasDefaultControlToCanonicalPostProcess()) { save_bundle(*rm, params, bundle_path); }
+    }
+    load_self_collision_filter(*rm);
     rm->_parameters = {name};
     fill_rm_parameters(rm, args...);
     return rm;
   }
 
+  /** Load the bundle corresponding to the provided parameters
+   *
+   * \param bundle_path Set to the bundle location if bundles are enabled for this module, empty otherwise
+   *
+   * \returns nullptr if the bundle is not available
+   */
+  static mc_rbdyn::RobotModulePtr load_bundle(const std::vector<std::string> & params, std::string & bundle_path);
+
+  static void save_bundle(const mc_rbdyn::RobotModule & rm,
+                          const std::vector<std::string> & params,
+                          const std::string & bundle_path);
+
+  /** Load the self-collision filter stored alongside the module (if any)
+   *
+   * \see SelfCollisionFilter::defaultPath
+   */
+  static void load_self_collision_filter(mc_rbdyn::RobotModule & rm);
+
   static std::unique_ptr<mc_rtc::ObjectLoader<mc_rbdyn::RobotModule>> robot_loader;
   static bool verbose_;
+  static std::string bundles_dir_;
   static std::mutex mtx;
   static std::map<std::string, std::vector<std::string>> aliases;
 }; // namespace mc_rbdyn
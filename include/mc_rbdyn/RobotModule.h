@@ -14,6 +14,7 @@
 #include <mc_rbdyn/RobotConverterConfig.h>
 #include <mc_rbdyn/Springs.h>
 #include <mc_rbdyn/api.h>
+#include <mc_rbdyn/fwd.h>
 #include <mc_rbdyn/lipm_stabilizer/StabilizerConfiguration.h>
 
 #include <mc_rtc/constants.h>
@@ -523,6 +524,12 @@ struct MC_RBDYN_DLLAPI RobotModule
    */
   RobotConverterConfig controlToCanonicalConfig;
 
+  /** Default implementation of controlToCanonicalPostProcess, does nothing */
+  struct MC_RBDYN_DLLAPI DefaultControlToCanonicalPostProcess
+  {
+    void operator()(const mc_rbdyn::Robot &, mc_rbdyn::Robot &) const noexcept {}
+  };
+
   /* Post-processing for control to canonical
    *
    * The default implementation does nothing
@@ -532,7 +539,13 @@ struct MC_RBDYN_DLLAPI RobotModule
    * It is called last, after the controller/observer/grippers have run and before the plugins/log/GUI
    */
   std::function<void(const mc_rbdyn::Robot & control, mc_rbdyn::Robot & canonical)> controlToCanonicalPostProcess =
-      [](const mc_rbdyn::Robot &, mc_rbdyn::Robot &) {};
+      DefaultControlToCanonicalPostProcess{};
+
+  /** True if controlToCanonicalPostProcess is the default implementation */
+  inline bool hasDefaultControlToCanonicalPostProcess() const noexcept
+  {
+    return controlToCanonicalPostProcess.target<DefaultControlToCanonicalPostProcess>() != nullptr;
+  }
 
   /** Returns the path to a "real" URDF file
    *
@@ -549,6 +562,12 @@ struct MC_RBDYN_DLLAPI RobotModule
   /** Returns a list of robot frames supported by this module */
   inline const std::vector<FrameDescription> & frames() const noexcept { return _frames; }
 
+  /** Returns the self-collision filter of this module, nullptr if the module has none
+   *
+   * \see SelfCollisionFilter
+   */
+  inline const SelfCollisionFilter * selfCollisionFilter() const noexcept { return _selfCollisionFilter.get(); }
+
 public:
   /** Path to the robot's description package */
   std::string path;
@@ -602,6 +621,8 @@ public:
   std::vector<mc_rbdyn::Collision> _minimalSelfCollisions;
   /** \see commonSelfCollisions() */
   std::vector<mc_rbdyn::Collision> _commonSelfCollisions;
+  /** \see selfCollisionFilter() */
+  std::shared_ptr<const SelfCollisionFilter> _selfCollisionFilter;
   /** \see grippers() */
   std::vector<Gripper> _grippers;
   /** \see gripperSafety() */
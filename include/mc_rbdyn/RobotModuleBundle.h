@@ -0,0 +1,56 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#pragma once
+
+#include <mc_rbdyn/RobotModule.h>
+
+#include <string>
+#include <vector>
+
+namespace mc_rbdyn
+{
+
+/**
+ * @brief Binary snapshot of a fully resolved RobotModule
+ *
+ * A bundle stores everything that is needed to re-create a RobotModule
+ * without parsing its URDF: the MultiBody/MultiBodyConfig/MultiBodyGraph,
+ * bounds, visuals and collisions, convex and RSDF locations, sensors,
+ * frames, grippers... It re-uses the RobotModule configuration
+ * serialization (see configuration_io.h) stored as MessagePack.
+ *
+ * A bundle records the modification time and size of the files it was
+ * generated from (the URDF and any additional source provided) and is
+ * considered outdated if any of them changed.
+ *
+ * Some RobotModule data cannot be stored: modules providing devices or a
+ * custom RobotModule::controlToCanonicalPostProcess cannot be saved.
+ */
+struct MC_RBDYN_DLLAPI RobotModuleBundle
+{
+  /** Save a RobotModule into a bundle
+   *
+   * The bundle is written to a temporary file first and moved into place so
+   * that concurrent readers never see a partial bundle.
+   *
+   * \param rm Module to save
+   *
+   * \param path Where to save the bundle
+   *
+   * \param sources Additional files that invalidate the bundle when they are modified
+   *
+   * \returns False if the module cannot be stored or the bundle cannot be written
+   */
+  static bool save(const RobotModule & rm, const std::string & path, const std::vector<std::string> & sources = {});
+
+  /** Load a RobotModule from a bundle
+   *
+   * \returns nullptr if the bundle does not exist, is invalid, was produced by
+   * another version of mc_rtc or if any of its sources changed
+   */
+  static RobotModulePtr load(const std::string & path);
+};
+
+} // namespace mc_rbdyn
@@ -44,6 +44,12 @@ public:
   /** Give access to the underlying list of rbd::MultiBodyConfig objects (const) */
   const std::vector<rbd::MultiBodyConfig> & mbcs() const;
 
+  /** Compute the outdated kinematics of the robots in lazy mode before their mbc() are read directly
+   *
+   * \see Robot::lazyKinematics
+   */
+  void updateKinematics() const;
+
   /** True if the given robot is part of this intance */
   bool hasRobot(const std::string & name) const;
 
@@ -122,6 +128,13 @@ public:
 
   void removeRobot(unsigned int idx);
 
+  /** Incremented every time a robot is loaded, copied or removed
+   *
+   * Data computed from the list of robots can compare this with the value it
+   * was computed with to know when it must be re-computed.
+   */
+  inline uint64_t generation() const noexcept { return generation_; }
+
   /** @} */
   /* End of Robot(s) loading/unloading functions group */
 
@@ -247,13 +260,16 @@ protected:
   Robots(Robots && robots) = delete;
   Robots & operator=(Robots && robots) = delete;
 
-  RobotModuleVector robot_modules_;
+  /** Modules are immutable and shared between copies of a robot */
+  std::vector<std::shared_ptr<const RobotModule>> robot_modules_;
   std::vector<RobotPtr> robots_;
   std::vector<rbd::MultiBody> mbs_;
   std::vector<rbd::MultiBodyConfig> mbcs_;
-  std::vector<rbd::MultiBodyGraph> mbgs_;
+  /** Graphs are shared between copies of a robot until they are accessed through the non-const Robot::mbg() */
+  std::vector<std::shared_ptr<rbd::MultiBodyGraph>> mbgs_;
   unsigned int robotIndex_;
   unsigned int envIndex_;
+  uint64_t generation_ = 0;
   void updateIndexes();
   std::unordered_map<std::string, unsigned int> robotNameToIndex_; ///< Correspondance between robot name and index
 };
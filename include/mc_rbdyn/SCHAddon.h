@@ -44,6 +44,21 @@ MC_RBDYN_DLLAPI S_Polyhedron * Polyhedron(const std::string & filename);
 
 MC_RBDYN_DLLAPI double distance(CD_Pair & pair, Eigen::Vector3d & p1, Eigen::Vector3d & p2);
 
+/** Compute a sphere that encloses an object
+ *
+ * \param obj Object
+ *
+ * \param X_0_obj Transformation currently applied to the object
+ *
+ * \param center Center of the sphere expressed in the object frame
+ *
+ * \param radius Radius of the sphere
+ */
+MC_RBDYN_DLLAPI void boundingSphere(const S_Object & obj,
+                                    const sva::PTransformd & X_0_obj,
+                                    Eigen::Vector3d & center,
+                                    double & radius);
+
 } // namespace mc_rbdyn
 
 } // namespace sch
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#pragma once
+
+#include <mc_rbdyn/api.h>
+#include <mc_rbdyn/fwd.h>
+
+#include <map>
+#include <string>
+#include <utility>
+
+namespace mc_rbdyn
+{
+
+/**
+ * @brief Self-collision pairs that can be safely ignored for a given robot
+ *
+ * Pairs are excluded for one of two reasons:
+ * - Adjacent: both convexes are attached to the same body or to bodies
+ *   directly connected by a joint, the collision cannot be avoided
+ * - Far: the convexes never came closer than a given distance while
+ *   sampling the configuration space within the joint limits
+ *
+ * The filter is computed offline (see the mc_self_collision_filter tool) and
+ * stored in defaultPath(), it is then loaded by mc_rbdyn::RobotLoader and
+ * used by mc_solver::CollisionsConstraint to skip the excluded pairs when
+ * expanding wildcard collisions (Far pairs are only skipped when their
+ * minimum distance is beyond the interaction distance of the collision).
+ */
+struct MC_RBDYN_DLLAPI SelfCollisionFilter
+{
+  /** Reason for the exclusion of a pair */
+  enum class Reason
+  {
+    Adjacent,
+    Far
+  };
+
+  /** Excluded pair */
+  struct Exclusion
+  {
+    Reason reason;
+    /** Minimum distance observed while sampling */
+    double minDistance;
+  };
+
+  /** Sampling options */
+  struct Options
+  {
+    /** Number of configurations sampled */
+    size_t samples = 10000;
+    /** Pairs that never come closer than this distance are excluded */
+    double distance = 0.1;
+    /** Seed of the random generator */
+    unsigned int seed = 0;
+    /** Number of threads used to compute distances, 0 uses all hardware threads */
+    size_t threads = 0;
+  };
+
+  /** Sample the configuration space of a robot to compute its filter
+   *
+   * Joint values are sampled uniformly within the module bounds (continuous
+   * joints are sampled in [-pi, pi]) and mimic joints follow the joint they
+   * mimic. The floating base (if any) does not affect self-collisions and is
+   * not sampled.
+   */
+  static SelfCollisionFilter compute(const RobotModule & rm, const Options & options);
+
+  /** Location of the filter associated to a module: path/collision_filter/name.yaml */
+  static std::string defaultPath(const RobotModule & rm);
+
+  /** Load a filter from a file
+   *
+   * \throws mc_rtc::Configuration::Exception if the file is not a valid filter
+   */
+  static SelfCollisionFilter load(const std::string & path);
+
+  /** Save the filter to a file */
+  void save(const std::string & path) const;
+
+  /** Exclude a pair, the order of the convexes does not matter */
+  void exclude(const std::string & c1, const std::string & c2, Reason reason, double minDistance);
+
+  /** True if the pair is excluded, the order of the convexes does not matter */
+  bool excluded(const std::string & c1, const std::string & c2) const;
+
+  /** Returns the exclusion of a pair, nullptr if the pair is not excluded, the order of the convexes does not matter */
+  const Exclusion * exclusion(const std::string & c1, const std::string & c2) const;
+
+  /** Access the excluded pairs, each pair is stored with the convexes in lexicographic order */
+  inline const std::map<std::pair<std::string, std::string>, Exclusion> & exclusions() const noexcept
+  {
+    return exclusions_;
+  }
+
+  /** Options used to compute the filter */
+  inline const Options & options() const noexcept { return options_; }
+
+private:
+  Options options_;
+  std::map<std::pair<std::string, std::string>, Exclusion> exclusions_;
+};
+
+} // namespace mc_rbdyn
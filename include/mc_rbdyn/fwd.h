@@ -30,4 +30,8 @@ using ConstFramePtr = std::shared_ptr<const Frame>;
 
 struct ForceSensor;
 
+struct RobotModule;
+
+struct SelfCollisionFilter;
+
 } // namespace mc_rbdyn
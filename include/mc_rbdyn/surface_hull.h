@@ -15,12 +15,14 @@ MC_RTC_diagnostic_pop
 
 #include <SpaceVecAlg/SpaceVecAlg>
 
+#include <memory>
 #include <vector>
 
 namespace sch
 {
 class S_Object;
-}
+class S_Polyhedron;
+} // namespace sch
 
 namespace mc_rbdyn
 {
@@ -30,10 +32,53 @@ struct PlanarSurface;
 struct CylindricalSurface;
 struct GripperSurface;
 
+/** Returns a new convex hull of the surface (or nullptr if the surface type is not supported)
+ *
+ * The hull is obtained from the cache maintained by surface_hull(), the
+ * returned object is a copy owned by the caller.
+ */
 MC_RBDYN_DLLAPI sch::S_Object * surface_to_sch(const mc_rbdyn::Surface & surface,
                                                const double & depth = 0.01,
                                                const unsigned int & slice = 8);
 
+/** Returns the convex hull of the surface (or nullptr if the surface type is not supported)
+ *
+ * Hulls are memoized in a process-wide LRU cache keyed on the surface type,
+ * body, name and points as well as \p depth and \p slice. Subsequent calls
+ * for an identical surface return the same object without running qhull.
+ *
+ * The returned object is shared, copy it if you need to transform it.
+ *
+ * This function is thread-safe.
+ */
+MC_RBDYN_DLLAPI std::shared_ptr<const sch::S_Polyhedron> surface_hull(const mc_rbdyn::Surface & surface,
+                                                                      double depth = 0.01,
+                                                                      unsigned int slice = 8);
+
+/** Compute the hulls of multiple surfaces in parallel
+ *
+ * \param threads Number of threads used to compute the hulls, 0 uses all hardware threads
+ *
+ * \returns The hull of each surface as returned by surface_hull()
+ */
+MC_RBDYN_DLLAPI std::vector<std::shared_ptr<const sch::S_Polyhedron>> surface_hulls(
+    const std::vector<const mc_rbdyn::Surface *> & surfaces,
+    double depth = 0.01,
+    unsigned int slice = 8,
+    size_t threads = 0);
+
+/** Number of hulls in the cache */
+MC_RBDYN_DLLAPI size_t surface_hull_cache_size() noexcept;
+
+/** Maximum number of hulls in the cache (256 by default) */
+MC_RBDYN_DLLAPI size_t surface_hull_cache_capacity() noexcept;
+
+/** Change the maximum number of hulls in the cache, the least recently used hulls are evicted first */
+MC_RBDYN_DLLAPI void surface_hull_cache_capacity(size_t capacity) noexcept;
+
+/** Release every hull in the cache, hulls returned previously are not affected */
+MC_RBDYN_DLLAPI void surface_hull_cache_clear() noexcept;
+
 MC_RBDYN_DLLAPI sch::S_Object * sch_polyhedron(const std::vector<sva::PTransformd> & points);
 
 MC_RBDYN_DLLAPI sch::S_Object * planar_hull(const mc_rbdyn::PlanarSurface & surface, const double & depth);
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#pragma once
+
+#include <mc_rtc/utils_api.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace mc_rtc
+{
+
+/**
+ * @brief Detect memory allocations in real-time code
+ *
+ * While tracking is active, every allocation made by the tracking thread is
+ * counted against the current phase (see Phase) and the allocation site is
+ * recorded with its backtrace. Recording does not allocate: sites are kept in a
+ * fixed-size buffer and their backtraces are only symbolized by report().
+ *
+ * Allocations are only seen if the allocator hooks are loaded in the process,
+ * i.e. the program is linked with the mc_rtc_allocation_hooks library or the
+ * library is preloaded (LD_PRELOAD). The hooks are only available with glibc,
+ * otherwise hooksLoaded() is false and nothing is ever recorded.
+ *
+ * Apart from hooksLoaded() and tracking(), the functions of this class must be
+ * called from the tracking thread or while tracking is stopped.
+ */
+struct MC_RTC_UTILS_DLLAPI AllocationTracker
+{
+  /** Maximum number of distinct allocation sites recorded, further sites are only counted */
+  static constexpr size_t MAX_SITES = 256;
+  /** Maximum depth of a recorded backtrace */
+  static constexpr size_t MAX_FRAMES = 32;
+  /** Maximum number of distinct phases, allocations in further phases are charged to the last one */
+  static constexpr size_t MAX_PHASES = 64;
+
+  /** An allocation site recorded by the tracker */
+  struct Site
+  {
+    /** Phase that was active when the site was first seen */
+    std::string phase;
+    /** Number of allocations from this site */
+    uint64_t count = 0;
+    /** Size (bytes) of the last allocation from this site */
+    size_t size = 0;
+    /** Backtrace of the site, innermost frame first (empty if not symbolized) */
+    std::vector<std::string> backtrace;
+  };
+
+  /** Summary of the allocations since the tracker was last reset */
+  struct MC_RTC_UTILS_DLLAPI Report
+  {
+    /** Number of allocations */
+    uint64_t allocations = 0;
+    /** Total size of the allocations (bytes) */
+    uint64_t bytes = 0;
+    /** Number of allocations in each phase */
+    std::map<std::string, uint64_t> phases;
+    /** Allocation sites sorted by decreasing number of allocations */
+    std::vector<Site> sites;
+
+    /** Human-readable version of the report */
+    std::string to_string() const;
+  };
+
+  /** True if the allocator hooks are loaded in this process */
+  static bool hooksLoaded() noexcept;
+
+  /** Start tracking the allocations of the calling thread, previous data is kept (see reset()) */
+  static void start() noexcept;
+
+  /** Stop tracking, the data is kept */
+  static void stop() noexcept;
+
+  /** True while tracking */
+  static bool tracking() noexcept;
+
+  /** Clear the recorded data */
+  static void reset() noexcept;
+
+  /** Number of allocations since the last reset() */
+  static uint64_t allocations() noexcept;
+
+  /** Report the allocations since the last reset()
+   *
+   * \param symbolize If true, symbolize the backtrace of each site (slow)
+   */
+  static Report report(bool symbolize = true);
+
+  /** Throw if more than \p maxAllocations allocations happened since the last reset()
+   *
+   * The exception message contains the report, this is intended for tests and CI
+   */
+  static void check(uint64_t maxAllocations = 0);
+
+  /** Charge the allocations to \p name in this scope, the previous phase is restored on destruction
+   *
+   * This has no effect outside of the tracking thread, \p name must remain valid until the next reset()
+   */
+  struct MC_RTC_UTILS_DLLAPI Phase
+  {
+    explicit Phase(const char * name) noexcept;
+    ~Phase() noexcept;
+    Phase(const Phase &) = delete;
+    Phase & operator=(const Phase &) = delete;
+
+  private:
+    const char * previous_;
+  };
+
+  /** Ignore the allocations of the tracking thread in this scope, e.g. for instrumentation code */
+  struct MC_RTC_UTILS_DLLAPI Pause
+  {
+    Pause() noexcept;
+    ~Pause() noexcept;
+    Pause(const Pause &) = delete;
+    Pause & operator=(const Pause &) = delete;
+
+  private:
+    bool active_;
+  };
+
+  /** Called by the allocator hooks for every allocation */
+  static void onAllocation(size_t size) noexcept;
+
+  /** Called by the allocator hooks when they are loaded */
+  static void onHooksLoaded() noexcept;
+};
+
+} // namespace mc_rtc
@@ -0,0 +1,293 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#pragma once
+
+#include <mc_rtc/logging.h>
+#include <mc_rtc/type_name.h>
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace mc_rtc
+{
+
+namespace internal
+{
+
+/** True if T can be published through a ConcurrentSlot
+ *
+ * Values are copied byte-wise so T must be trivially copyable or a
+ * fixed-size Eigen object (whose storage is a plain array). Specialize this
+ * trait for other types with plain storage (e.g. sva::PTransformd)
+ */
+template<typename T, typename = void>
+struct is_concurrent_slot_compatible : public std::is_trivially_copyable<T>
+{
+};
+
+template<typename T>
+struct is_concurrent_slot_compatible<
+    T,
+    typename std::enable_if<std::is_base_of<Eigen::PlainObjectBase<T>, T>::value>::type>
+: public std::integral_constant<bool, T::SizeAtCompileTime != Eigen::Dynamic>
+{
+};
+
+} // namespace internal
+
+/**
+ * @brief Lock-free single-writer/multi-readers slot
+ *
+ * This implements a sequence lock: the writer never blocks and readers always
+ * get the latest consistent value written into the slot. Readers retry their
+ * copy if a write happened concurrently, they never wait on a mutex so it is
+ * safe to read the value from the real-time thread.
+ *
+ * Only one thread may call write() on a given slot.
+ *
+ * \code{cpp}
+ * // Perception thread
+ * slot.write(target);
+ * // Control thread
+ * Eigen::Vector3d target = slot.read();
+ * \endcode
+ */
+template<typename T>
+struct ConcurrentSlot
+{
+  static_assert(internal::is_concurrent_slot_compatible<T>::value,
+                "ConcurrentSlot<T> requires a trivially copyable type or a fixed-size Eigen type");
+
+  ConcurrentSlot(const T & value = T{}) noexcept { std::memcpy(&value_, &value, sizeof(T)); }
+  ConcurrentSlot(const ConcurrentSlot &) = delete;
+  ConcurrentSlot & operator=(const ConcurrentSlot &) = delete;
+
+  /** Publish a new value, must only be called from the writer thread */
+  void write(const T & value) noexcept
+  {
+    const auto seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&value_, &value, sizeof(T));
+    seq_.store(seq + 2, std::memory_order_release);
+  }
+
+  /** Copy the latest value into \p out
+   *
+   * @returns The version of the value that was read, see version()
+   */
+  size_t read(T & out) const noexcept
+  {
+    size_t before = 0;
+    size_t after = 0;
+    do
+    {
+      before = seq_.load(std::memory_order_acquire);
+      while(before & 1)
+      {
+        std::this_thread::yield();
+        before = seq_.load(std::memory_order_acquire);
+      }
+      std::memcpy(&out, &value_, sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = seq_.load(std::memory_order_relaxed);
+    } while(before != after);
+    return before / 2;
+  }
+
+  /** Returns a copy of the latest value */
+  T read() const noexcept
+  {
+    T out;
+    read(out);
+    return out;
+  }
+
+  /** Number of writes performed on this slot
+   *
+   * Readers can compare this with the value returned by read(T&) to detect new data
+   */
+  size_t version() const noexcept { return seq_.load(std::memory_order_acquire) / 2; }
+
+private:
+  /** Sequence counter, odd while a write is in progress */
+  alignas(64) std::atomic<size_t> seq_{0};
+  /** Stored value, on its own cache lines to avoid false-sharing with the counter */
+  alignas(64) typename std::aligned_storage<sizeof(T), alignof(T)>::type value_;
+};
+
+/**
+ * @brief Data store for values shared between threads
+ *
+ * This is a companion to \ref DataStore for data that is produced outside of
+ * the control thread (perception, planning...). Each entry is a \ref
+ * ConcurrentSlot, it must be created once with make() and can then be written
+ * by a single producer and read by any number of consumers.
+ *
+ * Creating, retrieving or removing entries takes a lock. Time-critical code
+ * should retrieve the slot once (the reference stays valid until the entry is
+ * removed) and use ConcurrentSlot::read/ConcurrentSlot::write afterwards.
+ *
+ * \code{cpp}
+ * // During initialization
+ * auto & target = store.make<Eigen::Vector3d>("Perception::Target", Eigen::Vector3d::Zero());
+ * // In the perception thread
+ * target.write(newTarget);
+ * // In the control thread
+ * auto t = target.read();
+ * \endcode
+ */
+struct ConcurrentDataStore
+{
+  ConcurrentDataStore() = default;
+  ConcurrentDataStore(const ConcurrentDataStore &) = delete;
+  ConcurrentDataStore & operator=(const ConcurrentDataStore &) = delete;
+
+  /** Checks whether an entry is in the datastore */
+  inline bool has(const std::string & name) const noexcept
+  {
+    std::lock_guard<std::mutex> lck(mutex_);
+    return datas_.find(name) != datas_.end();
+  }
+
+  /** Returns all entries in the datastore */
+  inline std::vector<std::string> keys() const noexcept
+  {
+    std::lock_guard<std::mutex> lck(mutex_);
+    std::vector<std::string> out;
+    out.reserve(datas_.size());
+    for(const auto & d : datas_) { out.push_back(d.first); }
+    return out;
+  }
+
+  /**
+   * @brief Creates a new slot in the datastore
+   *
+   * @param name Name of the entry
+   *
+   * @param value Initial value of the entry
+   *
+   * @returns A reference to the slot, valid until the entry is removed
+   *
+   * @throws std::runtime_error if an entry with the same name already exists
+   */
+  template<typename T>
+  ConcurrentSlot<T> & make(const std::string & name, const T & value = T{})
+  {
+    std::lock_guard<std::mutex> lck(mutex_);
+    if(datas_.find(name) != datas_.end())
+    {
+      log::error_and_throw("[{}] An object named {} already exists on the datastore.", name_, name);
+    }
+    auto slot = std::make_shared<ConcurrentSlot<T>>(value);
+    auto & data = datas_.emplace(name, Data{}).first->second;
+    data.type = &type_name<T>;
+    data.hash = typeid(T).hash_code();
+    data.slot = slot;
+    return *slot;
+  }
+
+  /**
+   * @brief Get a slot from the datastore
+   *
+   * @throws std::runtime_error if the entry does not exist or does not hold a T
+   */
+  template<typename T>
+  ConcurrentSlot<T> & get(const std::string & name)
+  {
+    return const_cast<ConcurrentSlot<T> &>(get_<T>(name));
+  }
+
+  /** const variant of \ref get */
+  template<typename T>
+  const ConcurrentSlot<T> & get(const std::string & name) const
+  {
+    return get_<T>(name);
+  }
+
+  /** Shortcut for get<T>(name).write(value) */
+  template<typename T>
+  void write(const std::string & name, const T & value)
+  {
+    get<T>(name).write(value);
+  }
+
+  /** Shortcut for get<T>(name).read() */
+  template<typename T>
+  T read(const std::string & name) const
+  {
+    return get<T>(name).read();
+  }
+
+  /** Removes an entry from the datastore
+   *
+   * References previously obtained through make or get become invalid
+   */
+  inline void remove(const std::string & name) noexcept
+  {
+    std::lock_guard<std::mutex> lck(mutex_);
+    auto it = datas_.find(name);
+    if(it == datas_.end())
+    {
+      log::error("[{}] Failed to remove element \"{}\" (element does not exist)", name_, name);
+      return;
+    }
+    datas_.erase(it);
+  }
+
+  /** Remove all entries in the datastore */
+  inline void clear() noexcept
+  {
+    std::lock_guard<std::mutex> lck(mutex_);
+    datas_.clear();
+  }
+
+  /** Name of this datastore */
+  inline const std::string & name() const noexcept { return name_; }
+
+  /** Sets this datastore's name */
+  inline void name(const std::string & name) noexcept { name_ = name; }
+
+private:
+  struct Data
+  {
+    /** Holds the ConcurrentSlot<T> */
+    std::shared_ptr<void> slot;
+    /** Return the stored type name */
+    std::string (*type)() = nullptr;
+    /** Hash of the stored type */
+    size_t hash = 0;
+  };
+
+  template<typename T>
+  const ConcurrentSlot<T> & get_(const std::string & name) const
+  {
+    std::lock_guard<std::mutex> lck(mutex_);
+    const auto it = datas_.find(name);
+    if(it == datas_.end()) { log::error_and_throw("[{}] No key \"{}\"", name_, name); }
+    const auto & data = it->second;
+    if(data.hash != typeid(T).hash_code() && data.type() != type_name<T>())
+    {
+      log::error_and_throw(
+          "[{}] Object for key \"{}\" does not have the same type as the stored type. Stored {} but requested {}.",
+          name_, name, data.type(), type_name<T>());
+    }
+    return *static_cast<const ConcurrentSlot<T> *>(data.slot.get());
+  }
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Data> datas_;
+  std::string name_ = "ConcurrentDataStore";
+};
+
+} // namespace mc_rtc
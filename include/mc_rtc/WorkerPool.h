@@ -0,0 +1,104 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#pragma once
+
+#include <mc_rtc/utils_api.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace mc_rtc
+{
+
+/**
+ * @brief Persistent pool of threads to split a loop across cores
+ *
+ * The pool is designed to be used from the real-time loop:
+ * - threads are created once in the constructor;
+ * - run() does not allocate memory;
+ * - after a job completes, workers spin for a short (configurable) duration
+ *   waiting for the next job and only then park on a condition variable.
+ *
+ * The calling thread participates in the computation. Items are split into
+ * contiguous ranges, one per participant, so the assignment of items to
+ * threads only depends on the number of items and the pool size.
+ */
+struct MC_RTC_UTILS_DLLAPI WorkerPool
+{
+  /** Constructor
+   *
+   * \param nThreads Number of threads participating in run() including the
+   * calling thread, 0 uses the number of hardware threads
+   *
+   * \param spin How long workers spin waiting for a new job before parking
+   */
+  WorkerPool(size_t nThreads, std::chrono::microseconds spin = std::chrono::microseconds(200));
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool & operator=(const WorkerPool &) = delete;
+
+  ~WorkerPool();
+
+  /** Number of threads participating in run() (including the calling thread) */
+  inline size_t size() const noexcept { return workers_.size() + 1; }
+
+  /** Call f(i) for every i in [0, n) and wait for completion
+   *
+   * f is called concurrently from different threads with different values of
+   * i. If any call throws, the first exception (in participant order) is
+   * re-thrown once all participants have completed.
+   *
+   * run() must not be called concurrently or from inside f.
+   */
+  template<typename F>
+  void run(size_t n, F && f)
+  {
+    using FnT = std::remove_reference_t<F>;
+    auto callback = [](void * data, size_t begin, size_t end)
+    {
+      auto & fn = *static_cast<FnT *>(data);
+      for(size_t i = begin; i < end; ++i) { fn(i); }
+    };
+    run(n, callback, const_cast<void *>(static_cast<const void *>(&f)));
+  }
+
+  /** Type-erased version of run(), \p fn is called with \p data and a [begin, end) range */
+  void run(size_t n, void (*fn)(void *, size_t, size_t), void * data);
+
+  /** True if the calling thread is executing a job of any pool */
+  static bool inJob() noexcept;
+
+private:
+  std::vector<std::thread> workers_;
+  std::chrono::microseconds spin_;
+
+  /** Current job */
+  size_t n_ = 0;
+  void (*fn_)(void *, size_t, size_t) = nullptr;
+  void * data_ = nullptr;
+  std::vector<std::exception_ptr> errors_;
+
+  /** Incremented when a new job is available */
+  std::atomic<uint64_t> generation_{0};
+  /** Number of workers that have not completed the current job */
+  std::atomic<size_t> pending_{0};
+  /** Number of workers waiting on the condition variable */
+  std::atomic<size_t> parked_{0};
+  std::atomic<bool> stop_{false};
+  std::mutex mtx_;
+  std::condition_variable cv_;
+
+  void work(size_t idx);
+  void runRange(size_t participant) noexcept;
+};
+
+} // namespace mc_rtc
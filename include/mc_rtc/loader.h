@@ -245,6 +245,10 @@ public:
   void register_object(const std::string & name, std::function<RetT *(const Args &...)> callback);
 
   /** Create a new object of type name
+   *
+   * Different objects may be created concurrently from multiple threads as
+   * long as no library is loaded or object registered at the same time
+   *
    * \param name the object's name
    * \param Args argument required by the constructor
    * \return a shared pointer properly equipped to destroy the pointer
@@ -261,6 +265,14 @@ public:
    */
   std::string get_object_runtime_directory(const std::string & name) const noexcept;
 
+  /** Returns the path to the library providing an object
+   *
+   * Returns an empty string when the object is registered via a callback or if the object is unknown
+   *
+   * \param name Name of the object
+   */
+  std::string get_object_library_path(const std::string & name) const noexcept;
+
   struct ObjectDeleter
   {
     ObjectDeleter() {}
@@ -292,6 +304,11 @@ protected:
   Loader::handle_map_t handles_;
   mc_rtc::DataStore callbacks_;
   std::unordered_map<std::string, ObjectDeleter> deleters_;
+  /** Protects deleters_ and symbol resolution so objects can be created from multiple threads */
+  mutable std::mutex mtx_;
+
+  /** Returns the deleter associated to an object */
+  ObjectDeleter deleter(const std::string & name) const;
 
   /** Internal function to create a raw pointer */
   template<typename... Args>
@@ -109,6 +109,7 @@ void ObjectLoader<T>::load_libraries(const std::vector<std::string> & paths, Loa
 template<typename T>
 void ObjectLoader<T>::clear()
 {
+  std::unique_lock<std::mutex> lock(mtx_);
   deleters_.clear();
   handles_.clear();
   callbacks_.clear();
@@ -141,42 +142,63 @@ std::string ObjectLoader<T>::get_object_runtime_directory(const std::string & na
   return it->second->dir();
 }
 
+template<typename T>
+std::string ObjectLoader<T>::get_object_library_path(const std::string & name) const noexcept
+{
+  auto it = handles_.find(name);
+  if(it == handles_.end()) { return ""; }
+  return it->second->path();
+}
+
 template<typename T>
 template<typename... Args>
 T * ObjectLoader<T>::create_from_handles(const std::string & name, Args... args)
 {
   unsigned int args_passed = 1 + sizeof...(Args);
   unsigned int args_required = args_passed;
-  auto create_args_required = handles_[name]->template get_symbol<unsigned int (*)()>("create_args_required");
-  if(create_args_required != nullptr) { args_required = create_args_required(); }
-  if(args_passed != args_required)
+  const auto & handle = handles_.at(name);
+  T * (*create_fn)(const std::string &, const typename std::decay<Args>::type &...) = nullptr;
   {
-    mc_rtc::log::error_and_throw<LoaderException>("{} arguments passed to create function of {} which excepts {}",
-                                                  args_passed, name, args_required);
-  }
-  auto create_fn =
-      handles_[name]->template get_symbol<T * (*)(const std::string &, const typename std::decay<Args>::type &...)>(
-          "create");
-  if(create_fn == nullptr)
-  {
-    mc_rtc::log::error_and_throw<LoaderException>("Failed to resolve create symbol in {}", handles_[name]->path());
+    // Symbol resolution is serialized, the object creation itself may run concurrently
+    std::unique_lock<std::mutex> lock(mtx_);
+    auto create_args_required = handle->template get_symbol<unsigned int (*)()>("create_args_required");
+    if(create_args_required != nullptr) { args_required = create_args_required(); }
+    if(args_passed != args_required)
+    {
+      mc_rtc::log::error_and_throw<LoaderException>("{} arguments passed to create function of {} which excepts {}",
+                                                    args_passed, name, args_required);
+    }
+    create_fn = handle->template get_symbol<decltype(create_fn)>("create");
+    if(create_fn == nullptr)
+    {
+      mc_rtc::log::error_and_throw<LoaderException>("Failed to resolve create symbol in {}", handle->path());
+    }
+    if(!deleters_.count(name))
+    {
+      auto delete_fn = handle->template get_symbol<void (*)(T *)>("destroy");
+      if(delete_fn == nullptr)
+      {
+        mc_rtc::log::error_and_throw<LoaderException>("Symbol destroy not found in {}", handle->path());
+      }
+      deleters_[name] = ObjectDeleter(delete_fn);
+    }
   }
-  if constexpr(details::has_set_loading_location_v<T>) { T::set_loading_location(handles_[name]->dir()); }
+  if constexpr(details::has_set_loading_location_v<T>) { T::set_loading_location(handle->dir()); }
   if constexpr(details::has_set_name_v<T>) { T::set_name(name); }
   T * ptr = create_fn(name, args...);
   if(ptr == nullptr) { mc_rtc::log::error_and_throw<LoaderException>("Call to create for object {} failed", name); }
-  if(!deleters_.count(name))
-  {
-    auto delete_fn = handles_[name]->template get_symbol<void (*)(T *)>("destroy");
-    if(delete_fn == nullptr)
-    {
-      mc_rtc::log::error_and_throw<LoaderException>("Symbol destroy not found in {}", handles_[name]->path());
-    }
-    deleters_[name] = ObjectDeleter(delete_fn);
-  }
   return ptr;
 }
 
+template<typename T>
+typename ObjectLoader<T>::ObjectDeleter ObjectLoader<T>::deleter(const std::string & name) const
+{
+  std::unique_lock<std::mutex> lock(mtx_);
+  auto it = deleters_.find(name);
+  if(it == deleters_.end()) { return {}; }
+  return it->second;
+}
+
 template<typename T>
 template<typename... Args>
 T * ObjectLoader<T>::create_from_callbacks(const std::string & name, Args... args)
@@ -192,6 +214,7 @@ void ObjectLoader<T>::register_object(const std::string & name, std::function<Re
   static_assert(std::is_base_of<T, RetT>::value,
                 "This object cannot be registered as it does not derive from the loader base-class");
   callbacks_.make_call(name, [callback](const Args &... args) -> T * { return callback(args...); });
+  std::unique_lock<std::mutex> lock(mtx_);
   deleters_[name] = ObjectDeleter([](T * ptr) { delete static_cast<RetT *>(ptr); });
 }
 
@@ -200,7 +223,7 @@ template<typename... Args>
 std::shared_ptr<T> ObjectLoader<T>::create_object(const std::string & name, Args... args)
 {
   T * ptr = create(name, std::forward<Args>(args)...);
-  return std::shared_ptr<T>(ptr, deleters_[name]);
+  return std::shared_ptr<T>(ptr, deleter(name));
 }
 
 template<typename T>
@@ -208,7 +231,7 @@ template<typename... Args>
 typename ObjectLoader<T>::unique_ptr ObjectLoader<T>::create_unique_object(const std::string & name, Args... args)
 {
   T * ptr = create(name, std::forward<Args>(args)...);
-  return unique_ptr(ptr, deleters_[name]);
+  return unique_ptr(ptr, deleter(name));
 }
 
 } // namespace mc_rtc
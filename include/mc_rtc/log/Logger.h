@@ -178,9 +178,24 @@ public:
    *
    * Print controller data to the log.
    *
+   * This is equivalent to serialize() followed by write()
    */
   void log();
 
+  /*! \brief Serialize the controller's data for the current iteration
+   *
+   * The data is written to the log by the next call to write(), which does not
+   * access the log entries so it can be called from another thread as long as
+   * serialize() is not called concurrently
+   */
+  void serialize();
+
+  /*! \brief Write the data serialized by the last call to serialize()
+   *
+   * Does nothing if nothing was serialized since the last call
+   */
+  void write();
+
   /** Add a log entry into the log with the provided source
    *
    * This function only accepts callable objects that returns a l/rvalue to a
@@ -11,6 +11,8 @@
 #include <mc_rtc/gui/StateBuilder.h>
 #include <mc_rtc/void_ptr.h>
 
+#include <unordered_map>
+
 namespace mc_solver
 {
 
@@ -27,6 +29,8 @@ struct MC_SOLVER_DLLAPI CollisionsConstraint : public ConstraintSet
 public:
   /** Default value of damping offset */
   constexpr static double defaultDampingOffset = 0.1;
+  /** Hysteresis used to decide when a collision is culled by the broad phase (Tasks backend) */
+  constexpr static double broadPhaseMargin = 0.05;
 
 public:
   /** Constructor
@@ -100,6 +104,72 @@ public:
    */
   inline void automaticMonitor(bool a) noexcept { autoMonitor_ = a; }
 
+  /** Get the broad-phase culling setting */
+  inline bool broadPhase() const noexcept { return broadPhase_; }
+
+  /** Set the broad-phase culling setting
+   *
+   * If true, a sphere enclosing each convex is used to skip the
+   * narrow-phase distance computation for pairs that are further apart than
+   * their interaction distance. The bounding spheres give a lower bound of the
+   * actual distance so the constraint is unchanged for pairs that might be
+   * active.
+   *
+   * In TVM backend, the collision function reports the distance between the
+   * spheres instead of the actual distance for culled pairs.
+   *
+   * In Tasks backend, culled pairs are removed from the underlying constraint
+   * and added back once they get within \ref broadPhaseMargin / 2 of their
+   * interaction distance.
+   *
+   * Disabled by default.
+   */
+  inline void broadPhase(bool b) noexcept { broadPhase_ = b; }
+
+  /** Get the self-collision filter setting */
+  inline bool selfCollisionFilter() const noexcept { return selfCollisionFilter_; }
+
+  /** Set the self-collision filter setting
+   *
+   * If true (default), self-collisions obtained from a wildcard are not added
+   * when the robot module's self-collision filter excludes them: adjacent
+   * pairs are always skipped, far pairs are skipped if their minimum sampled
+   * distance is greater than the collision interaction distance plus \ref
+   * selfCollisionFilterMargin
+   *
+   * \see mc_rbdyn::SelfCollisionFilter
+   */
+  inline void selfCollisionFilter(bool f) noexcept { selfCollisionFilter_ = f; }
+
+  /** Get the self-collision filter margin */
+  inline double selfCollisionFilterMargin() const noexcept { return selfCollisionFilterMargin_; }
+
+  /** Set the self-collision filter margin (m)
+   *
+   * The filter distances come from a finite sampling of the configuration
+   * space, the margin accounts for configurations that were not sampled.
+   * Defaults to 0.05
+   */
+  inline void selfCollisionFilterMargin(double m) noexcept { selfCollisionFilterMargin_ = m; }
+
+  /** Number of threads used to evaluate the collisions */
+  inline size_t threads() const noexcept { return threads_; }
+
+  /** Set the number of threads used to evaluate the collisions
+   *
+   * With a single thread (default), collisions are evaluated one after the
+   * other when the solver is updated. Otherwise, the distances, closest points
+   * and Jacobian points are computed by a persistent pool of threads (the
+   * control thread being one of them) before the solver runs. Each collision
+   * is always evaluated by a single thread so the results do not depend on the
+   * number of threads.
+   *
+   * \param n Number of threads, 0 uses all hardware threads
+   *
+   * \note Only supported in TVM backend
+   */
+  void threads(size_t n);
+
   void addToSolverImpl(QPSolver & solver) override;
 
   void update(QPSolver & solver) override;
@@ -130,8 +200,47 @@ private:
   std::string __keyByNames(const std::string & name1, const std::string & name2);
   int __createCollId(const mc_rbdyn::Collision & col);
   std::pair<int, mc_rbdyn::Collision> __popCollId(const std::string & name1, const std::string & name2);
-  /** Actually adds the collision to the constraint, handles id creation and wildcard support */
-  void __addCollision(mc_solver::QPSolver & solver, const mc_rbdyn::Collision & col);
+  /** Actually adds the collision to the constraint, handles id creation and wildcard support
+   *
+   * \param fromWildcard True if \p col was obtained by expanding a wildcard
+   */
+  void __addCollision(mc_solver::QPSolver & solver, const mc_rbdyn::Collision & col, bool fromWildcard = false);
+  bool selfCollisionFilter_ = true;
+  double selfCollisionFilterMargin_ = 0.05;
+
+  size_t threads_ = 1;
+
+  /* Broad-phase culling (Tasks backend) */
+  bool broadPhase_ = false;
+  struct BroadPhaseSphere
+  {
+    /** Index of the body the convex is attached to */
+    unsigned int bodyIndex;
+    /** Transformation from the body to the convex */
+    sva::PTransformd X_b_c;
+    /** Center of the sphere in the convex frame */
+    Eigen::Vector3d center;
+    double radius;
+  };
+  struct BroadPhaseData
+  {
+    mc_rbdyn::Collision collision;
+    Eigen::VectorXd r1Selector;
+    Eigen::VectorXd r2Selector;
+    BroadPhaseSphere s1;
+    BroadPhaseSphere s2;
+    /** True if the collision has been removed from the underlying constraint */
+    bool culled = false;
+    /** Lower bound of the distance and associated points when culled */
+    double distance = 0.0;
+    Eigen::Vector3d p1 = Eigen::Vector3d::Zero();
+    Eigen::Vector3d p2 = Eigen::Vector3d::Zero();
+  };
+  std::unordered_map<int, BroadPhaseData> broadPhaseData_;
+  /** Update the broad phase, returns true if the underlying constraint has changed */
+  bool updateBroadPhase(QPSolver & solver);
+  /** Returns the broad-phase data if the collision is culled, nullptr otherwise */
+  const BroadPhaseData * culledCollision(int collId) const noexcept;
 
   /* Internal management for collision display */
   bool autoMonitor_ = true;
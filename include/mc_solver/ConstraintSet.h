@@ -43,6 +43,23 @@ struct MC_SOLVER_DLLAPI ConstraintSet
 
   inline QPSolver::Backend backend() const noexcept { return backend_; }
 
+  /** Update group of the constraint, -1 if the constraint has no group
+   *
+   * See QPSolver::parallelUpdate
+   */
+  inline int updateGroup() const noexcept { return updateGroup_; }
+
+  /** Set the update group of the constraint
+   *
+   * When the solver parallel update is enabled, constraints with a
+   * non-negative group are updated concurrently with constraints of other
+   * groups. Use -1 (the default) to update the constraint on the solver
+   * thread.
+   *
+   * The group should be set before the constraint is added to the solver.
+   */
+  inline void updateGroup(int group) noexcept { updateGroup_ = group; }
+
 protected:
   /** Should take care of the actual insertion into a concrete solver */
   virtual void addToSolverImpl(mc_solver::QPSolver & solver) = 0;
@@ -56,6 +73,9 @@ protected:
   /** True if the constraint is in a solver already */
   bool inSolver_ = false;
 
+  /** Update group, see updateGroup() */
+  int updateGroup_ = -1;
+
 private:
   // Forbid copy of ConstraintSet objects
   ConstraintSet(const ConstraintSet &) = delete;
@@ -13,6 +13,15 @@ namespace mc_solver
 struct MC_SOLVER_DLLAPI ConstraintSetLoader : public mc_solver::GenericLoader<ConstraintSetLoader, ConstraintSet>
 {
   static storage_t & storage();
+
+  /** Register a new loading function
+   *
+   * Options common to all constraints (updateGroup) are loaded after \p fn
+   * returns
+   *
+   * \see GenericLoader::register_load_function
+   */
+  static Handle register_load_function(const std::string & type, load_fun fn);
 };
 
 } // namespace mc_solver
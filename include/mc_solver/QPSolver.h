@@ -25,6 +25,7 @@ namespace mc_rtc
 {
 
 struct Logger;
+struct WorkerPool;
 
 namespace gui
 {
@@ -120,7 +121,7 @@ public:
    */
   QPSolver(double timeStep, Backend backend);
 
-  virtual ~QPSolver() = default;
+  virtual ~QPSolver();
 
   /** Returns the backend for this solver instance */
   inline Backend backend() const noexcept { return backend_; }
@@ -279,6 +280,58 @@ public:
   /** Returns the building and solving time in ms */
   virtual double solveAndBuildTime() = 0;
 
+  /** Time spent in the different phases of run() (all durations are in ms) */
+  struct MC_SOLVER_DLLAPI Timings
+  {
+    /** Update of each constraint (same order as constraints()) */
+    std::vector<double> constraints;
+    /** Update of each task (same order as tasks()) */
+    std::vector<double> tasks;
+    /** Update of all constraints and tasks */
+    double update = 0;
+    /** Assembly of the problem
+     *
+     * \note The TVM backend assembles the problem while solving, this is
+     * always zero and the assembly is accounted for in solve
+     */
+    double build = 0;
+    /** Resolution of the problem */
+    double solve = 0;
+    /** Integration of the solution and update of the robots' kinematics */
+    double robots = 0;
+    /** Total time spent in run() */
+    double total = 0;
+  };
+
+  /** Timings of the latest call to run()
+   *
+   * These timings are also available in the log (perf_QPSolver_* entries) and
+   * in the GUI (Solver tab)
+   */
+  inline const Timings & timings() const noexcept { return timings_; }
+
+  /** Enable the parallel update of constraints and tasks
+   *
+   * When enabled, the constraints (resp. tasks) are updated as follows before
+   * the problem is solved:
+   * - constraints (resp. tasks) with an update group (see
+   *   ConstraintSet::updateGroup and MetaTask::updateGroup) are dispatched to
+   *   a pool of threads, all constraints (resp. tasks) in a group are updated
+   *   on the same thread in the order they were added to the solver;
+   * - once every group has been updated, the other constraints (resp. tasks)
+   *   are updated on the calling thread in the order they were added.
+   *
+   * Constraints are updated before tasks. Only put objects that do not share
+   * any mutable state with objects outside of their group in a group.
+   *
+   * \param threads Number of threads used for the update (including the
+   * calling thread), 0 or 1 disable the parallel update
+   */
+  void parallelUpdate(size_t threads);
+
+  /** Number of threads used to update constraints and tasks (1 if the parallel update is disabled) */
+  size_t parallelUpdate() const noexcept;
+
   /** Set the logger for this solver instance */
   void logger(std::shared_ptr<mc_rtc::Logger> logger);
   /** Access to the logger instance */
@@ -325,6 +378,12 @@ protected:
   /** Can be nullptr if this not associated to any controller */
   mc_control::MCController * controller_ = nullptr;
 
+  /** Update the constraints and tasks before solving, implementations must call this before solving */
+  void updateConstrsAndTasks();
+
+  /** Timings of the latest run, implementations must fill build, solve and robots */
+  Timings timings_;
+
   /** Should run the control prroblem and update the control robot accordingly */
   virtual bool run_impl(FeedbackType fType = FeedbackType::None) = 0;
 
@@ -333,6 +392,37 @@ protected:
 
   /** This is called anytime a constraint is removed, the passed constraint is not always a dynamics constraint */
   virtual void removeDynamicsConstraint(mc_solver::ConstraintSet * maybe_dynamics) = 0;
+
+private:
+  /** Pool used for the parallel update, nullptr if the parallel update is disabled */
+  std::unique_ptr<mc_rtc::WorkerPool> updatePool_;
+
+  /** Dispatch of the constraints and tasks (by index) for the parallel update */
+  struct UpdatePlan
+  {
+    std::vector<std::vector<size_t>> constraintGroups;
+    std::vector<size_t> constraints;
+    std::vector<std::vector<size_t>> taskGroups;
+    std::vector<size_t> tasks;
+  };
+  UpdatePlan updatePlan_;
+  /** True if updatePlan_ must be computed again */
+  bool updatePlanDirty_ = true;
+
+  /** Timing of each task (same order as metaTasks_), the log entries refer to these slots */
+  std::vector<std::unique_ptr<double>> taskTimings_;
+
+  /** Update the i-th constraint and record its timing */
+  void updateConstraint(size_t i);
+
+  /** Update the i-th task and record its timing */
+  void updateTask(size_t i);
+
+  void addTimingsToLogger();
+  void removeTimingsFromLogger();
+  /** Log the timing of the i-th task, the entry is removed with its slot in \ref removeTask */
+  void addTaskTimingToLogger(size_t i);
+  void addTimingsToGUI();
 };
 
 } // namespace mc_solver
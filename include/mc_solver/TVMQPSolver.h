@@ -5,6 +5,8 @@
 #pragma once
 
 #include <mc_solver/QPSolver.h>
+#include <mc_solver/utils/ContactsDiff.h>
+#include <mc_solver/utils/JointsFeedback.h>
 
 #include <mc_rtc/clock.h>
 
@@ -84,9 +86,17 @@ private:
     tvm::VariableVector f2_;
     /** Constraints on f2 */
     std::vector<tvm::TaskWithRequirementsPtr> f2Constraints_;
+    /** Name of the contact force entry in the log */
+    std::string logEntry_;
+    /** Name of the contact force element in the GUI */
+    std::string guiEntry_;
   };
   /** Related contact functions */
   std::vector<ContactData> contactsData_;
+  /** Index of each contact in contacts_ */
+  utils::ContactsIndex contactsIndex_;
+  /** Dynamics constraints removed from the problem while contacts are modified */
+  std::vector<DynamicsConstraint *> suspendedDynamics_;
   /** Runtime of the latest run call */
   mc_rtc::duration_ms solve_dt_{0};
 
@@ -123,10 +133,7 @@ private:
   void updateRobot(mc_rbdyn::Robot & robot);
 
   /** Feedback data */
-  std::vector<std::vector<double>> prev_encoders_{};
-  std::vector<std::vector<double>> encoders_alpha_{};
-  std::vector<std::vector<std::vector<double>>> control_q_{};
-  std::vector<std::vector<std::vector<double>>> control_alpha_{};
+  utils::JointsFeedback feedback_;
 
   /** Dynamics constraint currently active for robots in the solver */
   std::unordered_map<std::string, DynamicsConstraint *> dynamics_;
@@ -139,9 +146,17 @@ private:
   void removeDynamicsConstraint(mc_solver::DynamicsConstraint * dyn);
 
   size_t getContactIdx(const mc_rbdyn::Contact & contact);
+  /** Add a contact or update its parameters, resumeDynamics() must be called afterwards */
   void addContact(const mc_rbdyn::Contact & contact);
-  using ContactIterator = std::vector<mc_rbdyn::Contact>::iterator;
-  ContactIterator removeContact(size_t idx);
+  /** Remove contacts given their indices in decreasing order, resumeDynamics() must be called afterwards */
+  void removeContacts(const std::vector<size_t> & indices);
+  /** Remove a dynamics constraint from the problem until resumeDynamics() is called
+   *
+   * This lets us modify the contacts of a dynamics constraint multiple times while only re-inserting it once
+   */
+  void suspendDynamics(DynamicsConstraint * dyn);
+  /** Insert back the suspended dynamics constraints */
+  void resumeDynamics();
   std::tuple<size_t, bool> addVirtualContactImpl(const mc_rbdyn::Contact & contact);
   void addContactToDynamics(const std::string & robot,
                             const mc_rbdyn::RobotFrame & frame,
@@ -5,10 +5,13 @@
 #pragma once
 
 #include <mc_solver/QPSolver.h>
+#include <mc_solver/utils/JointsFeedback.h>
 
 #include <Tasks/QPMotionConstr.h>
 #include <Tasks/QPSolver.h>
 
+#include <atomic>
+
 namespace mc_solver
 {
 
@@ -110,6 +113,9 @@ struct MC_SOLVER_DLLAPI TasksQPSolver final : public QPSolver
    * \note This is mainly provided to allow safe usage of raw constraint from
    * Tasks rather than those wrapped in this library, you probably do not need
    * to call this
+   *
+   * When called from a parallel update (see QPSolver::parallelUpdate) the
+   * update is deferred until the problem is solved
    */
   void updateConstrSize();
 
@@ -164,6 +170,8 @@ private:
   std::vector<tasks::qp::UnilateralContact> uniContacts_;
   /** Holds bilateral contacts in the solver */
   std::vector<tasks::qp::BilateralContact> biContacts_;
+  /** True if updateConstrSize() was called from a parallel update */
+  std::atomic<bool> constrSizePending_{false};
   /** Run without feedback (open-loop) */
   bool runOpenLoop();
   /** Run with encoders' feedback */
@@ -190,11 +198,11 @@ private:
    */
   bool runClosedLoop(bool integrateControlState);
 
+  /** Solve the problem without updating the robots and record the timings */
+  bool solve();
+
   /** Feedback data */
-  std::vector<std::vector<double>> prev_encoders_{};
-  std::vector<std::vector<double>> encoders_alpha_{};
-  std::vector<std::vector<std::vector<double>>> control_q_{};
-  std::vector<std::vector<std::vector<double>>> control_alpha_{};
+  utils::JointsFeedback feedback_;
 
   /** Holds dynamics constraint currently in the solver */
   std::vector<mc_solver::DynamicsConstraint *> dynamicsConstraints_;
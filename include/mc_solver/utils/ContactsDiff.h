@@ -0,0 +1,66 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#pragma once
+
+#include <mc_solver/api.h>
+
+#include <mc_rbdyn/Contact.h>
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mc_solver
+{
+
+namespace utils
+{
+
+/** Identifies a contact, two contacts have the same key iff they compare equal (see mc_rbdyn::Contact::operator==) */
+struct MC_SOLVER_DLLAPI ContactKey
+{
+  ContactKey(const mc_rbdyn::Contact & contact);
+
+  std::string r1Surface;
+  std::string r2Surface;
+
+  inline bool operator==(const ContactKey & rhs) const noexcept
+  {
+    return r1Surface == rhs.r1Surface && r2Surface == rhs.r2Surface;
+  }
+};
+
+struct MC_SOLVER_DLLAPI ContactKeyHash
+{
+  size_t operator()(const ContactKey & key) const noexcept;
+};
+
+/** Map a contact to its index in a set of contacts */
+using ContactsIndex = std::unordered_map<ContactKey, size_t, ContactKeyHash>;
+
+/** Build the index of a set of contacts */
+MC_SOLVER_DLLAPI ContactsIndex indexContacts(const std::vector<mc_rbdyn::Contact> & contacts);
+
+/** Difference between the contacts in a solver and a new set of contacts */
+struct MC_SOLVER_DLLAPI ContactsDiff
+{
+  /** Indices (in the current set) of contacts that are not in the new set, in decreasing order */
+  std::vector<size_t> removed;
+  /** Indices (in the new set) of contacts that are not in the current set, in increasing order */
+  std::vector<size_t> added;
+  /** Indices (in the current set, in the new set) of contacts that are in both sets */
+  std::vector<std::pair<size_t, size_t>> kept;
+
+  /** Compute the difference between \p current and \p next in O(current.size() + next.size()) */
+  ContactsDiff(const std::vector<mc_rbdyn::Contact> & current, const std::vector<mc_rbdyn::Contact> & next);
+
+  /** True if both sets contain the same contacts (parameters of the contacts might differ) */
+  inline bool sameContacts() const noexcept { return removed.empty() && added.empty(); }
+};
+
+} // namespace utils
+
+} // namespace mc_solver
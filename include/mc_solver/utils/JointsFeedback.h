@@ -0,0 +1,73 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#pragma once
+
+#include <mc_solver/api.h>
+
+#include <mc_rbdyn/Robots.h>
+
+#include <utility>
+#include <vector>
+
+namespace mc_solver
+{
+
+namespace utils
+{
+
+/** Data used by the solvers to inject encoder measurements into the robots
+ * and to save/restore their control state
+ *
+ * For each robot, the correspondance between the encoders (in reference
+ * joint order) and the joints of the MultiBodyConfig is resolved once and
+ * the control state is saved into flat buffers. This data is re-computed
+ * when robots are loaded or removed (see mc_rbdyn::Robots::generation).
+ */
+struct MC_SOLVER_DLLAPI JointsFeedback
+{
+  /** Make sure the data matches \p robots, this is a no-op if the robots did not change */
+  void reset(const mc_rbdyn::Robots & robots);
+
+  /** Save the configuration and velocity of the i-th robot */
+  void saveControlState(size_t i, const mc_rbdyn::Robot & robot) noexcept;
+
+  /** Restore the configuration and velocity saved by saveControlState */
+  void restoreControlState(size_t i, mc_rbdyn::Robot & robot) const noexcept;
+
+  /** Write the encoder values of the i-th robot into its configuration
+   *
+   * The encoder velocity is computed by finite differences with the previous
+   * encoder values. It is written into the robot's velocity if \p wVelocity
+   * is true.
+   *
+   * \returns False if the robot has no encoders, the robot is not modified in that case
+   */
+  bool applyEncoders(size_t i, mc_rbdyn::Robot & robot, double dt, bool wVelocity);
+
+  /** Encoder velocity of the i-th robot computed by the last call to applyEncoders */
+  inline const std::vector<double> & encodersAlpha(size_t i) const noexcept { return robots_[i].encodersAlpha; }
+
+private:
+  struct RobotData
+  {
+    /** Robot the data was computed for */
+    const mc_rbdyn::Robot * robot = nullptr;
+    /** Index in the encoders and index in the MultiBodyConfig of every joint with an encoder */
+    std::vector<std::pair<size_t, size_t>> encoderToJoint;
+    /** Saved configuration (flattened) */
+    std::vector<double> q;
+    /** Saved velocity (flattened) */
+    std::vector<double> alpha;
+    std::vector<double> prevEncoders;
+    std::vector<double> encodersAlpha;
+  };
+  const mc_rbdyn::Robots * source_ = nullptr;
+  uint64_t generation_ = 0;
+  std::vector<RobotData> robots_;
+};
+
+} // namespace utils
+
+} // namespace mc_solver
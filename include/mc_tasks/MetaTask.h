@@ -156,6 +156,22 @@ public:
 
   inline Backend backend() const noexcept { return backend_; }
 
+  /*! \brief Update group of the task, -1 if the task has no group
+   *
+   * See mc_solver::QPSolver::parallelUpdate
+   */
+  inline int updateGroup() const noexcept { return updateGroup_; }
+
+  /*! \brief Set the update group of the task
+   *
+   * When the solver parallel update is enabled, tasks with a non-negative
+   * group are updated concurrently with tasks of other groups. Use -1 (the
+   * default) to update the task on the solver thread.
+   *
+   * The group should be set before the task is added to the solver.
+   */
+  inline void updateGroup(int group) noexcept { updateGroup_ = group; }
+
 protected:
   /*! \brief Add the task to a solver
    *
@@ -286,6 +302,8 @@ protected:
   std::string name_;
 
   size_t iterInSolver_ = 0;
+
+  int updateGroup_ = -1;
 };
 
 using MetaTaskPtr = std::shared_ptr<MetaTask>;
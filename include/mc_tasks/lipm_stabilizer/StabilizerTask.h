@@ -903,7 +903,95 @@ protected:
   bool reconfigure_ = true;
   bool enabled_ = true; /** Whether the stabilizer is enabled */
 
-  Eigen::QuadProgDense qpSolver_; /**< Least-squares solver for wrench distribution */
+  /** Solver and problem data of a wrench distribution QP
+   *
+   * The data is only resized when the problem dimensions change (e.g. when
+   * constrainCoP is toggled or the horizon length changes) so that solving the
+   * distribution QPs does not allocate memory in the control loop
+   */
+  struct MC_TASKS_DLLAPI QPWorkspace
+  {
+    /** Resize the problem and the solver, no effect if the dimensions did not change */
+    void resize(int nrVar, int nrIneq);
+
+    Eigen::QuadProgDense solver;
+    Eigen::MatrixXd Q;
+    Eigen::VectorXd c;
+    Eigen::MatrixXd Aeq = Eigen::MatrixXd(0, 0);
+    Eigen::VectorXd beq = Eigen::VectorXd(0);
+    Eigen::MatrixXd Aineq;
+    Eigen::VectorXd bineq;
+  };
+
+  /** Workspace of the CoP distribution QP over a horizon, see computeCoPonHorizon
+   *
+   * The tasks and constraints of this problem only involve the modeled CoPs
+   * z = Acop * x of each iteration of the horizon, where Acop is lower
+   * triangular. When Acop is well-conditioned, the problem is solved as one
+   * small QP (4 variables, 8 constraints) per iteration followed by a
+   * triangular solve to recover x, the dense QP is used otherwise.
+   *
+   * The problem is described by Lx, Ly, Mstep, bcop, bcopReg, bcopDiff and
+   * bineq, the dense matrices are assembled from them when needed.
+   */
+  struct MC_TASKS_DLLAPI HorizonQPWorkspace : public QPWorkspace
+  {
+    /** Resize the problem for \p nbReferences references, no effect if the dimensions did not change */
+    void resize(int nbReferences);
+
+    /** Solve the problem iteration by iteration if possible, with the dense QP otherwise
+     *
+     * The solution is written in x
+     *
+     * \returns False if the problem has no solution
+     */
+    bool solve(int nbReferences, double copWeight, double copDiffWeight, double copRegulationWeight);
+
+    /** True if the diagonal of Lx and Ly is large enough (relative to their scale) to solve iteration by iteration */
+    bool structured() const;
+
+    /** Solve the problem iteration by iteration (see above), the solution is written in x
+     *
+     * \returns False if one of the per-iteration problems has no solution
+     */
+    bool solveSteps(int nbReferences, double copWeight, double copDiffWeight, double copRegulationWeight);
+
+    /** Solve the dense problem, the solution is written in x
+     *
+     * \returns False if the problem has no solution
+     */
+    bool solveDense(int nbReferences, double copWeight, double copDiffWeight, double copRegulationWeight);
+
+    /** Lower triangular maps from the CoP references of a foot to the modeled CoPs (x and y coordinates) */
+    Eigen::MatrixXd Lx;
+    Eigen::MatrixXd Ly;
+    /** For each iteration, map from the modeled CoPs of both feet to the modeled ZMP */
+    Eigen::MatrixXd Mstep;
+    /** Modeled CoPs of each iteration [zl_x zl_y zr_x zr_y] */
+    Eigen::MatrixXd Z;
+    /** Solution of the problem */
+    Eigen::VectorXd x;
+    /** Solver and data of the per-iteration problems */
+    Eigen::QuadProgDense stepSolver;
+    Eigen::MatrixXd stepQ;
+    Eigen::VectorXd stepc;
+    Eigen::MatrixXd stepAineq;
+    Eigen::VectorXd stepBineq;
+
+    /** Task to meet the CoPs to the reference ZMP */
+    Eigen::MatrixXd Mcop;
+    Eigen::VectorXd bcop;
+    /** Task to regulate the CoPs under the foot ankle */
+    Eigen::MatrixXd McopReg;
+    Eigen::VectorXd bcopReg;
+    /** Task to regulate the CoPs difference */
+    Eigen::MatrixXd McopDiff;
+    Eigen::VectorXd bcopDiff;
+  };
+
+  QPWorkspace distribQP_; /**< Double support wrench distribution QP, see distributeWrench */
+  QPWorkspace saturateQP_; /**< Single support wrench saturation QP, see saturateWrench */
+  HorizonQPWorkspace horizonQP_; /**< Double support CoP distribution over a horizon, see computeCoPonHorizon */
   Eigen::Vector3d dcmAverageError_ = Eigen::Vector3d::Zero();
   Eigen::Vector3d dcmError_ = Eigen::Vector3d::Zero();
   Eigen::Vector3d dcmVelError_ = Eigen::Vector3d::Zero();
@@ -43,6 +43,15 @@ public:
   /** Called *once* every iteration to advance the iteration counter */
   void tick();
 
+  /** Compute the distance, closest points and Jacobian points for the current convexes position
+   *
+   * This is normally done when the value is updated. It can be called
+   * beforehand to evaluate several functions concurrently: distinct functions
+   * can be precomputed from different threads as long as the convexes are not
+   * moved in the meantime. The next value update uses the precomputed result.
+   */
+  void precompute();
+
   /** Distance between the two objects */
   inline double distance() const noexcept { return this->value()(0); }
 
@@ -52,6 +61,23 @@ public:
   /** Closest point on c1 in inertial frame coordinates */
   inline const Eigen::Vector3d & p1() const noexcept { return p1_; }
 
+  /** Set the broad-phase distance
+   *
+   * When the distance between the bounding spheres of both objects is above
+   * this value the narrow-phase distance computation is skipped and the
+   * function value is the distance between the spheres which is a lower bound
+   * of the actual distance.
+   *
+   * A non-positive value (default) disables the broad phase
+   */
+  inline void broadPhaseDistance(double d) noexcept { broadPhaseDistance_ = d; }
+
+  /** Broad-phase distance \see broadPhaseDistance(double) */
+  inline double broadPhaseDistance() const noexcept { return broadPhaseDistance_; }
+
+  /** True if the narrow phase was skipped in the last update */
+  inline bool culled() const noexcept { return culled_; }
+
   /** Second convex involved in the collision */
   inline const Convex & c2() const noexcept { return *c2_; }
 
@@ -77,6 +103,18 @@ protected:
 
   sch::CD_Pair pair_;
 
+  double broadPhaseDistance_ = 0.0;
+  bool culled_ = false;
+  bool wasCulled_ = false;
+
+  double dist_ = 0.0;
+  bool precomputed_ = false;
+
+  /** Compute the distance between the bounding spheres, returns false if the narrow phase is required */
+  bool updateBroadPhase(double & dist);
+  /** Compute the distance, closest points and Jacobian points */
+  void computeDistance();
+
   struct ObjectData
   {
     Eigen::Vector3d nearestPoint_;
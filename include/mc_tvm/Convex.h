@@ -18,7 +18,8 @@ namespace mc_tvm
 /** A convex is an SCH object associated to a Frame
  *
  * It defines a single output:
- * - Position: update the convex position according to the frame
+ * - Position: update the convex position according to the frame and the
+ *   position of a sphere enclosing the convex
  */
 struct MC_TVM_DLLAPI Convex : public tvm::graph::abstract::Node<Convex>
 {
@@ -55,12 +56,35 @@ public:
   /** Access the associated frame */
   inline const mc_rbdyn::RobotFrame & frame() { return *frame_; }
 
+  /** Position of the convex in world frame */
+  inline const sva::PTransformd & position() const noexcept { return position_; }
+
+  /** Center of a sphere enclosing the convex in world frame */
+  inline const Eigen::Vector3d & boundingSphereCenter() const noexcept { return sphereCenter_; }
+
+  /** Radius of a sphere enclosing the convex */
+  inline double boundingSphereRadius() const noexcept { return sphereRadius_; }
+
+  /** Update the convex position and bounding sphere from the current robot state
+   *
+   * This performs the same computation as the Position update but does not
+   * require a graph update, e.g. to compute distances before the solver runs
+   */
+  void updateFromRobot();
+
 private:
   mc_rbdyn::S_ObjectPtr object_;
   mc_rbdyn::ConstRobotFramePtr frame_;
   sva::PTransformd X_f_c_;
+  sva::PTransformd position_ = sva::PTransformd::Identity();
+  /** Bounding sphere center in the convex frame, computed on the first update */
+  Eigen::Vector3d localSphereCenter_ = Eigen::Vector3d::Zero();
+  Eigen::Vector3d sphereCenter_ = Eigen::Vector3d::Zero();
+  double sphereRadius_ = -1.0;
 
   void updatePosition();
+
+  void setPosition(const sva::PTransformd & X_0_f);
 };
 
 } // namespace mc_tvm
@@ -134,6 +134,41 @@ public:
   /** Access tau variable */
   inline tvm::VariablePtr & tau() { return tau_; }
 
+  /** Part of a flat q (resp. dof) vector that corresponds to one joint of the robot's mbc() */
+  struct JointSegment
+  {
+    /** Joint index in the mbc */
+    size_t joint;
+    /** Start of the joint in the flat vector */
+    Eigen::DenseIndex offset;
+    /** Number of parameters (resp. dofs) of the joint */
+    Eigen::DenseIndex size;
+  };
+
+  /** Joints with parameters in the robot's mbc() and their place in the q variable */
+  inline const std::vector<JointSegment> & paramSegments() const noexcept { return paramSegments_; }
+
+  /** Joints with dofs in the robot's mbc() and their place in the alpha, alphaD and tau variables */
+  inline const std::vector<JointSegment> & dofSegments() const noexcept { return dofSegments_; }
+
+  /** Copy a parameter-sized quantity of the mbc (e.g. q) into \p out
+   *
+   * Same as rbd::paramToVector but uses the copy plan computed at construction, \p out must have nrParams elements
+   */
+  void paramToVector(const std::vector<std::vector<double>> & param, Eigen::Ref<Eigen::VectorXd> out) const noexcept;
+
+  /** Copy a dof-sized quantity of the mbc (e.g. alpha, jointTorque) into \p out
+   *
+   * Same as rbd::dofToVector but uses the copy plan computed at construction, \p out must have nrDof elements
+   */
+  void dofToVector(const std::vector<std::vector<double>> & dof, Eigen::Ref<Eigen::VectorXd> out) const noexcept;
+
+  /** Copy \p v (e.g. the value of alphaD or tau) into a dof-sized quantity of the mbc
+   *
+   * Same as rbd::vectorToDof but uses the copy plan computed at construction, \p dof must already have the mbc layout
+   */
+  void vectorToDof(const Eigen::Ref<const Eigen::VectorXd> & v, std::vector<std::vector<double>> & dof) const noexcept;
+
   /** Returns the CoM algorithm associated to this robot (const) */
   inline const CoM & comAlgo() const noexcept { return *com_; }
 
@@ -213,6 +248,13 @@ private:
   CoMPtr com_;
   /** Momentum algorithm of this robot */
   MomentumPtr momentum_;
+  /** Copy plan between the mbc parameters and q */
+  std::vector<JointSegment> paramSegments_;
+  /** Copy plan between the mbc dofs and alpha/alphaD/tau */
+  std::vector<JointSegment> dofSegments_;
+  /** Buffers used to update the variables from the mbc without allocations */
+  Eigen::VectorXd paramBuffer_;
+  Eigen::VectorXd dofBuffer_;
   /** Correspondance between refJointOrder index and q index. **/
   std::vector<Eigen::DenseIndex> refJointIndexToQIndex_;
   /** Correspondance between refJointOrder index and q dot index. **/
@@ -100,14 +100,13 @@ void ControllerServer::handle_requests(mc_rtc::gui::StateBuilder & gui_builder)
 
 void ControllerServer::publish(mc_rtc::gui::StateBuilder & gui_builder)
 {
-  if(iter_++ % rate_ == 0)
-  {
-    buffer_size_ = gui_builder.update(buffer_);
-#ifndef MC_RTC_DISABLE_NETWORK
-    int err = nn_send(pub_socket_, buffer_.data(), buffer_size_, 0);
-    if(err < 0) { mc_rtc::log::error("[ControllerServer] Failed to send {}", nn_strerror(nn_errno())); }
-#endif
-  }
+  update(gui_builder);
+  send();
+}
+
+void ControllerServer::update(mc_rtc::gui::StateBuilder & gui_builder)
+{
+  if(iter_++ % rate_ == 0) { buffer_size_ = gui_builder.update(buffer_); }
   else
   {
     gui_builder.update();
@@ -115,6 +114,15 @@ void ControllerServer::publish(mc_rtc::gui::StateBuilder & gui_builder)
   }
 }
 
+void ControllerServer::send()
+{
+#ifndef MC_RTC_DISABLE_NETWORK
+  if(buffer_size_ == 0) { return; }
+  int err = nn_send(pub_socket_, buffer_.data(), buffer_size_, 0);
+  if(err < 0) { mc_rtc::log::error("[ControllerServer] Failed to send {}", nn_strerror(nn_errno())); }
+#endif
+}
+
 std::pair<const char *, size_t> ControllerServer::data() const
 {
   return {buffer_.data(), buffer_size_};
@@ -175,6 +175,12 @@ MCController::MCController(const std::vector<std::shared_ptr<mc_rbdyn::RobotModu
     }
     load_into.load(robot_config(e));
   }
+  /** Parallel update of constraints and tasks */
+  qpsolver->parallelUpdate(config_("ParallelUpdate", size_t{1}));
+  /** Lazy evaluation of the control and real robots' kinematics */
+  lazyKinematics_ = config_("LazyKinematics", false);
+  for(auto & r : robots()) { r.lazyKinematics(lazyKinematics_); }
+  for(auto & r : realRobots()) { r.lazyKinematics(lazyKinematics_); }
 
   if(gui_)
   {
@@ -316,6 +322,7 @@ MCController::~MCController()
 {
   gui()->reset();
   datastore().clear();
+  concurrentDatastore().clear();
 }
 
 mc_rbdyn::Robot & MCController::loadRobot(mc_rbdyn::RobotModulePtr rm, const std::string & name)
@@ -342,8 +349,9 @@ mc_rbdyn::Robot & MCController::loadRobot(mc_rbdyn::RobotModulePtr rm, const std
   }
   mc_rbdyn::LoadRobotParameters params{};
   auto & robot = loadRobot(rm, name, robots(), params);
+  robot.lazyKinematics(lazyKinematics_);
   params.warn_on_missing_files(false).data(robot.data());
-  loadRobot(rm, name, realRobots(), params);
+  loadRobot(rm, name, realRobots(), params).lazyKinematics(lazyKinematics_);
   std::string urdf;
   auto loadUrdf = [&canonicalModule, &urdf]() -> const std::string &
   {
@@ -394,8 +402,7 @@ mc_rbdyn::Robot & MCController::loadRobot(mc_rbdyn::RobotModulePtr rm,
   assert(rm);
   auto & r = robots.load(name, *rm, params);
   r.mbc().gravity = mc_rtc::constants::gravity;
-  r.forwardKinematics();
-  r.forwardVelocity();
+  r.forwardAll(mc_rbdyn::Robot::ForwardOrder::Velocity);
   return r;
 }
 
@@ -727,8 +734,7 @@ void MCController::reset(const ControllerResetData & reset_data)
   robot().mbc().zero(robot().mb());
   robot().mbc().q = reset_data.q;
   postureTask->posture(reset_data.q);
-  robot().forwardKinematics();
-  robot().forwardVelocity();
+  robot().forwardAll(mc_rbdyn::Robot::ForwardOrder::Velocity);
   updateContacts();
   if(gui_)
   {
@@ -13,6 +13,7 @@
 
 #include <mc_rbdyn/RobotLoader.h>
 
+#include <mc_rtc/AllocationTracker.h>
 #include <mc_rtc/ConfigurationHelpers.h>
 #include <mc_rtc/config.h>
 #include <mc_rtc/gui/Button.h>
@@ -26,10 +27,61 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <exception>
 
 namespace mc_control
 {
 
+namespace
+{
+
+/** Always pick a steady clock */
+using clock = typename std::conditional<std::chrono::high_resolution_clock::is_steady,
+                                        std::chrono::high_resolution_clock,
+                                        std::chrono::steady_clock>::type;
+
+/** Call f(i) for every i in [0, n), concurrently if parallel is true
+ *
+ * \returns The exception thrown by each call, if any
+ */
+template<typename F>
+std::vector<std::exception_ptr> parallelFor(size_t n, bool parallel, const F & f)
+{
+  std::vector<std::exception_ptr> errors(n);
+  auto work = [&](size_t i)
+  {
+    try
+    {
+      f(i);
+    }
+    catch(...)
+    {
+      errors[i] = std::current_exception();
+    }
+  };
+  size_t n_threads = parallel ? std::min<size_t>(n, std::max(std::thread::hardware_concurrency(), 1u)) : 1;
+  if(n_threads <= 1)
+  {
+    for(size_t i = 0; i < n; ++i) { work(i); }
+    return errors;
+  }
+  std::atomic<size_t> next{0};
+  std::vector<std::thread> threads;
+  threads.reserve(n_threads);
+  for(size_t t = 0; t < n_threads; ++t)
+  {
+    threads.emplace_back(
+        [&]()
+        {
+          for(size_t i = next++; i < n; i = next++) { work(i); }
+        });
+  }
+  for(auto & t : threads) { t.join(); }
+  return errors;
+}
+
+} // namespace
+
 MCGlobalController::PluginHandle::~PluginHandle() {}
 
 MCGlobalController::MCGlobalController(const std::string & conf, std::shared_ptr<mc_rbdyn::RobotModule> rm)
@@ -40,6 +92,24 @@ MCGlobalController::MCGlobalController(const std::string & conf, std::shared_ptr
 MCGlobalController::MCGlobalController(const GlobalConfiguration & conf)
 : config(conf), controller_(nullptr), next_controller_(nullptr)
 {
+  // Setup latency statistics before any plugin is loaded
+  {
+    double deadline = config.latency_deadline < 0 ? config.timestep : config.latency_deadline;
+    latency_stats_.deadline = 1000 * deadline;
+    latency_stats_.window_size = std::max<uint64_t>(
+        static_cast<uint64_t>(std::llround(config.latency_window / config.timestep)), uint64_t{1});
+    global_run_latency_ = &latency_stats_.phases["GlobalRun"];
+    controller_run_latency_ = &latency_stats_.phases["ControllerRun"];
+    observers_run_latency_ = &latency_stats_.phases["ObserversRun"];
+    conversion_latency_ = &latency_stats_.phases["Conversion"];
+    gui_latency_ = &latency_stats_.phases["Gui"];
+    log_latency_ = &latency_stats_.phases["Log"];
+  }
+  if(config.track_allocations && !mc_rtc::AllocationTracker::hooksLoaded())
+  {
+    mc_rtc::log::warning("TrackAllocations is enabled but the allocator hooks are not loaded, link with "
+                         "mc_rtc_allocation_hooks or preload it to track the allocations");
+  }
   // Display configuration information
   if(conf.enable_gui_server)
   {
@@ -97,17 +167,38 @@ MCGlobalController::MCGlobalController(const GlobalConfiguration & conf)
   {
     config.enabled_controllers.push_back("HalfSitPose");
   }
+  // Configurations are fully loaded before creating the controllers since the creation might happen in other threads
+  std::vector<std::pair<std::string, mc_rtc::Configuration>> create_now;
+  std::vector<std::pair<std::string, mc_rtc::Configuration>> create_later;
   for(const auto & c : config.enabled_controllers)
   {
-    AddController(c);
-    if(c == config.initial_controller && controllers.count(c))
+    auto is_c = [&c](const std::pair<std::string, mc_rtc::Configuration> & p) { return p.first == c; };
+    if(std::find_if(create_now.begin(), create_now.end(), is_c) != create_now.end()
+       || std::find_if(create_later.begin(), create_later.end(), is_c) != create_later.end())
     {
-      current_ctrl = c;
-      controller_ = controllers[c].get();
+      mc_rtc::log::warning("Controller {} already enabled", c);
+      continue;
     }
     config.load_controller_plugin_configs(c, config.global_plugins);
     auto ctrl_plugins = mc_rtc::fromVectorOrElement<std::string>(config.controllers_configs[c], "Plugins", {});
     config.load_controller_plugin_configs(c, ctrl_plugins);
+    if(config.lazy_controllers_creation && c != config.initial_controller)
+    {
+      create_later.push_back({c, config.controllers_configs[c]});
+    }
+    else { create_now.push_back({c, config.controllers_configs[c]}); }
+  }
+  auto created = createControllers(create_now);
+  for(size_t i = 0; i < created.size(); ++i)
+  {
+    if(!created[i]) { continue; }
+    const auto & c = create_now[i].first;
+    controllers[c] = created[i];
+    if(c == config.initial_controller)
+    {
+      current_ctrl = c;
+      controller_ = created[i].get();
+    }
   }
   next_ctrl = current_ctrl;
   next_controller_ = nullptr;
@@ -127,10 +218,58 @@ MCGlobalController::MCGlobalController(const GlobalConfiguration & conf)
   {
     server_.reset(new mc_control::ControllerServer(config.timestep, config.gui_server_configuration));
   }
+
+  if(config.async_post_run)
+  {
+    mc_rtc::log::info("GUI publication and logging will run asynchronously");
+    post_run_thread_ = std::thread([this]() { postRunLoop(); });
+  }
+  if(create_later.size())
+  {
+    mc_rtc::log::info("{} controller(s) will be created in the background", create_later.size());
+    for(const auto & c : create_later) { lazy_controllers_pending_.push_back(c.first); }
+    lazy_controllers_thread_ = std::thread(
+        [this, create_later]()
+        {
+          parallelFor(create_later.size(), config.parallel_controllers_creation,
+                      [&](size_t i)
+                      {
+                        const auto & name = create_later[i].first;
+                        std::shared_ptr<MCController> ctl;
+                        try
+                        {
+                          ctl = createController(name, create_later[i].second);
+                        }
+                        catch(const std::exception & e)
+                        {
+                          mc_rtc::log::error("Creation of controller {} failed: {}", name, e.what());
+                        }
+                        catch(...)
+                        {
+                          mc_rtc::log::error("Creation of controller {} failed with an unknown exception", name);
+                        }
+                        std::unique_lock<std::mutex> lck(lazy_controllers_mutex_);
+                        lazy_controllers_ready_.push_back({name, ctl});
+                        lazy_controllers_has_ready_ = true;
+                      });
+        });
+  }
 }
 
 MCGlobalController::~MCGlobalController()
 {
+  waitLazyControllers();
+  if(post_run_thread_.joinable())
+  {
+    waitPostRun();
+    {
+      std::unique_lock<std::mutex> lck(post_run_mutex_);
+      post_run_stop_ = true;
+    }
+    post_run_cv_.notify_all();
+    post_run_thread_.join();
+  }
+  if(latency_stats_.iterations) { printLatencyStats(); }
   // We clear all datastore and gui before (potentially) unloading any libraries
   for(auto & ctl : controllers)
   {
@@ -149,6 +288,7 @@ std::vector<std::string> MCGlobalController::enabled_controllers() const
 {
   std::vector<std::string> ret;
   for(const auto & c : controllers) { ret.push_back(c.first); }
+  ret.insert(ret.end(), lazy_controllers_pending_.begin(), lazy_controllers_pending_.end());
   return ret;
 }
 
@@ -180,6 +320,7 @@ void MCGlobalController::init(const std::vector<double> & initq, const std::arra
 
 void MCGlobalController::init(const std::vector<double> & initq, const sva::PTransformd & initAttitude)
 {
+  waitPostRun();
   initEncoders(controller().robot(), initq);
   controller().robot().posW(initAttitude);
   for(auto & robot : controller().robots())
@@ -192,6 +333,7 @@ void MCGlobalController::init(const std::vector<double> & initq, const sva::PTra
 
 void MCGlobalController::init(const std::vector<double> & initq)
 {
+  waitPostRun();
   initEncoders(controller().robot(), initq);
 
   auto & q = controller().robot().mbc().q;
@@ -261,6 +403,7 @@ void MCGlobalController::init(const std::map<std::string, std::vector<double>> &
                               const std::map<std::string, sva::PTransformd> & initAttitudes,
                               bool reset)
 {
+  waitPostRun();
   for(auto & robot : controller().robots())
   {
     auto initq_it = initqs.find(robot.name());
@@ -285,11 +428,14 @@ void MCGlobalController::init(const std::map<std::string, std::vector<double>> &
 void MCGlobalController::reset(const std::map<std::string, std::vector<double>> & initqs,
                                const std::map<std::string, sva::PTransformd> & initAttitudes)
 {
+  waitPostRun();
+  waitLazyControllers();
   controllers.erase(current_ctrl);
   setup_logger_.erase(current_ctrl);
   config.load_controllers_configs();
   AddController(current_ctrl);
   controller_ = controllers[current_ctrl].get();
+  controller_generation_++;
   init(initqs, initAttitudes, true);
 }
 
@@ -378,11 +524,13 @@ void MCGlobalController::initController(bool reset)
 
 void MCGlobalController::setSensorPosition(const Eigen::Vector3d & pos)
 {
+  waitPostRun();
   controller().robot().data()->bodySensors[0].position(pos);
 }
 
 void MCGlobalController::setSensorPosition(const std::string & robotName, const Eigen::Vector3d & pos)
 {
+  waitPostRun();
   controller().robot(robotName).data()->bodySensors[0].position(pos);
 }
 
@@ -400,6 +548,7 @@ void MCGlobalController::setSensorPositions(const std::string & robotName,
 void MCGlobalController::setSensorPositions(mc_rbdyn::Robot & robot,
                                             const std::map<std::string, Eigen::Vector3d> & poses)
 {
+  waitPostRun();
   for(const auto & p : poses)
   {
     robot.data()->bodySensors[robot.data()->bodySensorsIndex.at(p.first)].position(p.second);
@@ -408,11 +557,13 @@ void MCGlobalController::setSensorPositions(mc_rbdyn::Robot & robot,
 
 void MCGlobalController::setSensorOrientation(const Eigen::Quaterniond & ori)
 {
+  waitPostRun();
   controller().robot().data()->bodySensors[0].orientation(ori);
 }
 
 void MCGlobalController::setSensorOrientation(const std::string & robotName, const Eigen::Quaterniond & ori)
 {
+  waitPostRun();
   controller().robot(robotName).data()->bodySensors[0].orientation(ori);
 }
 
@@ -428,6 +579,7 @@ void MCGlobalController::setSensorOrientations(const std::string & robotName, co
 
 void MCGlobalController::setSensorOrientations(mc_rbdyn::Robot & robot, const QuaternionMap & oris)
 {
+  waitPostRun();
   for(const auto & o : oris)
   {
     robot.data()->bodySensors[robot.data()->bodySensorsIndex.at(o.first)].orientation(o.second);
@@ -436,11 +588,13 @@ void MCGlobalController::setSensorOrientations(mc_rbdyn::Robot & robot, const Qu
 
 void MCGlobalController::setSensorLinearVelocity(const Eigen::Vector3d & vel)
 {
+  waitPostRun();
   controller().robot().data()->bodySensors[0].linearVelocity(vel);
 }
 
 void MCGlobalController::setSensorLinearVelocity(const std::string & robotName, const Eigen::Vector3d & vel)
 {
+  waitPostRun();
   controller().robot(robotName).data()->bodySensors[0].linearVelocity(vel);
 }
 
@@ -458,6 +612,7 @@ void MCGlobalController::setSensorLinearVelocities(const std::string & robotName
 void MCGlobalController::setSensorLinearVelocities(mc_rbdyn::Robot & robot,
                                                    const std::map<std::string, Eigen::Vector3d> & linearVels)
 {
+  waitPostRun();
   for(const auto & lv : linearVels)
   {
     robot.data()->bodySensors[robot.data()->bodySensorsIndex.at(lv.first)].linearVelocity(lv.second);
@@ -466,11 +621,13 @@ void MCGlobalController::setSensorLinearVelocities(mc_rbdyn::Robot & robot,
 
 void MCGlobalController::setSensorAngularVelocity(const Eigen::Vector3d & vel)
 {
+  waitPostRun();
   controller().robot().data()->bodySensors[0].angularVelocity(vel);
 }
 
 void MCGlobalController::setSensorAngularVelocity(const std::string & name, const Eigen::Vector3d & vel)
 {
+  waitPostRun();
   controller().robot(name).data()->bodySensors[0].angularVelocity(vel);
 }
 
@@ -488,6 +645,7 @@ void MCGlobalController::setSensorAngularVelocities(const std::string & name,
 void MCGlobalController::setSensorAngularVelocities(mc_rbdyn::Robot & robot,
                                                     const std::map<std::string, Eigen::Vector3d> & angularVels)
 {
+  waitPostRun();
   for(const auto & av : angularVels)
   {
     robot.data()->bodySensors[robot.data()->bodySensorsIndex.at(av.first)].angularVelocity(av.second);
@@ -512,11 +670,13 @@ void MCGlobalController::setSensorAccelerations(mc_rbdyn::Robot & robot,
 
 void MCGlobalController::setSensorLinearAcceleration(const Eigen::Vector3d & acc)
 {
+  waitPostRun();
   controller().robot().data()->bodySensors[0].linearAcceleration(acc);
 }
 
 void MCGlobalController::setSensorLinearAcceleration(const std::string & name, const Eigen::Vector3d & acc)
 {
+  waitPostRun();
   controller().robot(name).data()->bodySensors[0].linearAcceleration(acc);
 }
 
@@ -534,6 +694,7 @@ void MCGlobalController::setSensorLinearAccelerations(const std::string & name,
 void MCGlobalController::setSensorLinearAccelerations(mc_rbdyn::Robot & robot,
                                                       const std::map<std::string, Eigen::Vector3d> & accels)
 {
+  waitPostRun();
   for(const auto & a : accels)
   {
     robot.data()->bodySensors[robot.data()->bodySensorsIndex.at(a.first)].linearAcceleration(a.second);
@@ -542,6 +703,7 @@ void MCGlobalController::setSensorLinearAccelerations(mc_rbdyn::Robot & robot,
 
 void MCGlobalController::setSensorAngularAcceleration(const Eigen::Vector3d & acc)
 {
+  waitPostRun();
   controller().robot().data()->bodySensors[0].angularAcceleration(acc);
 }
 
@@ -559,6 +721,7 @@ void MCGlobalController::setSensorAngularAccelerations(const std::string & name,
 void MCGlobalController::setSensorAngularAccelerations(mc_rbdyn::Robot & robot,
                                                        const std::map<std::string, Eigen::Vector3d> & accels)
 {
+  waitPostRun();
   for(const auto & a : accels)
   {
     robot.data()->bodySensors[robot.data()->bodySensorsIndex.at(a.first)].angularAcceleration(a.second);
@@ -567,31 +730,37 @@ void MCGlobalController::setSensorAngularAccelerations(mc_rbdyn::Robot & robot,
 
 void MCGlobalController::setEncoderValues(const std::vector<double> & eValues)
 {
+  waitPostRun();
   controller().robot().data()->encoderValues = eValues;
 }
 
 void MCGlobalController::setEncoderValues(const std::string & robotName, const std::vector<double> & eValues)
 {
+  waitPostRun();
   controller().robot(robotName).data()->encoderValues = eValues;
 }
 
 void MCGlobalController::setEncoderVelocities(const std::vector<double> & eVelocities)
 {
+  waitPostRun();
   controller().robot().data()->encoderVelocities = eVelocities;
 }
 
 void MCGlobalController::setEncoderVelocities(const std::string & robotName, const std::vector<double> & eVelocities)
 {
+  waitPostRun();
   controller().robot(robotName).data()->encoderVelocities = eVelocities;
 }
 
 void MCGlobalController::setJointTorques(const std::vector<double> & tValues)
 {
+  waitPostRun();
   controller().robot().data()->jointTorques = tValues;
 }
 
 void MCGlobalController::setJointTorques(const std::string & robotName, const std::vector<double> & tValues)
 {
+  waitPostRun();
   controller().robot(robotName).data()->jointTorques = tValues;
 }
 
@@ -603,6 +772,7 @@ void MCGlobalController::setWrenches(const std::map<std::string, sva::ForceVecd>
 void MCGlobalController::setWrenches(const std::string & robotName,
                                      const std::map<std::string, sva::ForceVecd> & wrenches)
 {
+  waitPostRun();
   auto & robot = controller().robot(robotName);
   for(const auto & w : wrenches)
   {
@@ -626,6 +796,7 @@ void MCGlobalController::setJointMotorTemperature(const std::string & robotName,
                                                   const std::string & joint,
                                                   double temperature)
 {
+  waitPostRun();
   auto & robot = controller().robot(robotName);
   auto & sensors = robot.data()->jointSensors;
   sensors[robot.data()->jointJointSensors.at(joint)].motorTemperature(temperature);
@@ -639,6 +810,7 @@ void MCGlobalController::setJointMotorTemperatures(const std::map<std::string, d
 void MCGlobalController::setJointMotorTemperatures(const std::string & robotName,
                                                    const std::map<std::string, double> & temperatures)
 {
+  waitPostRun();
   auto & robot = controller().robot(robotName);
   auto & sensors = robot.data()->jointSensors;
   for(const auto & t : temperatures)
@@ -656,6 +828,7 @@ void MCGlobalController::setJointDriverTemperature(const std::string & robotName
                                                    const std::string & joint,
                                                    double temperature)
 {
+  waitPostRun();
   auto & robot = controller().robot(robotName);
   auto & sensors = robot.data()->jointSensors;
   sensors[robot.data()->jointJointSensors.at(joint)].driverTemperature(temperature);
@@ -669,6 +842,7 @@ void MCGlobalController::setJointDriverTemperatures(const std::map<std::string,
 void MCGlobalController::setJointDriverTemperatures(const std::string & robotName,
                                                     const std::map<std::string, double> & temperatures)
 {
+  waitPostRun();
   auto & robot = controller().robot(robotName);
   auto & sensors = robot.data()->jointSensors;
   for(const auto & t : temperatures)
@@ -684,6 +858,7 @@ void MCGlobalController::setJointMotorCurrent(const std::string & joint, double
 
 void MCGlobalController::setJointMotorCurrent(const std::string & robotName, const std::string & joint, double current)
 {
+  waitPostRun();
   auto & robot = controller().robot(robotName);
   auto & sensors = robot.data()->jointSensors;
   sensors[robot.data()->jointJointSensors.at(joint)].motorCurrent(current);
@@ -697,6 +872,7 @@ void MCGlobalController::setJointMotorCurrents(const std::map<std::string, doubl
 void MCGlobalController::setJointMotorCurrents(const std::string & robotName,
                                                const std::map<std::string, double> & currents)
 {
+  waitPostRun();
   auto & robot = controller().robot(robotName);
   auto & sensors = robot.data()->jointSensors;
   for(const auto & c : currents) { sensors[robot.data()->jointJointSensors.at(c.first)].motorCurrent(c.second); }
@@ -709,6 +885,7 @@ void MCGlobalController::setJointMotorStatus(const std::string & joint, bool sta
 
 void MCGlobalController::setJointMotorStatus(const std::string & robotName, const std::string & joint, bool status)
 {
+  waitPostRun();
   auto & robot = controller().robot(robotName);
   auto & sensors = robot.data()->jointSensors;
   sensors[robot.data()->jointJointSensors.at(joint)].motorStatus(status);
@@ -722,18 +899,141 @@ void MCGlobalController::setJointMotorStatuses(const std::map<std::string, bool>
 void MCGlobalController::setJointMotorStatuses(const std::string & robotName,
                                                const std::map<std::string, bool> & statuses)
 {
+  waitPostRun();
   auto & robot = controller().robot(robotName);
   auto & sensors = robot.data()->jointSensors;
   for(const auto & s : statuses) { sensors[robot.data()->jointJointSensors.at(s.first)].motorStatus(s.second); }
 }
 
+MCGlobalController::SensorLayout MCGlobalController::makeSensorLayout(const std::string & robot,
+                                                                     const std::vector<std::string> & forceSensors,
+                                                                     const std::vector<std::string> & joints,
+                                                                     const std::vector<std::string> & bodySensors)
+{
+  SensorLayout layout;
+  layout.robot = robot;
+  layout.forceSensors = forceSensors;
+  layout.joints = joints;
+  layout.bodySensors = bodySensors;
+  resolveSensorLayout(layout);
+  return layout;
+}
+
+mc_rbdyn::RobotData & MCGlobalController::resolveSensorLayout(SensorLayout & layout)
+{
+  auto & robots = controller().robots();
+  if(layout.generation_ == controller_generation_ && layout.robots_ == &robots
+     && layout.robotsGeneration_ == robots.generation())
+  {
+    return *robots.robot(layout.robotIndex_).data();
+  }
+  if(!robots.hasRobot(layout.robot))
+  {
+    mc_rtc::log::error_and_throw("[SensorLayout] No robot named {} in the current controller", layout.robot);
+  }
+  auto & robot = robots.robot(layout.robot);
+  auto & data = *robot.data();
+  auto resolve = [&](const std::vector<std::string> & names, const std::unordered_map<std::string, size_t> & indexes,
+                     std::vector<size_t> & out, const char * type)
+  {
+    out.resize(names.size());
+    for(size_t i = 0; i < names.size(); ++i)
+    {
+      auto it = indexes.find(names[i]);
+      if(it == indexes.end())
+      {
+        mc_rtc::log::error_and_throw("[SensorLayout] No {} named {} in {}", type, names[i], layout.robot);
+      }
+      out[i] = it->second;
+    }
+  };
+  // Invalidate the layout until all indices are resolved
+  layout.robots_ = nullptr;
+  resolve(layout.forceSensors, data.forceSensorsIndex, layout.forceSensorsIdx_, "force sensor");
+  resolve(layout.joints, data.jointJointSensors, layout.jointSensorsIdx_, "joint sensor");
+  resolve(layout.bodySensors, data.bodySensorsIndex, layout.bodySensorsIdx_, "body sensor");
+  layout.generation_ = controller_generation_;
+  layout.robots_ = &robots;
+  layout.robotsGeneration_ = robots.generation();
+  layout.robotIndex_ = robot.robotIndex();
+  return data;
+}
+
+namespace
+{
+
+void checkLayoutSize(const MCGlobalController::SensorLayout & layout,
+                     const std::vector<std::string> & names,
+                     size_t size,
+                     const char * setter)
+{
+  if(size != names.size())
+  {
+    mc_rtc::log::error_and_throw("[MCGlobalController::{}] Layout for {} expects {} values but {} were provided",
+                                 setter, layout.robot, names.size(), size);
+  }
+}
+
+} // namespace
+
+void MCGlobalController::setWrenches(SensorLayout & layout, const sva::ForceVecd * wrenches, size_t size)
+{
+  waitPostRun();
+  auto & sensors = resolveSensorLayout(layout).forceSensors;
+  checkLayoutSize(layout, layout.forceSensors, size, "setWrenches");
+  for(size_t i = 0; i < size; ++i) { sensors[layout.forceSensorsIdx_[i]].wrench(wrenches[i]); }
+}
+
+void MCGlobalController::setJointMotorTemperatures(SensorLayout & layout, const double * temperatures, size_t size)
+{
+  waitPostRun();
+  auto & sensors = resolveSensorLayout(layout).jointSensors;
+  checkLayoutSize(layout, layout.joints, size, "setJointMotorTemperatures");
+  for(size_t i = 0; i < size; ++i) { sensors[layout.jointSensorsIdx_[i]].motorTemperature(temperatures[i]); }
+}
+
+void MCGlobalController::setJointDriverTemperatures(SensorLayout & layout, const double * temperatures, size_t size)
+{
+  waitPostRun();
+  auto & sensors = resolveSensorLayout(layout).jointSensors;
+  checkLayoutSize(layout, layout.joints, size, "setJointDriverTemperatures");
+  for(size_t i = 0; i < size; ++i) { sensors[layout.jointSensorsIdx_[i]].driverTemperature(temperatures[i]); }
+}
+
+void MCGlobalController::setJointMotorCurrents(SensorLayout & layout, const double * currents, size_t size)
+{
+  waitPostRun();
+  auto & sensors = resolveSensorLayout(layout).jointSensors;
+  checkLayoutSize(layout, layout.joints, size, "setJointMotorCurrents");
+  for(size_t i = 0; i < size; ++i) { sensors[layout.jointSensorsIdx_[i]].motorCurrent(currents[i]); }
+}
+
+void MCGlobalController::setSensorOrientations(SensorLayout & layout, const Eigen::Quaterniond * oris, size_t size)
+{
+  waitPostRun();
+  auto & sensors = resolveSensorLayout(layout).bodySensors;
+  checkLayoutSize(layout, layout.bodySensors, size, "setSensorOrientations");
+  for(size_t i = 0; i < size; ++i) { sensors[layout.bodySensorsIdx_[i]].orientation(oris[i]); }
+}
+
 bool MCGlobalController::run()
 {
-  /** Always pick a steady clock */
-  using clock = typename std::conditional<std::chrono::high_resolution_clock::is_steady,
-                                          std::chrono::high_resolution_clock, std::chrono::steady_clock>::type;
   /** Helper to converst Tasks' timer */
   auto start_run_t = clock::now();
+  if(latency_rollover_)
+  {
+    // Rotate the latency windows in run() so that the time it takes is part of the statistics
+    for(auto & p : latency_stats_.phases) { p.second.rollover(); }
+    latency_rollover_ = false;
+  }
+  if(config.track_allocations) { mc_rtc::AllocationTracker::start(); }
+  uint64_t start_allocations = mc_rtc::AllocationTracker::allocations();
+  mc_rtc::AllocationTracker::Phase global_run_phase("GlobalRun");
+  waitPostRun();
+  adoptLazyControllers();
+  bool post_run = false;
+  // With AsyncPostRun the GUI requests are handled here so that they are applied before the next solve
+  if(config.async_post_run && running && controller_) { handleGUIRequests(); }
   /* Check if we need to change the controller this time */
   if(next_controller_)
   {
@@ -764,6 +1064,7 @@ bool MCGlobalController::run()
         js.motorCurrent(controller_->robot().jointJointSensor(js.joint()).motorCurrent());
         js.motorStatus(controller_->robot().jointJointSensor(js.joint()).motorStatus());
       }
+      controller_->realRobot().updateKinematics();
       next_controller_->realRobot().mbc() = controller_->realRobot().mbc();
     }
     if(!running) { controller_ = next_controller_; }
@@ -775,6 +1076,8 @@ bool MCGlobalController::run()
         if(controller_->gui_) { pipeline.removeFromGUI(*controller_->gui()); }
         pipeline.removeFromLogger(controller_->logger());
       }
+      printLatencyStats();
+      resetLatencyStats();
       controller_->stop();
       mc_rtc::log::info("Reset with q[0] = {}", mc_rtc::io::to_string(controller_->robot().mbc().q[0], ", ", 5));
       for(const auto & g : controller_->robot().grippersByName())
@@ -790,6 +1093,7 @@ bool MCGlobalController::run()
       resetControllerPlugins();
     }
     next_controller_ = nullptr;
+    controller_generation_++;
     current_ctrl = next_ctrl;
     if(config.enable_log) { start_log(); }
     initGUI();
@@ -800,24 +1104,39 @@ bool MCGlobalController::run()
     mc_solver::QPSolver::context_backend(controller_->solver().backend());
     for(auto & plugin : plugins_before_)
     {
+      mc_rtc::AllocationTracker::Phase phase(plugin.phase);
       auto start_t = clock::now();
       plugin.plugin->before(*this);
       plugin.plugin_before_dt = clock::now() - start_t;
+      plugin.latency->record(plugin.plugin_before_dt.count());
     }
     auto start_observers_run_t = clock::now();
-    controller_->runObserverPipelines();
+    {
+      mc_rtc::AllocationTracker::Phase phase("ObserversRun");
+      controller_->runObserverPipelines();
+    }
     observers_run_dt = clock::now() - start_observers_run_t;
+    observers_run_latency_->record(observers_run_dt.count());
 
     auto start_controller_run_t = clock::now();
-    bool r = controller_->run();
+    bool r = false;
+    {
+      mc_rtc::AllocationTracker::Phase phase("ControllerRun");
+      r = controller_->run();
+    }
     auto end_controller_run_t = clock::now();
 
+    auto start_conversion_t = end_controller_run_t;
     for(size_t i = 0; i < controller_->robots().size(); ++i)
     {
+      mc_rtc::AllocationTracker::Phase phase("Conversion");
       auto & robot = controller_->robots().robot(i);
       auto & realRobot = controller_->realRobots().robot(i);
       auto & outputRobot = controller_->outputRobots().robot(i);
       auto & outputRealRobot = controller_->outputRealRobots().robot(i);
+      // The conversion and the post-process callbacks read the mbc directly
+      robot.updateKinematics();
+      realRobot.updateKinematics();
       controller_->converters_[i].convert(robot, outputRobot);
       controller_->converters_[i].convert(realRobot, outputRealRobot);
       const auto & gi = robot.grippers();
@@ -829,29 +1148,24 @@ bool MCGlobalController::run()
       robot.module().controlToCanonicalPostProcess(robot, outputRobot);
       robot.module().controlToCanonicalPostProcess(realRobot, outputRealRobot);
     }
-    if(server_)
-    {
-      auto start_gui_t = clock::now();
-      server_->handle_requests(*controller_->gui_);
-      server_->publish(*controller_->gui_);
-      gui_dt = clock::now() - start_gui_t;
-    }
+    conversion_dt = clock::now() - start_conversion_t;
+    conversion_latency_->record(conversion_dt.count());
+    publishGUI(config.async_post_run);
     controller_run_dt = end_controller_run_t - start_controller_run_t;
+    controller_run_latency_->record(controller_run_dt.count());
     solver_build_and_solve_t = controller_->solver().solveAndBuildTime();
     solver_solve_t = controller_->solver().solveTime();
     if(!r) { running = false; }
     for(auto & plugin : plugins_after_)
     {
+      mc_rtc::AllocationTracker::Phase phase(plugin.phase);
       auto start_t = clock::now();
       plugin.plugin->after(*this);
       plugin.plugin_after_dt = clock::now() - start_t;
+      plugin.latency->record(plugin.plugin_after_dt.count());
     }
-    if(config.enable_log)
-    {
-      auto start_log_t = clock::now();
-      controller_->logger().log();
-      log_dt = clock::now() - start_log_t;
-    }
+    logRun(config.async_post_run);
+    post_run = config.async_post_run;
   }
   else
   {
@@ -859,23 +1173,202 @@ bool MCGlobalController::run()
     controller_run_dt.zero();
     solver_build_and_solve_t = 0;
     solver_solve_t = 0;
-    if(server_)
-    {
-      auto start_gui_t = clock::now();
-      server_->handle_requests(*controller_->gui_);
-      server_->publish(*controller_->gui_);
-      gui_dt = clock::now() - start_gui_t;
-    }
+    publishGUI(false);
     for(auto & plugin : plugins_after_always_) { plugin->after(*this); }
   }
   global_run_dt = clock::now() - start_run_t;
   // Percentage of time not spent inside the user code
   framework_cost = 100 * (1 - controller_run_dt.count() / global_run_dt.count());
+  recordLatency();
+  last_run_allocations_ = mc_rtc::AllocationTracker::allocations() - start_allocations;
+  if(config.track_allocations) { mc_rtc::AllocationTracker::stop(); }
+  handleAllocationsRequests();
+  // Commands are ready, send the serialized GUI state and log data while the interface waits for the next sensor data
+  if(post_run) { startPostRun(); }
   return running;
 }
 
+void MCGlobalController::handleAllocationsRequests()
+{
+  if(print_allocations_requested_.exchange(false))
+  {
+    mc_rtc::log::info("[MCGlobalController] Allocations in run():\n{}",
+                      mc_rtc::AllocationTracker::report().to_string());
+  }
+  if(reset_allocations_requested_.exchange(false)) { mc_rtc::AllocationTracker::reset(); }
+}
+
+void MCGlobalController::handleGUIRequests()
+{
+  gui_dt = duration_ms::zero();
+  if(!server_) { return; }
+  mc_rtc::AllocationTracker::Phase phase("Gui");
+  auto start_gui_t = clock::now();
+  server_->handle_requests(*controller_->gui_);
+  gui_dt = clock::now() - start_gui_t;
+}
+
+void MCGlobalController::publishGUI(bool deferSend)
+{
+  if(!server_) { return; }
+  mc_rtc::AllocationTracker::Phase phase("Gui");
+  auto start_gui_t = clock::now();
+  if(deferSend)
+  {
+    // Requests have been handled by handleGUIRequests() at the start of run()
+    server_->update(*controller_->gui_);
+    gui_dt += clock::now() - start_gui_t;
+  }
+  else
+  {
+    server_->handle_requests(*controller_->gui_);
+    server_->publish(*controller_->gui_);
+    gui_dt = clock::now() - start_gui_t;
+  }
+  gui_latency_->record(gui_dt.count());
+}
+
+void MCGlobalController::logRun(bool deferWrite)
+{
+  if(!config.enable_log) { return; }
+  mc_rtc::AllocationTracker::Phase phase("Log");
+  auto start_log_t = clock::now();
+  if(deferWrite) { controller_->logger().serialize(); }
+  else { controller_->logger().log(); }
+  log_dt = clock::now() - start_log_t;
+  log_latency_->record(log_dt.count());
+}
+
+void MCGlobalController::startPostRun()
+{
+  {
+    std::unique_lock<std::mutex> lck(post_run_mutex_);
+    post_run_requested_ = true;
+    post_run_pending_ = true;
+  }
+  post_run_cv_.notify_all();
+}
+
+void MCGlobalController::waitPostRun() const noexcept
+{
+  if(!post_run_pending_.load(std::memory_order_acquire)) { return; }
+  std::unique_lock<std::mutex> lck(post_run_mutex_);
+  post_run_cv_.wait(lck, [this]() { return !post_run_pending_.load(); });
+}
+
+void MCGlobalController::postRunLoop()
+{
+  std::unique_lock<std::mutex> lck(post_run_mutex_);
+  while(true)
+  {
+    post_run_cv_.wait(lck, [this]() { return post_run_requested_ || post_run_stop_; });
+    if(post_run_stop_) { break; }
+    post_run_requested_ = false;
+    lck.unlock();
+    // Only send data that run() serialized, the controller is not accessed here
+    if(server_) { server_->send(); }
+    if(config.enable_log) { controller_->logger().write(); }
+    lck.lock();
+    post_run_pending_ = false;
+    post_run_cv_.notify_all();
+  }
+}
+
+void MCGlobalController::recordLatency() noexcept
+{
+  auto & stats = latency_stats_;
+  double dt = global_run_dt.count();
+  global_run_latency_->record(dt);
+  stats.iterations++;
+  if(stats.deadline > 0 && dt > stats.deadline)
+  {
+    stats.deadline_misses++;
+    stats.consecutive_misses++;
+    stats.max_consecutive_misses = std::max(stats.max_consecutive_misses, stats.consecutive_misses);
+    stats.worst_overrun = std::max(stats.worst_overrun, dt - stats.deadline);
+  }
+  else { stats.consecutive_misses = 0; }
+  if(++latency_window_iter_ >= stats.window_size)
+  {
+    latency_rollover_ = true;
+    latency_window_iter_ = 0;
+  }
+}
+
+const std::array<double, 4> & MCGlobalController::PhaseLatency::lastWindowSummary() const noexcept
+{
+  if(!last_window_summary_valid_)
+  {
+    const auto & h = last_window;
+    last_window_summary_ = {h.percentile(50), h.percentile(99), h.percentile(99.9), h.max()};
+    last_window_summary_valid_ = true;
+  }
+  return last_window_summary_;
+}
+
+void MCGlobalController::PhaseLatency::rollover() noexcept
+{
+  std::swap(window, last_window);
+  window.reset();
+  last_window_summary_valid_ = false;
+}
+
+void MCGlobalController::addLatencyLogEntries(const std::string & phase, const PhaseLatency & latency, bool overwrite)
+{
+  const std::array<const char *, 4> suffixes = {"p50", "p99", "p999", "max"};
+  for(size_t i = 0; i < suffixes.size(); ++i)
+  {
+    auto name = fmt::format("perf_Latency_{}_{}", phase, suffixes[i]);
+    controller_->logger().addLogEntry(name, [&latency, i]() { return latency.lastWindowSummary()[i]; }, overwrite);
+  }
+}
+
+void MCGlobalController::resetLatencyStats() noexcept
+{
+  auto & stats = latency_stats_;
+  for(auto & p : stats.phases)
+  {
+    p.second.window.reset();
+    p.second.last_window.reset();
+    p.second.total.reset();
+    p.second.rollover();
+  }
+  stats.iterations = 0;
+  stats.deadline_misses = 0;
+  stats.consecutive_misses = 0;
+  stats.max_consecutive_misses = 0;
+  stats.worst_overrun = 0;
+  latency_window_iter_ = 0;
+  latency_rollover_ = false;
+}
+
+void MCGlobalController::printLatencyStats() const
+{
+  const auto & stats = latency_stats_;
+  std::string table = fmt::format("{:<40} {:>10} {:>10} {:>10} {:>10} {:>10}", "Phase [ms]", "p50", "p99", "p99.9",
+                                  "max", "samples");
+  for(const auto & p : stats.phases)
+  {
+    const auto & h = p.second.total;
+    if(h.count() == 0) { continue; }
+    table += fmt::format("\n{:<40} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f} {:>10}", p.first, h.percentile(50),
+                         h.percentile(99), h.percentile(99.9), h.max(), h.count());
+  }
+  mc_rtc::log::info("[MCGlobalController] Latency statistics for {} ({} iterations):\n{}", current_ctrl,
+                    stats.iterations, table);
+  if(stats.deadline > 0)
+  {
+    auto msg = fmt::format(
+        "[MCGlobalController] Deadline {:.3f}ms missed {} times (longest streak: {}, worst overrun: {:.3f}ms)",
+        stats.deadline, stats.deadline_misses, stats.max_consecutive_misses, stats.worst_overrun);
+    if(stats.deadline_misses) { mc_rtc::log::warning(msg); }
+    else { mc_rtc::log::info(msg); }
+  }
+}
+
 ControllerServer & MCGlobalController::server()
 {
+  waitPostRun();
   assert(server_);
   return *server_;
 }
@@ -884,6 +1377,7 @@ void MCGlobalController::setGripperTargetQ(const std::string & robot,
                                            const std::string & name,
                                            const std::vector<double> & q)
 {
+  waitPostRun();
   try
   {
     auto & gripper = controller_->gripper(robot, name);
@@ -897,12 +1391,14 @@ void MCGlobalController::setGripperTargetQ(const std::string & robot,
 
 void MCGlobalController::setGripperOpenPercent(const std::string & robot, double pOpen)
 {
+  waitPostRun();
   auto & r = controller_->robots().robot(robot);
   for(auto & g : r.grippers()) { g.get().setTargetOpening(pOpen); }
 }
 
 void MCGlobalController::setGripperOpenPercent(const std::string & robot, const std::string & name, double pOpen)
 {
+  waitPostRun();
   try
   {
     auto & gripper = controller_->gripper(robot, name);
@@ -931,6 +1427,15 @@ bool MCGlobalController::AddController(const std::string & name)
     mc_rtc::log::warning("Controller {} already enabled", name);
     return false;
   }
+  auto controller = createController(name, config.controllers_configs[name]);
+  if(!controller) { return false; }
+  controllers[name] = controller;
+  return true;
+}
+
+std::shared_ptr<MCController> MCGlobalController::createController(const std::string & name,
+                                                                   const mc_rtc::Configuration & ctl_config)
+{
   std::string controller_name = name;
   std::string controller_subname = "";
   size_t sep_pos = name.find('#');
@@ -947,31 +1452,69 @@ bool MCGlobalController::AddController(const std::string & name)
   if(controller_loader->has_object(controller_name))
   {
     mc_rtc::log::info("Create controller {}", controller_name);
+    std::shared_ptr<MCController> controller;
     if(controller_subname != "")
     {
-      controllers[name] =
-          controller_loader->create_object(controller_name, controller_subname, config.main_robot_module,
-                                           config.timestep, config.controllers_configs[name]);
-    }
-    else
-    {
-      controllers[name] = controller_loader->create_object(name, config.main_robot_module, config.timestep,
-                                                           config.controllers_configs[name]);
-    }
-    controllers[name]->datastore().make_call("Global::EnableController",
-                                             [this](const std::string & name) { return EnableController(name); });
-    if(config.enable_log)
-    {
-      controllers[name]->logger().setup(config.log_policy, config.log_directory, config.log_template);
+      controller = controller_loader->create_object(controller_name, controller_subname, config.main_robot_module,
+                                                    config.timestep, ctl_config);
     }
-    controllers[name]->createObserverPipelines(config.controllers_configs[name]);
-    return true;
+    else { controller = controller_loader->create_object(name, config.main_robot_module, config.timestep, ctl_config); }
+    controller->datastore().make_call("Global::EnableController",
+                                      [this](const std::string & name) { return EnableController(name); });
+    if(config.enable_log) { controller->logger().setup(config.log_policy, config.log_directory, config.log_template); }
+    controller->createObserverPipelines(ctl_config);
+    return controller;
   }
   else
   {
     mc_rtc::log::warning("Controller {} enabled in configuration but not available", name);
-    return false;
+    return nullptr;
+  }
+}
+
+std::vector<std::shared_ptr<MCController>> MCGlobalController::createControllers(
+    const std::vector<std::pair<std::string, mc_rtc::Configuration>> & ctls)
+{
+  std::vector<std::shared_ptr<MCController>> out(ctls.size());
+  auto errors = parallelFor(ctls.size(), config.parallel_controllers_creation,
+                            [&](size_t i) { out[i] = createController(ctls[i].first, ctls[i].second); });
+  for(const auto & e : errors)
+  {
+    if(e) { std::rethrow_exception(e); }
+  }
+  return out;
+}
+
+void MCGlobalController::adoptLazyControllers()
+{
+  if(!lazy_controllers_has_ready_.load(std::memory_order_acquire)) { return; }
+  decltype(lazy_controllers_ready_) ready;
+  {
+    std::unique_lock<std::mutex> lck(lazy_controllers_mutex_);
+    std::swap(ready, lazy_controllers_ready_);
+    lazy_controllers_has_ready_ = false;
+  }
+  for(const auto & c : ready)
+  {
+    const auto & name = c.first;
+    lazy_controllers_pending_.erase(std::remove(lazy_controllers_pending_.begin(), lazy_controllers_pending_.end(), name),
+                                    lazy_controllers_pending_.end());
+    if(c.second) { controllers[name] = c.second; }
+    if(name != next_ctrl || name == current_ctrl) { continue; }
+    if(c.second) { next_controller_ = c.second.get(); }
+    else
+    {
+      mc_rtc::log::error("{} controller could not be created, {} remains active", name, current_ctrl);
+      next_ctrl = current_ctrl;
+    }
   }
+  if(lazy_controllers_pending_.empty() && lazy_controllers_thread_.joinable()) { lazy_controllers_thread_.join(); }
+}
+
+void MCGlobalController::waitLazyControllers()
+{
+  if(lazy_controllers_thread_.joinable()) { lazy_controllers_thread_.join(); }
+  adoptLazyControllers();
 }
 
 const MCGlobalController::GlobalConfiguration & MCGlobalController::configuration() const
@@ -986,6 +1529,7 @@ void MCGlobalController::add_controller_module_paths(const std::vector<std::stri
 
 bool MCGlobalController::AddController(const std::string & name, std::shared_ptr<mc_control::MCController> controller)
 {
+  waitPostRun();
   if(controllers.count(name) || !controller)
   {
     mc_rtc::log::warning("Controller {} already enabled or invalid pointer passed", name);
@@ -1001,12 +1545,21 @@ bool MCGlobalController::AddController(const std::string & name, std::shared_ptr
 
 bool MCGlobalController::EnableController(const std::string & name)
 {
+  waitPostRun();
   if(name != current_ctrl && controllers.count(name))
   {
     next_ctrl = name;
     next_controller_ = controllers[name].get();
     return true;
   }
+  else if(std::find(lazy_controllers_pending_.begin(), lazy_controllers_pending_.end(), name)
+          != lazy_controllers_pending_.end())
+  {
+    mc_rtc::log::info("{} controller is still being created, it will be enabled once ready", name);
+    next_ctrl = name;
+    next_controller_ = nullptr;
+    return true;
+  }
   else
   {
     if(name == current_ctrl) { mc_rtc::log::error("{} controller already enabled.", name); }
@@ -1031,6 +1584,7 @@ void MCGlobalController::start_log()
 
 void MCGlobalController::refreshLog()
 {
+  waitPostRun();
   controller_->logger().start(current_ctrl, controller_->timeStep, true);
   setup_log();
 }
@@ -1057,11 +1611,18 @@ void MCGlobalController::setup_log()
   controller->logger().addLogEntry("perf_GlobalRun", [this]() { return global_run_dt.count(); });
   controller->logger().addLogEntry("perf_ControllerRun", [this]() { return controller_run_dt.count(); });
   controller->logger().addLogEntry("perf_ObserversRun", [this]() { return observers_run_dt.count(); });
+  controller->logger().addLogEntry("perf_Conversion", [this]() { return conversion_dt.count(); });
   controller->logger().addLogEntry("perf_SolverBuildAndSolve", [this]() { return solver_build_and_solve_t; });
   controller->logger().addLogEntry("perf_SolverSolve", [this]() { return solver_solve_t; });
   controller->logger().addLogEntry("perf_Log", [this]() { return log_dt.count(); });
   controller->logger().addLogEntry("perf_Gui", [this]() { return gui_dt.count(); });
   controller->logger().addLogEntry("perf_FrameworkCost", [this]() { return framework_cost; });
+  controller->logger().addLogEntry("perf_DeadlineMisses", [this]() { return latency_stats_.deadline_misses; });
+  for(const auto & p : latency_stats_.phases) { addLatencyLogEntries(p.first, p.second, true); }
+  if(config.track_allocations)
+  {
+    controller->logger().addLogEntry("perf_Allocations", [this]() { return last_run_allocations_; });
+  }
   // Log system wall time as nanoseconds since epoch (can be used to manage synchronization with ros)
   controller->logger().addLogEntry("timeWall",
                                    []() -> int64_t
@@ -1088,12 +1649,14 @@ GlobalPlugin * MCGlobalController::loadPlugin(const std::string & name, const ch
     const auto & plugin_config = plugins_.back().plugin->configuration();
     if(plugin_config.should_run_before)
     {
-      plugins_before_.push_back({plugin, duration_ms{0}});
+      auto & latency = *latency_stats_.phases.try_emplace(fmt::format("Plugins_{}_before", name)).first;
+      plugins_before_.push_back({plugin, duration_ms{0}, &latency.second, latency.first.c_str()});
       if(plugin_config.should_always_run) { plugins_before_always_.push_back(plugin); }
     }
     if(plugin_config.should_run_after)
     {
-      plugins_after_.push_back({plugin, duration_ms{0}});
+      auto & latency = *latency_stats_.phases.try_emplace(fmt::format("Plugins_{}_after", name)).first;
+      plugins_after_.push_back({plugin, duration_ms{0}, &latency.second, latency.first.c_str()});
       if(plugin_config.should_always_run) { plugins_after_always_.push_back(plugin); }
     }
     return plugin;
@@ -1171,12 +1734,15 @@ void MCGlobalController::setup_plugin_log()
     const auto & name = getPluginName(plugin.plugin);
     controller_->logger().addLogEntry(
         fmt::format("perf_Plugins_{}_before", name), [&plugin]() { return plugin.plugin_before_dt.count(); }, true);
+    // Controller plugins are loaded after setup_log()
+    addLatencyLogEntries(plugin.phase, *plugin.latency, true);
   }
   for(const auto & plugin : plugins_after_)
   {
     const auto & name = getPluginName(plugin.plugin);
     controller_->logger().addLogEntry(
         fmt::format("perf_Plugins_{}_after", name), [&plugin]() { return plugin.plugin_after_dt.count(); }, true);
+    addLatencyLogEntries(plugin.phase, *plugin.latency, true);
   }
 }
 
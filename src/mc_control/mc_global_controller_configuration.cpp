@@ -61,6 +61,7 @@ MCGlobalController::GlobalConfiguration::GlobalConfiguration(const std::string &
   //  Robots  //
   //////////////
   mc_rbdyn::RobotLoader::set_verbosity(verbose_loader);
+  if(config("RobotModuleBundles", false)) { mc_rbdyn::RobotLoader::enable_bundles(); }
   config("RobotModulePaths", robot_module_paths);
   if(config("ClearRobotModulePath", false)) { mc_rbdyn::RobotLoader::clear(); }
   if(robot_module_paths.size())
@@ -194,6 +195,8 @@ MCGlobalController::GlobalConfiguration::GlobalConfiguration(const std::string &
   else { mc_rtc::log::error_and_throw("Enabled entry in mc_rtc must contain at least one controller name"); }
   config("Default", initial_controller);
   config("IncludeHalfSitController", include_halfsit_controller);
+  config("ParallelControllersCreation", parallel_controllers_creation);
+  config("LazyControllersCreation", lazy_controllers_creation);
 
   ////////////////////
   // Initialization //
@@ -201,6 +204,13 @@ MCGlobalController::GlobalConfiguration::GlobalConfiguration(const std::string &
   config("InitAttitudeFromSensor", init_attitude_from_sensor);
   config("InitAttitudeSensor", init_attitude_sensor);
 
+  //////////////////////////
+  //  Latency statistics  //
+  //////////////////////////
+  config("LatencyDeadline", latency_deadline);
+  config("LatencyWindow", latency_window);
+  config("TrackAllocations", track_allocations);
+
   ///////////////
   //  Logging  //
   ///////////////
@@ -223,6 +233,7 @@ MCGlobalController::GlobalConfiguration::GlobalConfiguration(const std::string &
     if(v.size()) { log_directory = v; }
   }
   config("LogTemplate", log_template);
+  config("AsyncPostRun", async_post_run);
 
   /////////////////////////
   //  GUI server options //
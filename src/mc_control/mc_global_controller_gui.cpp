@@ -4,10 +4,12 @@
 
 #include <mc_control/mc_global_controller.h>
 
+#include <mc_rtc/AllocationTracker.h>
 #include <mc_rtc/gui/Button.h>
 #include <mc_rtc/gui/Form.h>
 #include <mc_rtc/gui/Label.h>
 #include <mc_rtc/gui/NumberInput.h>
+#include <mc_rtc/gui/Table.h>
 
 /** This file implements GUI elements related to the global controller instance
  *  and available for each controller */
@@ -81,6 +83,55 @@ void MCGlobalController::initGUI()
         }
       }
     }
+    gui->removeCategory({"Global", "Performance"});
+    gui->addElement({"Global", "Performance"},
+                    mc_rtc::gui::Label("Deadline [ms]", [this]() { return latency_stats_.deadline; }),
+                    mc_rtc::gui::Label("Deadline misses", [this]() { return latency_stats_.deadline_misses; }),
+                    mc_rtc::gui::Label("Longest miss streak",
+                                       [this]() { return latency_stats_.max_consecutive_misses; }),
+                    mc_rtc::gui::Label("Worst overrun [ms]", [this]() { return latency_stats_.worst_overrun; }),
+                    mc_rtc::gui::Button("Reset statistics", [this]() { resetLatencyStats(); }),
+                    mc_rtc::gui::Table("Latency (last window)", {"Phase", "p50", "p99", "p99.9", "max"},
+                                       {"{}", "{:.3f}", "{:.3f}", "{:.3f}", "{:.3f}"},
+                                       [this]()
+                                       {
+                                         std::vector<std::tuple<std::string, double, double, double, double>> data;
+                                         for(const auto & p : latency_stats_.phases)
+                                         {
+                                           if(p.second.last_window.count() == 0) { continue; }
+                                           const auto & summary = p.second.lastWindowSummary();
+                                           data.emplace_back(p.first, summary[0], summary[1], summary[2],
+                                                             summary[3]);
+                                         }
+                                         return data;
+                                       }));
+    if(config.track_allocations)
+    {
+      gui->addElement(
+          {"Global", "Performance", "Allocations"},
+          mc_rtc::gui::Label("Last run", [this]() { return last_run_allocations_; }),
+          mc_rtc::gui::Label("Since reset", []() { return mc_rtc::AllocationTracker::allocations(); }),
+          // The tracker is reset and the report is printed by run() between two iterations
+          mc_rtc::gui::Button("Reset", [this]() { reset_allocations_requested_ = true; }),
+          mc_rtc::gui::Button("Print report", [this]() { print_allocations_requested_ = true; }),
+          mc_rtc::gui::Table("Allocations per phase", {"Phase", "Allocations"}, {"{}", "{}"},
+                             []()
+                             {
+                               mc_rtc::AllocationTracker::Pause pause;
+                               std::vector<std::tuple<std::string, uint64_t>> data;
+                               for(const auto & p : mc_rtc::AllocationTracker::report(false).phases)
+                               {
+                                 data.emplace_back(p.first, p.second);
+                               }
+                               return data;
+                             }));
+      if(config.async_post_run)
+      {
+        gui->addElement({"Global", "Performance", "Allocations"},
+                        mc_rtc::gui::Label("Not tracked",
+                                           []() -> std::string { return "GUI send and log write (post-run thread)"; }));
+      }
+    }
     gui->removeCategory({"Global", "Change controller"});
     gui->addElement({"Global", "Change controller"},
                     mc_rtc::gui::Label("Current controller", [this]() { return current_ctrl; }),
@@ -134,8 +134,11 @@ void EncoderObserver::update(mc_control::MCController & ctl)
       }
     }
   }
-  if(computeFK_ && posUpdate_ != PosUpdate::None) { realRobot.forwardKinematics(); }
-  if(computeFV_ && velUpdate_ != VelUpdate::None) { realRobot.forwardVelocity(); }
+  bool fk = computeFK_ && posUpdate_ != PosUpdate::None;
+  bool fv = computeFV_ && velUpdate_ != VelUpdate::None;
+  if(fk && fv) { realRobot.forwardAll(mc_rbdyn::Robot::ForwardOrder::Velocity); }
+  else if(fk) { realRobot.forwardKinematics(); }
+  else if(fv) { realRobot.forwardVelocity(); }
 }
 
 void EncoderObserver::addToLogger(const mc_control::MCController & ctl,
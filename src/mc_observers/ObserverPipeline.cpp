@@ -133,6 +133,9 @@ bool ObserverPipeline::run()
   for(auto & pipelineObserver : pipelineObservers_)
   {
     auto & observer = pipelineObserver.observer();
+    // Observers read the robots' mbc directly and the previous observer may have updated the real robots
+    ctl_.robots().updateKinematics();
+    ctl_.realRobots().updateKinematics();
     bool res = observer.run(ctl_);
     if(!res)
     {
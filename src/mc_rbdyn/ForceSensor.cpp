@@ -159,7 +159,7 @@ const sva::ForceVecd & ForceSensor::offset() const
 
 sva::ForceVecd ForceSensor::wrenchWithoutGravity(const mc_rbdyn::Robot & robot) const
 {
-  sva::PTransformd X_0_p = robot.mbc().bodyPosW[robot.bodyIndexByName(parent_)];
+  sva::PTransformd X_0_p = robot.bodyPosW(parent_);
   auto w = wrench_ - calibration_.wfToSensor(X_0_p, X_p_s_);
   return w;
 }
@@ -167,7 +167,7 @@ sva::ForceVecd ForceSensor::wrenchWithoutGravity(const mc_rbdyn::Robot & robot)
 sva::ForceVecd ForceSensor::worldWrench(const mc_rbdyn::Robot & robot) const
 {
   sva::ForceVecd w_fsactual = wrench();
-  sva::PTransformd X_parent_0 = robot.mbc().bodyPosW[robot.bodyIndexByName(parent_)].inv();
+  sva::PTransformd X_parent_0 = robot.bodyPosW(parent_).inv();
   sva::PTransformd X_fsactual_0 = X_parent_0 * X_fsactual_parent();
   return X_fsactual_0.dualMul(w_fsactual);
 }
@@ -175,7 +175,7 @@ sva::ForceVecd ForceSensor::worldWrench(const mc_rbdyn::Robot & robot) const
 sva::ForceVecd ForceSensor::worldWrenchWithoutGravity(const mc_rbdyn::Robot & robot) const
 {
   sva::ForceVecd w_fsactual = wrenchWithoutGravity(robot);
-  sva::PTransformd X_parent_0 = robot.mbc().bodyPosW[robot.bodyIndexByName(parent_)].inv();
+  sva::PTransformd X_parent_0 = robot.bodyPosW(parent_).inv();
   sva::PTransformd X_fsactual_0 = X_parent_0 * X_fsactual_parent();
   return X_fsactual_0.dualMul(w_fsactual);
 }
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rbdyn/GeometryCache.h>
+#include <mc_rbdyn/SCHAddon.h>
+#include <mc_rbdyn/surface_utils.h>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+namespace bfs = boost::filesystem;
+
+namespace mc_rbdyn
+{
+
+namespace
+{
+
+/** Identifies the version of a file on disk */
+struct FileStamp
+{
+  bool valid = false;
+  std::time_t mtime = 0;
+  uintmax_t size = 0;
+
+  bool operator==(const FileStamp & other) const noexcept
+  {
+    return valid && other.valid && mtime == other.mtime && size == other.size;
+  }
+};
+
+FileStamp stamp(const bfs::path & path)
+{
+  boost::system::error_code ec;
+  FileStamp out;
+  out.mtime = bfs::last_write_time(path, ec);
+  if(ec) { return {}; }
+  out.size = bfs::file_size(path, ec);
+  if(ec) { return {}; }
+  out.valid = true;
+  return out;
+}
+
+using RSDFFiles = std::vector<std::pair<std::string, FileStamp>>;
+
+/** List the RSDF files in a directory (sorted) */
+RSDFFiles rsdfFiles(const bfs::path & dir)
+{
+  RSDFFiles out;
+  boost::system::error_code ec;
+  for(bfs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+  {
+    if(it->path().extension() == ".rsdf") { out.push_back({it->path().string(), stamp(it->path())}); }
+  }
+  std::sort(out.begin(), out.end(), [](const auto & lhs, const auto & rhs) { return lhs.first < rhs.first; });
+  return out;
+}
+
+bool sameFiles(const RSDFFiles & lhs, const RSDFFiles & rhs)
+{
+  if(lhs.size() != rhs.size()) { return false; }
+  for(size_t i = 0; i < lhs.size(); ++i)
+  {
+    if(lhs[i].first != rhs[i].first || !(lhs[i].second == rhs[i].second)) { return false; }
+  }
+  return true;
+}
+
+struct PolyhedronEntry
+{
+  FileStamp stamp;
+  std::shared_ptr<const sch::S_Polyhedron> polyhedron;
+};
+
+struct RSDFEntry
+{
+  RSDFFiles files;
+  std::vector<SurfacePtr> surfaces;
+};
+
+struct Cache
+{
+  std::mutex mtx;
+  std::unordered_map<std::string, PolyhedronEntry> polyhedrons;
+  std::unordered_map<std::string, RSDFEntry> rsdfs;
+};
+
+Cache & cache()
+{
+  static Cache cache;
+  return cache;
+}
+
+/** Use the canonical path as a key so that different paths to the same file share an entry */
+std::string cacheKey(const std::string & path)
+{
+  boost::system::error_code ec;
+  auto canonical = bfs::canonical(path, ec);
+  if(ec) { return path; }
+  return canonical.string();
+}
+
+std::vector<SurfacePtr> copySurfaces(const std::vector<SurfacePtr> & surfaces)
+{
+  std::vector<SurfacePtr> out;
+  out.reserve(surfaces.size());
+  for(const auto & s : surfaces) { out.push_back(s->copy()); }
+  return out;
+}
+
+} // namespace
+
+std::shared_ptr<sch::S_Polyhedron> GeometryCache::polyhedron(const std::string & path)
+{
+  auto key = cacheKey(path);
+  auto file_stamp = stamp(key);
+  auto & c = cache();
+  {
+    std::unique_lock<std::mutex> lck(c.mtx);
+    auto it = c.polyhedrons.find(key);
+    if(it != c.polyhedrons.end() && it->second.stamp == file_stamp)
+    {
+      return std::make_shared<sch::S_Polyhedron>(*it->second.polyhedron);
+    }
+  }
+  // Parsing happens outside of the lock, concurrent requests for the same file may both parse it
+  std::shared_ptr<const sch::S_Polyhedron> poly(sch::mc_rbdyn::Polyhedron(path));
+  if(file_stamp.valid)
+  {
+    std::unique_lock<std::mutex> lck(c.mtx);
+    c.polyhedrons[key] = {file_stamp, poly};
+  }
+  return std::make_shared<sch::S_Polyhedron>(*poly);
+}
+
+std::vector<SurfacePtr> GeometryCache::rsdf(const std::string & dirname)
+{
+  auto key = cacheKey(dirname);
+  auto files = rsdfFiles(key);
+  auto & c = cache();
+  {
+    std::unique_lock<std::mutex> lck(c.mtx);
+    auto it = c.rsdfs.find(key);
+    if(it != c.rsdfs.end() && sameFiles(it->second.files, files)) { return copySurfaces(it->second.surfaces); }
+  }
+  auto surfaces = readRSDFFromDir(dirname);
+  {
+    std::unique_lock<std::mutex> lck(c.mtx);
+    c.rsdfs[key] = {files, surfaces};
+  }
+  return copySurfaces(surfaces);
+}
+
+size_t GeometryCache::size() noexcept
+{
+  auto & c = cache();
+  std::unique_lock<std::mutex> lck(c.mtx);
+  return c.polyhedrons.size() + c.rsdfs.size();
+}
+
+void GeometryCache::clear() noexcept
+{
+  auto & c = cache();
+  std::unique_lock<std::mutex> lck(c.mtx);
+  c.polyhedrons.clear();
+  c.rsdfs.clear();
+}
+
+} // namespace mc_rbdyn
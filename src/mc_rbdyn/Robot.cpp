@@ -2,6 +2,7 @@
  * Copyright 2015-2022 CNRS-UM LIRMM, CNRS-AIST JRL
  */
 
+#include <mc_rbdyn/GeometryCache.h>
 #include <mc_rbdyn/Robot.h>
 #include <mc_rbdyn/RobotModule.h>
 #include <mc_rbdyn/Robots.h>
@@ -9,6 +10,7 @@
 #include <mc_rbdyn/Surface.h>
 #include <mc_rbdyn/ZMP.h>
 #include <mc_rbdyn/surface_utils.h>
+#include <mc_rtc/WorkerPool.h>
 #include <mc_rtc/constants.h>
 #include <mc_rtc/logging.h>
 #include <mc_rtc/pragma.h>
@@ -28,6 +30,7 @@
 #include <boost/filesystem.hpp>
 namespace bfs = boost::filesystem;
 
+#include <cassert>
 #include <fstream>
 #include <tuple>
 
@@ -145,7 +148,7 @@ torqueDerivativeBounds_t torqueDerivative_bounds(const rbd::MultiBody & mb, cons
 template<typename schT, typename mapT>
 void loadSCH(const mc_rbdyn::Robot & robot,
              const std::map<std::string, std::pair<std::string, std::string>> & urls,
-             schT * (*sch_load_fn)(const std::string &),
+             std::shared_ptr<schT> (*sch_load_fn)(const std::string &),
              mapT & data_,
              std::map<std::string, sva::PTransformd> & cTfs)
 {
@@ -156,7 +159,7 @@ void loadSCH(const mc_rbdyn::Robot & robot,
     const std::string & cHURL = cH.second.second;
     if(robot.hasBody(parent))
     {
-      auto poly = std::shared_ptr<schT>(sch_load_fn(cHURL));
+      auto poly = sch_load_fn(cHURL);
       sch::mc_rbdyn::transform(*poly, robot.bodyPosW()[robot.bodyIndexByName(parent)]);
       data_[cHName] = {parent, poly};
       cTfs[cHName] = sva::PTransformd::Identity();
@@ -238,6 +241,98 @@ bool VisualToConvex(const std::string & robot,
   return true;
 }
 
+/** Forward kinematics of joint \p i, the predecessor of the joint must be up-to-date */
+inline void forwardJointKinematics(const rbd::MultiBody & mb, rbd::MultiBodyConfig & mbc, size_t i)
+{
+  auto p = mb.predecessors()[i];
+  auto s = static_cast<size_t>(mb.successors()[i]);
+  mbc.jointConfig[i] = mb.joints()[i].pose(mbc.q[i]);
+  const auto & X_p_i = mbc.parentToSon[i] = mbc.jointConfig[i] * mb.transform(static_cast<int>(i));
+  if(p != -1) { mbc.bodyPosW[s] = X_p_i * mbc.bodyPosW[static_cast<size_t>(p)]; }
+  else { mbc.bodyPosW[s] = X_p_i; }
+}
+
+/** Forward velocity of joint \p i, the predecessor of the joint must be up-to-date */
+inline void forwardJointVelocity(const rbd::MultiBody & mb, rbd::MultiBodyConfig & mbc, size_t i)
+{
+  auto p = mb.predecessors()[i];
+  auto s = static_cast<size_t>(mb.successors()[i]);
+  const auto & X_p_i = mbc.parentToSon[i];
+  mbc.jointVelocity[i] = mb.joints()[i].motion(mbc.alpha[i]);
+  if(p != -1) { mbc.bodyVelB[s] = X_p_i * mbc.bodyVelB[static_cast<size_t>(p)] + mbc.jointVelocity[i]; }
+  else { mbc.bodyVelB[s] = mbc.jointVelocity[i]; }
+  mbc.bodyVelW[s] = sva::PTransformd(mbc.bodyPosW[s].rotation()).invMul(mbc.bodyVelB[s]);
+}
+
+/** Forward acceleration of joint \p i, the predecessor of the joint must be up-to-date */
+inline void forwardJointAcceleration(const rbd::MultiBody & mb,
+                                     rbd::MultiBodyConfig & mbc,
+                                     size_t i,
+                                     const sva::MotionVecd & A_0)
+{
+  auto p = mb.predecessors()[i];
+  auto s = static_cast<size_t>(mb.successors()[i]);
+  const auto & X_p_i = mbc.parentToSon[i];
+  const auto & vb_i = mbc.bodyVelB[s];
+  auto ai = mb.joints()[i].tanAccel(mbc.alphaD[i]) + vb_i.cross(mbc.jointVelocity[i]);
+  if(p != -1) { mbc.bodyAccB[s] = X_p_i * mbc.bodyAccB[static_cast<size_t>(p)] + ai; }
+  else { mbc.bodyAccB[s] = X_p_i * A_0 + ai; }
+}
+
+/** Forward kinematics, velocity (if Velocity) and acceleration (if Acceleration) in a single sweep over the joints
+ *
+ * This computes the same quantities as rbd::forwardKinematics, rbd::forwardVelocity and rbd::forwardAcceleration
+ */
+template<bool Velocity, bool Acceleration>
+void forwardAll(const rbd::MultiBody & mb, rbd::MultiBodyConfig & mbc, const sva::MotionVecd & A_0)
+{
+  static_assert(Velocity || !Acceleration, "Forward acceleration requires forward velocity");
+  for(size_t i = 0; i < mb.joints().size(); ++i)
+  {
+    forwardJointKinematics(mb, mbc, i);
+    if constexpr(Velocity) { forwardJointVelocity(mb, mbc, i); }
+    if constexpr(Acceleration) { forwardJointAcceleration(mb, mbc, i, A_0); }
+  }
+}
+
+/** Bits of mc_rbdyn::Robot::kinematicsValid_ */
+constexpr uint8_t KINEMATICS_VALID = 1;
+constexpr uint8_t VELOCITY_VALID = 2;
+constexpr uint8_t ACCELERATION_VALID = 4;
+
+/** Quantities computed by a given order */
+uint8_t orderMask(mc_rbdyn::Robot::ForwardOrder order)
+{
+  switch(order)
+  {
+    case mc_rbdyn::Robot::ForwardOrder::Kinematics:
+      return KINEMATICS_VALID;
+    case mc_rbdyn::Robot::ForwardOrder::Velocity:
+      return KINEMATICS_VALID | VELOCITY_VALID;
+    case mc_rbdyn::Robot::ForwardOrder::Acceleration:
+    default:
+      return KINEMATICS_VALID | VELOCITY_VALID | ACCELERATION_VALID;
+  }
+}
+
+/** Compute the quantities in \p need that are not in \p valid for joint \p i (and its successor body)
+ *
+ * The quantities are computed in order (kinematics, velocity, acceleration), the predecessor must be up-to-date
+ */
+void forwardJointLazy(const rbd::MultiBody & mb,
+                      rbd::MultiBodyConfig & mbc,
+                      size_t i,
+                      uint8_t need,
+                      uint8_t & valid,
+                      const sva::MotionVecd & A_0)
+{
+  auto missing = static_cast<uint8_t>(need & ~valid);
+  if(missing & KINEMATICS_VALID) { forwardJointKinematics(mb, mbc, i); }
+  if(missing & VELOCITY_VALID) { forwardJointVelocity(mb, mbc, i); }
+  if(missing & ACCELERATION_VALID) { forwardJointAcceleration(mb, mbc, i, A_0); }
+  valid |= missing;
+}
+
 } // namespace
 
 namespace mc_rbdyn
@@ -261,11 +356,13 @@ Robot::Robot(NewRobotToken,
   data_->robots.push_back(this);
   const auto & module_ = module();
 
+  // The graph is only read here, access it directly to keep it shared with other copies
+  auto & mbg_ = *robots_->mbgs_[robots_idx_];
   sva::PTransformd base_tf = params.base_tf_.value_or(sva::PTransformd::Identity());
   std::string base_name = params.base_.value_or(mb().body(0).name());
   if(params.base_tf_ || params.base_)
   {
-    mb() = mbg().makeMultiBody(base_name, mb().joint(0).type() == rbd::Joint::Fixed, base_tf);
+    mb() = mbg_.makeMultiBody(base_name, mb().joint(0).type() == rbd::Joint::Fixed, base_tf);
     mbc() = rbd::MultiBodyConfig(mb());
   }
 
@@ -301,7 +398,7 @@ Robot::Robot(NewRobotToken,
   for(const auto & b : mb().bodies()) { mass_ += b.inertia().mass(); }
 
   bodyTransforms_.resize(mb().bodies().size());
-  const auto & bbts = mbg().bodiesBaseTransform(base_name, base_tf);
+  const auto & bbts = mbg_.bodiesBaseTransform(base_name, base_tf);
   for(size_t i = 0; i < mb().bodies().size(); ++i)
   {
     const auto & b = mb().body(static_cast<int>(i));
@@ -345,7 +442,7 @@ Robot::Robot(NewRobotToken,
 
   if(loadFiles)
   {
-    loadSCH(*this, module_.convexHull(), &sch::mc_rbdyn::Polyhedron, convexes_, collisionTransforms_);
+    loadSCH(*this, module_.convexHull(), &GeometryCache::polyhedron, convexes_, collisionTransforms_);
     for(const auto & c : module_._collision)
     {
       const auto & body = c.first;
@@ -614,11 +711,14 @@ const rbd::MultiBodyConfig & Robot::mbc() const
 
 rbd::MultiBodyGraph & Robot::mbg()
 {
-  return robots_->mbgs_[robots_idx_];
+  auto & mbg = robots_->mbgs_[robots_idx_];
+  // Copy-on-write: the graph might be shared with copies of this robot
+  if(mbg.use_count() > 1) { mbg = std::make_shared<rbd::MultiBodyGraph>(*mbg); }
+  return *mbg;
 }
 const rbd::MultiBodyGraph & Robot::mbg() const
 {
-  return robots_->mbgs_[robots_idx_];
+  return *robots_->mbgs_[robots_idx_];
 }
 
 const std::vector<std::vector<double>> & Robot::q() const
@@ -639,18 +739,22 @@ const std::vector<std::vector<double>> & Robot::jointTorque() const
 }
 const std::vector<sva::PTransformd> & Robot::bodyPosW() const
 {
+  updateKinematics(ForwardOrder::Kinematics);
   return mbc().bodyPosW;
 }
 const std::vector<sva::MotionVecd> & Robot::bodyVelW() const
 {
+  updateKinematics(ForwardOrder::Velocity);
   return mbc().bodyVelW;
 }
 const std::vector<sva::MotionVecd> & Robot::bodyVelB() const
 {
+  updateKinematics(ForwardOrder::Velocity);
   return mbc().bodyVelB;
 }
 const std::vector<sva::MotionVecd> & Robot::bodyAccB() const
 {
+  updateKinematics(ForwardOrder::Acceleration);
   return mbc().bodyAccB;
 }
 std::vector<std::vector<double>> & Robot::q()
@@ -671,56 +775,71 @@ std::vector<std::vector<double>> & Robot::jointTorque()
 }
 std::vector<sva::PTransformd> & Robot::bodyPosW()
 {
+  updateKinematics(ForwardOrder::Kinematics);
   return mbc().bodyPosW;
 }
 std::vector<sva::MotionVecd> & Robot::bodyVelW()
 {
+  updateKinematics(ForwardOrder::Velocity);
   return mbc().bodyVelW;
 }
 std::vector<sva::MotionVecd> & Robot::bodyVelB()
 {
+  updateKinematics(ForwardOrder::Velocity);
   return mbc().bodyVelB;
 }
 std::vector<sva::MotionVecd> & Robot::bodyAccB()
 {
+  updateKinematics(ForwardOrder::Acceleration);
   return mbc().bodyAccB;
 }
 
 const sva::PTransformd & Robot::bodyPosW(const std::string & name) const
 {
-  return bodyPosW()[bodyIndexByName(name)];
+  auto idx = bodyIndexByName(name);
+  updateKinematics(idx, ForwardOrder::Kinematics);
+  return mbc().bodyPosW[idx];
 }
 
 sva::PTransformd Robot::X_b1_b2(const std::string & b1, const std::string & b2) const
 {
-  return bodyPosW()[bodyIndexByName(b2)] * bodyPosW()[bodyIndexByName(b1)].inv();
+  return bodyPosW(b2) * bodyPosW(b1).inv();
 }
 
 const sva::MotionVecd & Robot::bodyVelW(const std::string & name) const
 {
-  return bodyVelW()[bodyIndexByName(name)];
+  auto idx = bodyIndexByName(name);
+  updateKinematics(idx, ForwardOrder::Velocity);
+  return mbc().bodyVelW[idx];
 }
 
 const sva::MotionVecd & Robot::bodyVelB(const std::string & name) const
 {
-  return bodyVelB()[bodyIndexByName(name)];
+  auto idx = bodyIndexByName(name);
+  updateKinematics(idx, ForwardOrder::Velocity);
+  return mbc().bodyVelB[idx];
 }
 
 const sva::MotionVecd & Robot::bodyAccB(const std::string & name) const
 {
-  return bodyAccB()[bodyIndexByName(name)];
+  auto idx = bodyIndexByName(name);
+  updateKinematics(idx, ForwardOrder::Acceleration);
+  return mbc().bodyAccB[idx];
 }
 
 Eigen::Vector3d Robot::com() const
 {
+  updateKinematics(ForwardOrder::Kinematics);
   return rbd::computeCoM(mb(), mbc());
 }
 Eigen::Vector3d Robot::comVelocity() const
 {
+  updateKinematics(ForwardOrder::Velocity);
   return rbd::computeCoMVelocity(mb(), mbc());
 }
 Eigen::Vector3d Robot::comAcceleration() const
 {
+  updateKinematics(ForwardOrder::Acceleration);
   return rbd::computeCoMAcceleration(mb(), mbc());
 }
 
@@ -1054,11 +1173,13 @@ const Robot::convex_pair_t & Robot::convex(const std::string & cName) const
   {
     mc_rtc::log::error_and_throw("No convex named {} found in robot {}", cName, this->name_);
   }
+  if(lazyKinematics_) { updateLazyConvexes(); }
   return convexes_.at(cName);
 }
 
 const std::map<std::string, Robot::convex_pair_t> & Robot::convexes() const
 {
+  if(lazyKinematics_) { updateLazyConvexes(); }
   return convexes_;
 }
 
@@ -1168,7 +1289,7 @@ void Robot::fixCollisionTransforms()
 
 void Robot::loadRSDFFromDir(const std::string & surfaceDir)
 {
-  std::vector<SurfacePtr> surfacesIn = readRSDFFromDir(surfaceDir);
+  std::vector<SurfacePtr> surfacesIn = GeometryCache::rsdf(surfaceDir);
   for(const auto & sp : surfacesIn)
   {
     /* Check coherence of surface with mb */
@@ -1206,12 +1327,44 @@ unsigned int mc_rbdyn::Robot::robotIndex() const
 
 void Robot::forwardKinematics()
 {
+  if(lazyKinematics_) { return invalidateKinematics(KINEMATICS_VALID); }
   forwardKinematics(mbc());
 }
 void Robot::forwardKinematics(rbd::MultiBodyConfig & mbc) const
 {
   rbd::forwardKinematics(mb(), mbc);
+  updateConvexes(mbc);
+}
+
+void Robot::forwardAll(ForwardOrder order, const sva::MotionVecd & A_0)
+{
+  if(lazyKinematics_)
+  {
+    if(order == ForwardOrder::Acceleration) { lazyA_0_ = A_0; }
+    return invalidateKinematics(orderMask(order));
+  }
+  forwardAll(mbc(), order, A_0);
+}
 
+void Robot::forwardAll(rbd::MultiBodyConfig & mbc, ForwardOrder order, const sva::MotionVecd & A_0) const
+{
+  switch(order)
+  {
+    case ForwardOrder::Kinematics:
+      ::forwardAll<false, false>(mb(), mbc, A_0);
+      break;
+    case ForwardOrder::Velocity:
+      ::forwardAll<true, false>(mb(), mbc, A_0);
+      break;
+    case ForwardOrder::Acceleration:
+      ::forwardAll<true, true>(mb(), mbc, A_0);
+      break;
+  }
+  updateConvexes(mbc);
+}
+
+void Robot::updateConvexes(const rbd::MultiBodyConfig & mbc) const
+{
   for(const auto & cvx : convexes_)
   {
     auto get_cvx_tf = [&]()
@@ -1227,6 +1380,7 @@ void Robot::forwardKinematics(rbd::MultiBodyConfig & mbc) const
 
 void Robot::forwardVelocity()
 {
+  if(lazyKinematics_) { return invalidateKinematics(VELOCITY_VALID); }
   rbd::forwardVelocity(mb(), mbc());
 }
 void Robot::forwardVelocity(rbd::MultiBodyConfig & mbc) const
@@ -1236,6 +1390,11 @@ void Robot::forwardVelocity(rbd::MultiBodyConfig & mbc) const
 
 void Robot::forwardAcceleration(const sva::MotionVecd & A_0)
 {
+  if(lazyKinematics_)
+  {
+    lazyA_0_ = A_0;
+    return invalidateKinematics(ACCELERATION_VALID);
+  }
   rbd::forwardAcceleration(mb(), mbc(), A_0);
 }
 void Robot::forwardAcceleration(rbd::MultiBodyConfig & mbc, const sva::MotionVecd & A_0) const
@@ -1243,6 +1402,63 @@ void Robot::forwardAcceleration(rbd::MultiBodyConfig & mbc, const sva::MotionVec
   rbd::forwardAcceleration(mb(), mbc, A_0);
 }
 
+void Robot::lazyKinematics(bool lazy)
+{
+  if(lazy == lazyKinematics_) { return; }
+  if(lazy)
+  {
+    kinematicsValid_.assign(static_cast<size_t>(mb().nrBodies()),
+                            KINEMATICS_VALID | VELOCITY_VALID | ACCELERATION_VALID);
+    convexesValid_ = true;
+  }
+  else
+  {
+    updateLazyKinematics(ForwardOrder::Acceleration);
+    updateLazyConvexes();
+  }
+  lazyKinematics_ = lazy;
+}
+
+void Robot::invalidateKinematics(uint8_t mask)
+{
+  for(auto & valid : kinematicsValid_) { valid &= static_cast<uint8_t>(~mask); }
+  if(mask & KINEMATICS_VALID) { convexesValid_ = false; }
+}
+
+void Robot::updateLazyKinematics(ForwardOrder order) const
+{
+  // Joint i has body i as successor and bodies are sorted from the root so the predecessors are always up-to-date
+  auto need = orderMask(order);
+  auto & mbc = robots_->mbcs_[robots_idx_];
+  for(size_t i = 0; i < kinematicsValid_.size(); ++i)
+  {
+    if((kinematicsValid_[i] & need) != need)
+    {
+      assert(!mc_rtc::WorkerPool::inJob() && "Lazy kinematics must be updated before a parallel section");
+      forwardJointLazy(mb(), mbc, i, need, kinematicsValid_[i], lazyA_0_);
+    }
+  }
+}
+
+void Robot::updateLazyKinematics(unsigned int bodyIdx, ForwardOrder order) const
+{
+  auto need = orderMask(order);
+  if((kinematicsValid_[bodyIdx] & need) == need) { return; }
+  assert(!mc_rtc::WorkerPool::inJob() && "Lazy kinematics must be updated before a parallel section");
+  auto parent = mb().parent(static_cast<int>(bodyIdx));
+  if(parent != -1) { updateLazyKinematics(static_cast<unsigned int>(parent), order); }
+  forwardJointLazy(mb(), robots_->mbcs_[robots_idx_], bodyIdx, need, kinematicsValid_[bodyIdx], lazyA_0_);
+}
+
+void Robot::updateLazyConvexes() const
+{
+  if(convexesValid_) { return; }
+  assert(!mc_rtc::WorkerPool::inJob() && "Lazy kinematics must be updated before a parallel section");
+  updateLazyKinematics(ForwardOrder::Kinematics);
+  updateConvexes(mbc());
+  convexesValid_ = true;
+}
+
 void mc_rbdyn::Robot::eulerIntegration(double step)
 {
   rbd::integration(mb(), mbc(), step);
@@ -1255,7 +1471,8 @@ void mc_rbdyn::Robot::eulerIntegration(rbd::MultiBodyConfig & mbc, double step)
 
 const sva::PTransformd & Robot::posW() const
 {
-  return bodyPosW().at(0);
+  updateKinematics(0, ForwardOrder::Kinematics);
+  return mbc().bodyPosW.at(0);
 }
 
 void Robot::posW(const sva::PTransformd & pt)
@@ -1287,7 +1504,7 @@ void Robot::velW(const sva::MotionVecd & vel)
 {
   if(mb().joint(0).type() == rbd::Joint::Type::Free)
   {
-    auto vB = sva::PTransformd(mbc().bodyPosW[0].rotation()) * vel;
+    auto vB = sva::PTransformd(posW().rotation()) * vel;
     alpha()[0][0] = vB.angular().x();
     alpha()[0][1] = vB.angular().y();
     alpha()[0][2] = vB.angular().z();
@@ -1301,14 +1518,15 @@ void Robot::velW(const sva::MotionVecd & vel)
 
 const sva::MotionVecd & Robot::velW() const
 {
-  return bodyVelW().at(0);
+  updateKinematics(0, ForwardOrder::Velocity);
+  return mbc().bodyVelW.at(0);
 }
 
 void Robot::accW(const sva::MotionVecd & acc)
 {
   if(mb().joint(0).type() == rbd::Joint::Type::Free)
   {
-    auto aB = sva::PTransformd(mbc().bodyPosW[0].rotation()) * acc;
+    auto aB = sva::PTransformd(posW().rotation()) * acc;
     alphaD()[0][0] = aB.angular().x();
     alphaD()[0][1] = aB.angular().y();
     alphaD()[0][2] = aB.angular().z();
@@ -1322,12 +1540,14 @@ void Robot::accW(const sva::MotionVecd & acc)
 
 const sva::MotionVecd Robot::accW() const
 {
+  updateKinematics(0, ForwardOrder::Acceleration);
   Eigen::Matrix3d rot = posW().rotation().transpose();
   return sva::PTransformd{rot} * mbc().bodyAccB[0];
 }
 
 void Robot::copyLoadedData(Robot & robot) const
 {
+  if(lazyKinematics_) { updateLazyConvexes(); }
   for(const auto & s : surfaces_) { robot.surfaces_[s.first] = s.second->copy(); }
   robot.fixSurfaces();
   robot.makeFrames(module().frames());
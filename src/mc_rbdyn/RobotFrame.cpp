@@ -41,12 +41,17 @@ const std::string & RobotFrame::body() const noexcept
 
 sva::PTransformd RobotFrame::position() const noexcept
 {
-  if(!parent_) { return position_ * robot_.mbc().bodyPosW[bodyMbcIdx_]; }
+  if(!parent_)
+  {
+    robot_.updateKinematics(bodyMbcIdx_, Robot::ForwardOrder::Kinematics);
+    return position_ * robot_.mbc().bodyPosW[bodyMbcIdx_];
+  }
   return position_ * static_cast<RobotFrame *>(parent_.get())->position();
 }
 
 sva::MotionVecd RobotFrame::velocity() const noexcept
 {
+  if(!parent_) { robot_.updateKinematics(bodyMbcIdx_, Robot::ForwardOrder::Velocity); }
   auto X_0_parent = parent_ ? parent_->position() : robot_.mbc().bodyPosW[bodyMbcIdx_];
   auto vel = parent_ ? static_cast<RobotFrame *>(parent_.get())->velocity() : robot_.mbc().bodyVelW[bodyMbcIdx_];
   vel.linear() += -hat(X_0_parent.rotation().transpose() * position_.translation()) * vel.angular();
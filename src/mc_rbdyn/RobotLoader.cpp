@@ -3,16 +3,23 @@
  */
 
 #include <mc_rbdyn/RobotLoader.h>
+#include <mc_rbdyn/RobotModuleBundle.h>
+#include <mc_rbdyn/SelfCollisionFilter.h>
 
 #include <mc_rtc/Configuration.h>
 #include <mc_rtc/path.h>
+#include <mc_rtc/version.h>
 
 #include <boost/filesystem.hpp>
 #include <boost/range/adaptors.hpp>
+
+#include <cctype>
+#include <functional>
 namespace bfs = boost::filesystem;
 
 std::unique_ptr<mc_rtc::ObjectLoader<mc_rbdyn::RobotModule>> mc_rbdyn::RobotLoader::robot_loader;
 bool mc_rbdyn::RobotLoader::verbose_ = false;
+std::string mc_rbdyn::RobotLoader::bundles_dir_{};
 std::mutex mc_rbdyn::RobotLoader::mtx{};
 std::map<std::string, std::vector<std::string>> mc_rbdyn::RobotLoader::aliases{};
 
@@ -109,6 +116,82 @@ void RobotLoader::init(bool skip_default_path)
   }
 }
 
+void RobotLoader::enable_bundles(const std::string & directory)
+{
+  std::lock_guard<std::mutex> guard{mtx};
+  bundles_dir_ = directory.size() ? directory : mc_rtc::temp_directory_path("mc_rtc_robot_bundles");
+}
+
+void RobotLoader::disable_bundles()
+{
+  std::lock_guard<std::mutex> guard{mtx};
+  bundles_dir_.clear();
+}
+
+std::string RobotLoader::bundles_directory()
+{
+  std::lock_guard<std::mutex> guard{mtx};
+  return bundles_dir_;
+}
+
+RobotModulePtr RobotLoader::load_bundle(const std::vector<std::string> & params, std::string & bundle_path)
+{
+  bundle_path.clear();
+  // Bundles are only used for modules provided by a library since we need to detect modifications
+  if(bundles_dir_.empty() || robot_loader->get_object_library_path(params[0]).empty()) { return nullptr; }
+  std::string key = mc_rtc::MC_RTC_VERSION;
+  std::string name;
+  for(const auto & p : params)
+  {
+    key += '\0' + p;
+    if(name.size()) { name += '_'; }
+    for(auto c : p) { name += std::isalnum(static_cast<unsigned char>(c)) ? c : '_'; }
+  }
+  // Keep the file name readable but not too long
+  if(name.size() > 64) { name.resize(64); }
+  bundle_path = (bfs::path(bundles_dir_) / fmt::format("{}-{:016x}.bin", name, std::hash<std::string>{}(key))).string();
+  auto rm = RobotModuleBundle::load(bundle_path);
+  if(rm && verbose_) { mc_rtc::log::info("[RobotLoader] Loaded {} from {}", params[0], bundle_path); }
+  return rm;
+}
+
+void RobotLoader::save_bundle(const RobotModule & rm,
+                              const std::vector<std::string> & params,
+                              const std::string & bundle_path)
+{
+  std::vector<std::string> sources = {robot_loader->get_object_library_path(params[0])};
+  for(size_t i = 1; i < params.size(); ++i)
+  {
+    boost::system::error_code ec;
+    if(bfs::is_regular_file(params[i], ec)) { sources.push_back(params[i]); }
+  }
+  if(RobotModuleBundle::save(rm, bundle_path, sources) && verbose_)
+  {
+    mc_rtc::log::info("[RobotLoader] Saved {} to {}", params[0], bundle_path);
+  }
+}
+
+void RobotLoader::load_self_collision_filter(RobotModule & rm)
+{
+  auto path = SelfCollisionFilter::defaultPath(rm);
+  boost::system::error_code ec;
+  if(!bfs::is_regular_file(path, ec)) { return; }
+  try
+  {
+    rm._selfCollisionFilter = std::make_shared<SelfCollisionFilter>(SelfCollisionFilter::load(path));
+    if(verbose_) { mc_rtc::log::info("[RobotLoader] Loaded self-collision filter for {} from {}", rm.name, path); }
+  }
+  catch(mc_rtc::Configuration::Exception & exc)
+  {
+    mc_rtc::log::warning("[RobotLoader] Failed to load self-collision filter {}: {}", path, exc.what());
+    exc.silence();
+  }
+  catch(const std::exception & exc)
+  {
+    mc_rtc::log::warning("[RobotLoader] Failed to load self-collision filter {}: {}", path, exc.what());
+  }
+}
+
 RobotModulePtr RobotLoader::get_robot_module(const std::vector<std::string> & args)
 {
   if(args.size() == 1) { return get_robot_module(args[0]); }
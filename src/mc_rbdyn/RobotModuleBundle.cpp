@@ -0,0 +1,213 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rbdyn/RobotModuleBundle.h>
+#include <mc_rbdyn/configuration_io.h>
+
+#include <mc_rtc/logging.h>
+#include <mc_rtc/version.h>
+
+#include <boost/filesystem.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace bfs = boost::filesystem;
+
+namespace mc_rbdyn
+{
+
+namespace
+{
+
+/** Bundle files start with this magic string followed by the format version (uint32_t) */
+constexpr char BUNDLE_MAGIC[8] = {'M', 'C', 'R', 'T', 'C', 'R', 'M', 'B'};
+constexpr uint32_t BUNDLE_VERSION = 1;
+constexpr size_t BUNDLE_HEADER_SIZE = sizeof(BUNDLE_MAGIC) + sizeof(BUNDLE_VERSION);
+
+mc_rtc::Configuration sourceStamp(const std::string & path)
+{
+  mc_rtc::Configuration out;
+  boost::system::error_code ec;
+  bfs::path p(path);
+  out.add("path", path);
+  auto mtime = bfs::last_write_time(p, ec);
+  out.add("mtime", static_cast<int64_t>(ec ? -1 : mtime));
+  auto size = bfs::file_size(p, ec);
+  out.add("size", static_cast<uint64_t>(ec ? 0 : size));
+  return out;
+}
+
+bool sourceChanged(const mc_rtc::Configuration & stamp)
+{
+  auto current = sourceStamp(stamp("path"));
+  return static_cast<int64_t>(current("mtime")) != static_cast<int64_t>(stamp("mtime"))
+         || static_cast<uint64_t>(current("size")) != static_cast<uint64_t>(stamp("size"));
+}
+
+/** Re-create the MultiBodyGraph that generated \p mb
+ *
+ * Bodies in mb are expressed in their parent joint frame so linking them with
+ * an identity successor transformation gives back the same MultiBody
+ */
+rbd::MultiBodyGraph graphFromMultiBody(const rbd::MultiBody & mb)
+{
+  rbd::MultiBodyGraph mbg;
+  for(const auto & b : mb.bodies()) { mbg.addBody(b); }
+  for(int i = 1; i < mb.nrJoints(); ++i) { mbg.addJoint(mb.joint(i)); }
+  for(int i = 1; i < mb.nrJoints(); ++i)
+  {
+    const auto & j = mb.joint(i);
+    mbg.linkBodies(mb.body(mb.predecessor(i)).name(), mb.transform(i), mb.body(mb.successor(i)).name(),
+                   sva::PTransformd::Identity(), j.name(), j.forward());
+  }
+  return mbg;
+}
+
+} // namespace
+
+bool RobotModuleBundle::save(const RobotModule & rm, const std::string & path, const std::vector<std::string> & sources)
+{
+  if(rm._devices.size())
+  {
+    mc_rtc::log::warning("[RobotModuleBundle] {} provides devices, it cannot be stored in a bundle", rm.name);
+    return false;
+  }
+  if(!rm.hasDefaultControlToCanonicalPostProcess())
+  {
+    mc_rtc::log::warning("[RobotModuleBundle] {} provides a custom controlToCanonicalPostProcess, it cannot be stored "
+                         "in a bundle",
+                         rm.name);
+    return false;
+  }
+  mc_rtc::Configuration config;
+  try
+  {
+    config.add("module", mc_rtc::ConfigurationLoader<RobotModule>::save(rm, true));
+  }
+  catch(const std::exception & exc)
+  {
+    mc_rtc::log::warning("[RobotModuleBundle] {} cannot be stored in a bundle: {}", rm.name, exc.what());
+    return false;
+  }
+  config.add("mc_rtc", std::string(mc_rtc::MC_RTC_VERSION));
+  // Data that is not part of the RobotModule configuration
+  config.add("urdf_path", rm.urdf_path);
+  config.add("rsdf_dir", rm.rsdf_dir);
+  config.add("calib_dir", rm.calib_dir);
+  config.add("real_urdf", rm._real_urdf);
+  config.add("collisions", rm._collision);
+  {
+    const auto & cc = rm.controlToCanonicalConfig;
+    auto c = config.add("controlToCanonicalConfig");
+    c.add("mbcToOutMbc", cc.mbcToOutMbc_);
+    c.add("copyJointCommand", cc.copyJointCommand_);
+    c.add("copyJointVelocityCommand", cc.copyJointVelocityCommand_);
+    c.add("copyJointAccelerationCommand", cc.copyJointAccelerationCommand_);
+    c.add("copyJointTorqueCommand", cc.copyJointTorqueCommand_);
+    c.add("encodersToOutMbc", cc.encodersToOutMbc_);
+    c.add("encodersToOutMbcOnce", cc.encodersToOutMbcOnce_);
+    c.add("enforceMimics", cc.enforceMimics_);
+    c.add("copyPosWorld", cc.copyPosWorld_);
+  }
+  {
+    auto stamps = config.array("sources");
+    stamps.push(sourceStamp(rm.urdf_path));
+    if(rm._real_urdf.size() && rm._real_urdf != rm.urdf_path) { stamps.push(sourceStamp(rm._real_urdf)); }
+    for(const auto & s : sources) { stamps.push(sourceStamp(s)); }
+  }
+  std::vector<char> data;
+  size_t size = config.toMessagePack(data);
+  boost::system::error_code ec;
+  bfs::path out(path);
+  if(out.has_parent_path()) { bfs::create_directories(out.parent_path(), ec); }
+  auto tmp = out;
+  tmp += bfs::unique_path(".%%%%-%%%%.tmp", ec);
+  {
+    std::ofstream ofs(tmp.string(), std::ios::binary);
+    if(!ofs)
+    {
+      mc_rtc::log::warning("[RobotModuleBundle] Failed to write {}", tmp.string());
+      return false;
+    }
+    ofs.write(BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC));
+    ofs.write(reinterpret_cast<const char *>(&BUNDLE_VERSION), sizeof(BUNDLE_VERSION));
+    ofs.write(data.data(), static_cast<std::streamsize>(size));
+    if(!ofs)
+    {
+      bfs::remove(tmp, ec);
+      mc_rtc::log::warning("[RobotModuleBundle] Failed to write {}", tmp.string());
+      return false;
+    }
+  }
+  bfs::rename(tmp, out, ec);
+  if(ec)
+  {
+    bfs::remove(tmp, ec);
+    mc_rtc::log::warning("[RobotModuleBundle] Failed to write {}", path);
+    return false;
+  }
+  return true;
+}
+
+RobotModulePtr RobotModuleBundle::load(const std::string & path)
+{
+  std::ifstream ifs(path, std::ios::binary);
+  if(!ifs) { return nullptr; }
+  std::vector<char> data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  uint32_t version = 0;
+  if(data.size() > BUNDLE_HEADER_SIZE) { std::memcpy(&version, data.data() + sizeof(BUNDLE_MAGIC), sizeof(version)); }
+  if(data.size() <= BUNDLE_HEADER_SIZE || std::memcmp(data.data(), BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) != 0
+     || version != BUNDLE_VERSION)
+  {
+    mc_rtc::log::warning("[RobotModuleBundle] {} is not a valid bundle", path);
+    return nullptr;
+  }
+  try
+  {
+    auto config =
+        mc_rtc::Configuration::fromMessagePack(data.data() + BUNDLE_HEADER_SIZE, data.size() - BUNDLE_HEADER_SIZE);
+    if(config("mc_rtc").operator std::string() != mc_rtc::MC_RTC_VERSION) { return nullptr; }
+    auto sources = config("sources");
+    for(size_t i = 0; i < sources.size(); ++i)
+    {
+      if(sourceChanged(sources[i])) { return nullptr; }
+    }
+    RobotModule module = config("module");
+    auto rm = std::make_shared<RobotModule>(std::move(module));
+    rm->urdf_path = static_cast<std::string>(config("urdf_path"));
+    rm->rsdf_dir = static_cast<std::string>(config("rsdf_dir"));
+    rm->calib_dir = static_cast<std::string>(config("calib_dir"));
+    rm->_real_urdf = static_cast<std::string>(config("real_urdf"));
+    rm->_collision = static_cast<std::map<std::string, std::vector<rbd::parsers::Visual>>>(config("collisions"));
+    {
+      auto c = config("controlToCanonicalConfig");
+      auto & cc = rm->controlToCanonicalConfig;
+      c("mbcToOutMbc", cc.mbcToOutMbc_);
+      c("copyJointCommand", cc.copyJointCommand_);
+      c("copyJointVelocityCommand", cc.copyJointVelocityCommand_);
+      c("copyJointAccelerationCommand", cc.copyJointAccelerationCommand_);
+      c("copyJointTorqueCommand", cc.copyJointTorqueCommand_);
+      c("encodersToOutMbc", cc.encodersToOutMbc_);
+      c("encodersToOutMbcOnce", cc.encodersToOutMbcOnce_);
+      c("enforceMimics", cc.enforceMimics_);
+      c("copyPosWorld", cc.copyPosWorld_);
+    }
+    rm->mbg = graphFromMultiBody(rm->mb);
+    return rm;
+  }
+  catch(mc_rtc::Configuration::Exception & exc)
+  {
+    mc_rtc::log::warning("[RobotModuleBundle] Failed to load {}: {}", path, exc.what());
+    exc.silence();
+  }
+  catch(const std::exception & exc)
+  {
+    mc_rtc::log::warning("[RobotModuleBundle] Failed to load {}: {}", path, exc.what());
+  }
+  return nullptr;
+}
+
+} // namespace mc_rbdyn
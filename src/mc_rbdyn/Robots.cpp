@@ -46,6 +46,7 @@ Robots::Robots(NewRobotsToken) : robots_(), mbs_(), mbcs_(), robotIndex_(0), env
 void Robots::copy(Robots & out) const
 {
   if(&out == this) { return; }
+  updateKinematics();
   out.robots_.clear();
   out.robot_modules_ = robot_modules_;
   out.mbs_ = mbs_;
@@ -53,6 +54,7 @@ void Robots::copy(Robots & out) const
   out.mbgs_ = mbgs_;
   out.robotIndex_ = robotIndex_;
   out.envIndex_ = envIndex_;
+  out.generation_++;
   for(unsigned int i = 0; i < robots_.size(); ++i)
   {
     const Robot & robot = *robots_[i];
@@ -79,6 +81,11 @@ const std::vector<rbd::MultiBodyConfig> & Robots::mbcs() const
   return mbcs_;
 }
 
+void Robots::updateKinematics() const
+{
+  for(const auto & r : robots_) { r->updateKinematics(); }
+}
+
 unsigned int Robots::robotIndex() const
 {
   return robotIndex_;
@@ -167,6 +174,7 @@ void Robots::removeRobot(unsigned int idx)
   mbs_.erase(mbs_.begin() + idx);
   mbcs_.erase(mbcs_.begin() + idx);
   mbgs_.erase(mbgs_.begin() + idx);
+  generation_++;
   for(unsigned int i = idx; i < robots_.size(); ++i)
   {
     auto & r = *robots_[i];
@@ -182,10 +190,14 @@ void Robots::robotCopy(const Robot & robot, const std::string & copyName)
     mc_rtc::log::error_and_throw("Cannot copy robot {} to {}: a robot named {} already exists", robot.name(), copyName,
                                  copyName);
   }
-  this->robot_modules_.push_back(robot.module());
+  // The module and the graph are shared with the original robot
+  robot.updateKinematics();
+  auto module = robot.robots_->robot_modules_[robot.robots_idx_];
+  auto mbg = robot.robots_->mbgs_[robot.robots_idx_];
+  this->robot_modules_.push_back(std::move(module));
   this->mbs_.push_back(robot.mb());
   this->mbcs_.push_back(robot.mbc());
-  this->mbgs_.push_back(robot.mbg());
+  this->mbgs_.push_back(std::move(mbg));
   auto referenceRobots = robot.robots_;
   auto referenceIndex = robot.robots_idx_;
   auto copyRobotIndex = static_cast<unsigned int>(this->mbs_.size()) - 1;
@@ -194,6 +206,7 @@ void Robots::robotCopy(const Robot & robot, const std::string & copyName)
   const auto & refRobot = *referenceRobots->robots_[referenceIndex];
   refRobot.copyLoadedData(*robots_.back());
   robotNameToIndex_[copyName] = copyRobotIndex;
+  generation_++;
 }
 
 Robot & Robots::load(const std::string & name, const RobotModule & module, const LoadRobotParameters & params)
@@ -202,14 +215,15 @@ Robot & Robots::load(const std::string & name, const RobotModule & module, const
   {
     mc_rtc::log::error_and_throw("Robot names are required to be unique but a robot named {} already exists.", name);
   }
-  robot_modules_.emplace_back(module);
+  robot_modules_.push_back(std::make_shared<const RobotModule>(module));
   mbs_.emplace_back(module.mb);
   mbcs_.emplace_back(module.mbc);
-  mbgs_.emplace_back(module.mbg);
+  mbgs_.push_back(std::make_shared<rbd::MultiBodyGraph>(module.mbg));
   robots_.push_back(std::make_shared<Robot>(Robot::NewRobotToken{}, name, *this,
                                             static_cast<unsigned int>(mbs_.size() - 1), true, params));
   robotNameToIndex_[name] = robots_.back()->robotIndex();
   updateIndexes();
+  generation_++;
   return *robots_.back();
 }
 
@@ -377,7 +391,7 @@ mc_rbdyn::Robots::size_type mc_rbdyn::Robots::size() const noexcept
 
 const RobotModule & Robots::robotModule(size_t idx) const
 {
-  return robot_modules_[idx];
+  return *robot_modules_[idx];
 }
 
 MC_RTC_diagnostic_pop
@@ -53,6 +53,22 @@ double distance(CD_Pair & pair, Eigen::Vector3d & p1, Eigen::Vector3d & p2)
   return dist;
 }
 
+void boundingSphere(const S_Object & obj, const sva::PTransformd & X_0_obj, Eigen::Vector3d & center, double & radius)
+{
+  // Axis-aligned bounding box in the world from the support points along each axis
+  Eigen::Vector3d min, max;
+  for(int i = 0; i < 3; ++i)
+  {
+    sch::Vector3 v(0, 0, 0);
+    v[i] = 1;
+    max(i) = obj.support(v)[i];
+    v[i] = -1;
+    min(i) = obj.support(v)[i];
+  }
+  radius = 0.5 * (max - min).norm();
+  center = (sva::PTransformd(Eigen::Vector3d(0.5 * (max + min))) * X_0_obj.inv()).translation();
+}
+
 } // namespace mc_rbdyn
 
 } // namespace sch
@@ -0,0 +1,213 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rbdyn/Robots.h>
+#include <mc_rbdyn/SCHAddon.h>
+#include <mc_rbdyn/SelfCollisionFilter.h>
+
+#include <mc_rtc/WorkerPool.h>
+#include <mc_rtc/constants.h>
+#include <mc_rtc/logging.h>
+
+#include <boost/filesystem.hpp>
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+
+namespace bfs = boost::filesystem;
+
+namespace mc_rbdyn
+{
+
+namespace
+{
+
+std::pair<std::string, std::string> key(const std::string & c1, const std::string & c2)
+{
+  if(c1 < c2) { return {c1, c2}; }
+  return {c2, c1};
+}
+
+/** Sampling range of a single dof joint */
+struct SampledJoint
+{
+  size_t jIndex;
+  std::uniform_real_distribution<double> distribution;
+};
+
+/** Joint following another joint */
+struct MimicJoint
+{
+  size_t jIndex;
+  size_t mainIndex;
+  double multiplier;
+  double offset;
+};
+
+/** Candidate pair */
+struct Pair
+{
+  Pair(const std::string & c1, const std::string & c2, sch::S_Object * o1, sch::S_Object * o2)
+  : c1(c1), c2(c2), pair(std::make_unique<sch::CD_Pair>(o1, o2))
+  {
+  }
+  std::string c1;
+  std::string c2;
+  std::unique_ptr<sch::CD_Pair> pair;
+  double minDistance = std::numeric_limits<double>::infinity();
+};
+
+} // namespace
+
+SelfCollisionFilter SelfCollisionFilter::compute(const RobotModule & rm, const Options & options)
+{
+  SelfCollisionFilter out;
+  out.options_ = options;
+  auto robots = loadRobot(rm);
+  auto & robot = robots->robot();
+  const auto & mb = robot.mb();
+
+  auto bound = [&](size_t bIdx, const std::string & jName, double def)
+  {
+    if(rm.bounds().size() <= bIdx) { return def; }
+    auto it = rm.bounds()[bIdx].find(jName);
+    if(it == rm.bounds()[bIdx].end() || it->second.size() != 1 || !std::isfinite(it->second[0])) { return def; }
+    return it->second[0];
+  };
+  std::vector<SampledJoint> sampled;
+  std::vector<MimicJoint> mimics;
+  for(size_t i = 0; i < mb.joints().size(); ++i)
+  {
+    const auto & j = mb.joint(static_cast<int>(i));
+    if(j.dof() != 1) { continue; }
+    if(j.isMimic())
+    {
+      mimics.push_back({i, static_cast<size_t>(mb.jointIndexByName(j.mimicName())), j.mimicMultiplier(),
+                        j.mimicOffset()});
+      continue;
+    }
+    double lower = bound(0, j.name(), -mc_rtc::constants::PI);
+    double upper = bound(1, j.name(), mc_rtc::constants::PI);
+    if(upper < lower) { std::swap(lower, upper); }
+    sampled.push_back({i, std::uniform_real_distribution<double>(lower, upper)});
+  }
+
+  // Bodies that are attached to each other
+  auto adjacent = [&](const std::string & b1, const std::string & b2)
+  {
+    auto i1 = mb.bodyIndexByName(b1);
+    auto i2 = mb.bodyIndexByName(b2);
+    return i1 == i2 || mb.parent(i1) == i2 || mb.parent(i2) == i1;
+  };
+  std::vector<Pair> pairs;
+  const auto & convexes = robot.convexes();
+  for(auto it1 = convexes.begin(); it1 != convexes.end(); ++it1)
+  {
+    for(auto it2 = std::next(it1); it2 != convexes.end(); ++it2)
+    {
+      if(adjacent(it1->second.first, it2->second.first))
+      {
+        out.exclude(it1->first, it2->first, Reason::Adjacent, 0.0);
+        continue;
+      }
+      pairs.emplace_back(it1->first, it2->first, it1->second.second.get(), it2->second.second.get());
+    }
+  }
+
+  std::mt19937 gen(options.seed);
+  mc_rtc::WorkerPool pool(options.threads);
+  for(size_t s = 0; s < options.samples; ++s)
+  {
+    for(auto & j : sampled) { robot.mbc().q[j.jIndex][0] = j.distribution(gen); }
+    for(const auto & m : mimics)
+    {
+      robot.mbc().q[m.jIndex][0] = m.multiplier * robot.mbc().q[m.mainIndex][0] + m.offset;
+    }
+    robot.forwardKinematics();
+    pool.run(pairs.size(),
+             [&](size_t i)
+             {
+               auto & p = pairs[i];
+               Eigen::Vector3d p1, p2;
+               double d = sch::mc_rbdyn::distance(*p.pair, p1, p2);
+               d = d >= 0 ? std::sqrt(d) : -std::sqrt(-d);
+               p.minDistance = std::min(p.minDistance, d);
+             });
+  }
+  for(const auto & p : pairs)
+  {
+    if(p.minDistance > options.distance) { out.exclude(p.c1, p.c2, Reason::Far, p.minDistance); }
+  }
+  return out;
+}
+
+std::string SelfCollisionFilter::defaultPath(const RobotModule & rm)
+{
+  return (bfs::path(rm.path) / "collision_filter" / (rm.name + ".yaml")).string();
+}
+
+SelfCollisionFilter SelfCollisionFilter::load(const std::string & path)
+{
+  mc_rtc::Configuration config(path);
+  SelfCollisionFilter out;
+  config("samples", out.options_.samples);
+  config("distance", out.options_.distance);
+  config("seed", out.options_.seed);
+  auto exclusions = config("exclusions");
+  for(size_t i = 0; i < exclusions.size(); ++i)
+  {
+    auto e = exclusions[i];
+    auto reason = static_cast<std::string>(e("reason"));
+    if(reason != "adjacent" && reason != "far")
+    {
+      mc_rtc::log::error_and_throw("[SelfCollisionFilter] Invalid exclusion reason {} in {}", reason, path);
+    }
+    out.exclude(static_cast<std::string>(e("convex1")), static_cast<std::string>(e("convex2")),
+                reason == "adjacent" ? Reason::Adjacent : Reason::Far, static_cast<double>(e("distance")));
+  }
+  return out;
+}
+
+void SelfCollisionFilter::save(const std::string & path) const
+{
+  mc_rtc::Configuration config;
+  config.add("samples", options_.samples);
+  config.add("distance", options_.distance);
+  config.add("seed", options_.seed);
+  auto exclusions = config.array("exclusions", exclusions_.size());
+  for(const auto & [names, e] : exclusions_)
+  {
+    mc_rtc::Configuration c;
+    c.add("convex1", names.first);
+    c.add("convex2", names.second);
+    c.add("reason", e.reason == Reason::Adjacent ? "adjacent" : "far");
+    c.add("distance", e.minDistance);
+    exclusions.push(c);
+  }
+  boost::system::error_code ec;
+  bfs::path out(path);
+  if(out.has_parent_path()) { bfs::create_directories(out.parent_path(), ec); }
+  config.save(path);
+}
+
+void SelfCollisionFilter::exclude(const std::string & c1, const std::string & c2, Reason reason, double minDistance)
+{
+  exclusions_[key(c1, c2)] = {reason, minDistance};
+}
+
+bool SelfCollisionFilter::excluded(const std::string & c1, const std::string & c2) const
+{
+  return exclusions_.count(key(c1, c2)) != 0;
+}
+
+const SelfCollisionFilter::Exclusion * SelfCollisionFilter::exclusion(const std::string & c1,
+                                                                     const std::string & c2) const
+{
+  auto it = exclusions_.find(key(c1, c2));
+  return it != exclusions_.end() ? &it->second : nullptr;
+}
+
+} // namespace mc_rbdyn
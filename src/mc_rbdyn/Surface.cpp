@@ -55,7 +55,7 @@ unsigned int Surface::bodyIndex(const mc_rbdyn::Robot & robot) const
 
 sva::PTransformd Surface::X_0_s(const mc_rbdyn::Robot & robot) const
 {
-  return X_0_s(robot, robot.mbc());
+  return impl->_X_b_s * robot.bodyPosW(impl->bodyName);
 }
 
 sva::PTransformd Surface::X_0_s(const mc_rbdyn::Robot & robot, const rbd::MultiBodyConfig & mbc) const
@@ -7,11 +7,18 @@
 #include <mc_rbdyn/PlanarSurface.h>
 #include <mc_rbdyn/SCHAddon.h>
 #include <mc_rbdyn/surface_hull.h>
+#include <mc_rtc/WorkerPool.h>
 #include <mc_rtc/constants.h>
 #include <mc_rtc/logging.h>
 
+#include <algorithm>
 #include <fstream>
+#include <functional>
+#include <list>
+#include <mutex>
 #include <stdlib.h>
+#include <thread>
+#include <unordered_map>
 
 // Does not look nice but make sure it's not confused with system headers
 #include "libqhullcpp/Qhull.h"
@@ -35,42 +42,18 @@ inline int mkstemp(char * out)
 namespace mc_rbdyn
 {
 
-sch::S_Object * surface_to_sch(const mc_rbdyn::Surface & surface, const double & depth, const unsigned int & slice)
+namespace
 {
-  if(dynamic_cast<const mc_rbdyn::PlanarSurface *>(&surface) != nullptr)
-  {
-    return planar_hull(static_cast<const mc_rbdyn::PlanarSurface &>(surface), depth);
-  }
-  if(dynamic_cast<const mc_rbdyn::CylindricalSurface *>(&surface) != nullptr)
-  {
-    return cylindrical_hull(static_cast<const mc_rbdyn::CylindricalSurface &>(surface), slice);
-  }
-  if(dynamic_cast<const mc_rbdyn::GripperSurface *>(&surface) != nullptr)
-  {
-    return gripper_hull(static_cast<const mc_rbdyn::GripperSurface &>(surface), slice);
-  }
-  return nullptr;
-}
 
-sch::S_Object * sch_polyhedron(const std::vector<sva::PTransformd> & points_pt)
+/** Build the convex hull of a set of points stored as [x0, y0, z0, x1, ...] */
+sch::S_Polyhedron * polyhedron(const std::vector<double> & points_in)
 {
   sch::S_Polyhedron * poly = new sch::S_Polyhedron();
   auto & poly_algo = *(poly->getPolyhedronAlgorithm());
 
-  // Build the input for qhull
-  std::vector<double> points_in;
-  points_in.reserve(points_pt.size() * 3);
-  for(const auto & p : points_pt)
-  {
-    const auto & t = p.translation();
-    points_in.push_back(t.x());
-    points_in.push_back(t.y());
-    points_in.push_back(t.z());
-  }
-
   // Run qhull
   orgQhull::Qhull qhull;
-  qhull.runQhull("", 3, static_cast<int>(points_pt.size()), points_in.data(), "Qt");
+  qhull.runQhull("", 3, static_cast<int>(points_in.size() / 3), points_in.data(), "Qt");
 
   auto points = qhull.points();
   poly_algo.vertexes_.reserve(points.size());
@@ -110,15 +93,29 @@ sch::S_Object * sch_polyhedron(const std::vector<sva::PTransformd> & points_pt)
   return poly;
 }
 
-sch::S_Object * planar_hull(const mc_rbdyn::PlanarSurface & surface, const double & depth)
+std::vector<double> flatten(const std::vector<sva::PTransformd> & points_pt)
+{
+  std::vector<double> points_in;
+  points_in.reserve(points_pt.size() * 3);
+  for(const auto & p : points_pt)
+  {
+    const auto & t = p.translation();
+    points_in.push_back(t.x());
+    points_in.push_back(t.y());
+    points_in.push_back(t.z());
+  }
+  return points_in;
+}
+
+std::vector<sva::PTransformd> planar_points(const mc_rbdyn::PlanarSurface & surface, double depth)
 {
   std::vector<sva::PTransformd> points = surface.points();
   sva::PTransformd offset(Eigen::Vector3d(0, 0, depth));
   for(const sva::PTransformd & p : surface.points()) { points.push_back(offset * p); }
-  return sch_polyhedron(points);
+  return points;
 }
 
-sch::S_Object * cylindrical_hull(const mc_rbdyn::CylindricalSurface & surface, const unsigned int & slice)
+std::vector<sva::PTransformd> cylindrical_points(const mc_rbdyn::CylindricalSurface & surface, unsigned int slice)
 {
   std::vector<sva::PTransformd> points(0);
   sva::PTransformd bTransform(Eigen::Vector3d(0, 0, surface.radius()));
@@ -129,10 +126,10 @@ sch::S_Object * cylindrical_hull(const mc_rbdyn::CylindricalSurface & surface, c
       points.push_back(bTransform * sva::PTransformd(sva::RotX((2 * mc_rtc::constants::PI * s) / slice)) * p);
     }
   }
-  return sch_polyhedron(points);
+  return points;
 }
 
-sch::S_Object * gripper_hull(const mc_rbdyn::GripperSurface & surface, const double & depth)
+std::vector<sva::PTransformd> gripper_points(const mc_rbdyn::GripperSurface & surface, double depth)
 {
   std::vector<sva::PTransformd> points(0);
   for(const sva::PTransformd & p : surface.pointsFromOrigin())
@@ -144,7 +141,199 @@ sch::S_Object * gripper_hull(const mc_rbdyn::GripperSurface & surface, const dou
   sva::PTransformd offset = sva::PTransformd(Eigen::Vector3d(depth, depth, depth));
   size_t nP = points.size();
   for(size_t i = 0; i < nP; ++i) { points.push_back(offset * points[i]); }
-  return sch_polyhedron(points);
+  return points;
+}
+
+/** Identifies a hull in the cache */
+struct HullKey
+{
+  std::string type;
+  std::string body;
+  std::string name;
+  double depth;
+  unsigned int slice;
+  /** Points given to qhull */
+  std::vector<double> points;
+
+  bool operator==(const HullKey & other) const noexcept
+  {
+    return type == other.type && body == other.body && name == other.name && depth == other.depth
+           && slice == other.slice && points == other.points;
+  }
+};
+
+struct HullKeyHash
+{
+  size_t operator()(const HullKey & key) const noexcept
+  {
+    size_t seed = 0;
+    auto combine = [&seed](size_t h) { seed ^= h + 0x9e3779b9 + (seed << 6) + (seed >> 2); };
+    combine(std::hash<std::string>{}(key.type));
+    combine(std::hash<std::string>{}(key.body));
+    combine(std::hash<std::string>{}(key.name));
+    combine(std::hash<double>{}(key.depth));
+    combine(std::hash<unsigned int>{}(key.slice));
+    for(const auto & p : key.points) { combine(std::hash<double>{}(p)); }
+    return seed;
+  }
+};
+
+/** Compute the key of a surface hull, returns false if the surface type is not supported */
+bool hullKey(const mc_rbdyn::Surface & surface, double depth, unsigned int slice, HullKey & key)
+{
+  // Note: surface_to_sch has always used slice as the depth of gripper hulls, this is kept for compatibility
+  if(auto planar = dynamic_cast<const mc_rbdyn::PlanarSurface *>(&surface))
+  {
+    key.points = flatten(planar_points(*planar, depth));
+  }
+  else if(auto cylindrical = dynamic_cast<const mc_rbdyn::CylindricalSurface *>(&surface))
+  {
+    key.points = flatten(cylindrical_points(*cylindrical, slice));
+  }
+  else if(auto gripper = dynamic_cast<const mc_rbdyn::GripperSurface *>(&surface))
+  {
+    key.points = flatten(gripper_points(*gripper, slice));
+  }
+  else { return false; }
+  key.type = surface.type();
+  key.body = surface.bodyName();
+  key.name = surface.name();
+  key.depth = depth;
+  key.slice = slice;
+  return true;
+}
+
+using HullPtr = std::shared_ptr<const sch::S_Polyhedron>;
+
+/** LRU cache of surface hulls */
+struct HullCache
+{
+  std::mutex mtx;
+  size_t capacity = 256;
+  /** Most recently used entries first */
+  std::list<std::pair<HullKey, HullPtr>> entries;
+  std::unordered_map<HullKey, std::list<std::pair<HullKey, HullPtr>>::iterator, HullKeyHash> index;
+
+  /** Drop the least recently used entries until the cache fits its capacity, must be called with the lock held */
+  void shrink()
+  {
+    while(entries.size() > capacity)
+    {
+      index.erase(entries.back().first);
+      entries.pop_back();
+    }
+  }
+};
+
+HullCache & cache()
+{
+  static HullCache cache;
+  return cache;
+}
+
+} // namespace
+
+sch::S_Object * surface_to_sch(const mc_rbdyn::Surface & surface, const double & depth, const unsigned int & slice)
+{
+  auto hull = surface_hull(surface, depth, slice);
+  if(!hull) { return nullptr; }
+  return new sch::S_Polyhedron(*hull);
+}
+
+std::shared_ptr<const sch::S_Polyhedron> surface_hull(const mc_rbdyn::Surface & surface,
+                                                      double depth,
+                                                      unsigned int slice)
+{
+  HullKey key;
+  if(!hullKey(surface, depth, slice, key)) { return nullptr; }
+  auto & c = cache();
+  {
+    std::unique_lock<std::mutex> lck(c.mtx);
+    auto it = c.index.find(key);
+    if(it != c.index.end())
+    {
+      c.entries.splice(c.entries.begin(), c.entries, it->second);
+      return it->second->second;
+    }
+  }
+  // qhull runs outside of the lock, concurrent requests for the same surface may both compute it
+  HullPtr hull(polyhedron(key.points));
+  std::unique_lock<std::mutex> lck(c.mtx);
+  if(c.capacity == 0) { return hull; }
+  auto it = c.index.find(key);
+  if(it != c.index.end())
+  {
+    c.entries.splice(c.entries.begin(), c.entries, it->second);
+    return it->second->second;
+  }
+  c.entries.emplace_front(key, hull);
+  c.index[std::move(key)] = c.entries.begin();
+  c.shrink();
+  return hull;
+}
+
+std::vector<std::shared_ptr<const sch::S_Polyhedron>> surface_hulls(
+    const std::vector<const mc_rbdyn::Surface *> & surfaces,
+    double depth,
+    unsigned int slice,
+    size_t threads)
+{
+  std::vector<HullPtr> out(surfaces.size());
+  if(surfaces.empty()) { return out; }
+  if(threads == 0) { threads = std::max<size_t>(std::thread::hardware_concurrency(), 1); }
+  mc_rtc::WorkerPool pool(std::min(threads, surfaces.size()));
+  pool.run(surfaces.size(), [&](size_t i) { out[i] = surface_hull(*surfaces[i], depth, slice); });
+  return out;
+}
+
+size_t surface_hull_cache_size() noexcept
+{
+  auto & c = cache();
+  std::unique_lock<std::mutex> lck(c.mtx);
+  return c.entries.size();
+}
+
+size_t surface_hull_cache_capacity() noexcept
+{
+  auto & c = cache();
+  std::unique_lock<std::mutex> lck(c.mtx);
+  return c.capacity;
+}
+
+void surface_hull_cache_capacity(size_t capacity) noexcept
+{
+  auto & c = cache();
+  std::unique_lock<std::mutex> lck(c.mtx);
+  c.capacity = capacity;
+  c.shrink();
+}
+
+void surface_hull_cache_clear() noexcept
+{
+  auto & c = cache();
+  std::unique_lock<std::mutex> lck(c.mtx);
+  c.entries.clear();
+  c.index.clear();
+}
+
+sch::S_Object * sch_polyhedron(const std::vector<sva::PTransformd> & points_pt)
+{
+  return polyhedron(flatten(points_pt));
+}
+
+sch::S_Object * planar_hull(const mc_rbdyn::PlanarSurface & surface, const double & depth)
+{
+  return sch_polyhedron(planar_points(surface, depth));
+}
+
+sch::S_Object * cylindrical_hull(const mc_rbdyn::CylindricalSurface & surface, const unsigned int & slice)
+{
+  return sch_polyhedron(cylindrical_points(surface, slice));
+}
+
+sch::S_Object * gripper_hull(const mc_rbdyn::GripperSurface & surface, const double & depth)
+{
+  return sch_polyhedron(gripper_points(surface, depth));
 }
 
 } // namespace mc_rbdyn
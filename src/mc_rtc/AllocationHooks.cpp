@@ -0,0 +1,79 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+/** Allocator hooks for mc_rtc::AllocationTracker
+ *
+ * This library replaces the C allocation functions with versions that report
+ * to the tracker before forwarding to glibc's implementation. It is not linked
+ * by any mc_rtc library, link it explicitly or preload it to enable the tracker.
+ */
+
+#include <mc_rtc/AllocationTracker.h>
+
+#ifdef __GLIBC__
+
+#  include <cerrno>
+#  include <cstddef>
+
+extern "C"
+{
+  void * __libc_malloc(size_t);
+  void * __libc_calloc(size_t, size_t);
+  void * __libc_realloc(void *, size_t);
+  void * __libc_memalign(size_t, size_t);
+
+  void * malloc(size_t size)
+  {
+    mc_rtc::AllocationTracker::onAllocation(size);
+    return __libc_malloc(size);
+  }
+
+  void * calloc(size_t n, size_t size)
+  {
+    mc_rtc::AllocationTracker::onAllocation(n * size);
+    return __libc_calloc(n, size);
+  }
+
+  void * realloc(void * ptr, size_t size)
+  {
+    mc_rtc::AllocationTracker::onAllocation(size);
+    return __libc_realloc(ptr, size);
+  }
+
+  void * memalign(size_t alignment, size_t size)
+  {
+    mc_rtc::AllocationTracker::onAllocation(size);
+    return __libc_memalign(alignment, size);
+  }
+
+  void * aligned_alloc(size_t alignment, size_t size)
+  {
+    mc_rtc::AllocationTracker::onAllocation(size);
+    return __libc_memalign(alignment, size);
+  }
+
+  int posix_memalign(void ** ptr, size_t alignment, size_t size)
+  {
+    if(alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0 || alignment == 0) { return EINVAL; }
+    mc_rtc::AllocationTracker::onAllocation(size);
+    void * out = __libc_memalign(alignment, size);
+    if(!out) { return ENOMEM; }
+    *ptr = out;
+    return 0;
+  }
+}
+
+namespace
+{
+
+struct RegisterHooks
+{
+  RegisterHooks() { mc_rtc::AllocationTracker::onHooksLoaded(); }
+};
+
+RegisterHooks registerHooks;
+
+} // namespace
+
+#endif
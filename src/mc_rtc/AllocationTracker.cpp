@@ -0,0 +1,228 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rtc/AllocationTracker.h>
+#include <mc_rtc/logging.h>
+
+#include <boost/stacktrace.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+namespace mc_rtc
+{
+
+namespace
+{
+
+using Frames = std::array<const void *, AllocationTracker::MAX_FRAMES + 1>;
+
+struct SiteRecord
+{
+  const char * phase;
+  uint64_t count;
+  size_t size;
+  size_t nFrames;
+  Frames frames;
+};
+
+struct PhaseRecord
+{
+  const char * name;
+  uint64_t count;
+};
+
+/** Everything is constant-initialized so that the hooks can call in before static initialization */
+struct TrackerState
+{
+  std::atomic<bool> hooks{false};
+  std::atomic<bool> tracking{false};
+  std::thread::id owner;
+  /** Non-zero while recording or paused, prevents recursion from the recording code */
+  unsigned suspended = 0;
+  const char * phase = "Unknown";
+  uint64_t allocations = 0;
+  uint64_t bytes = 0;
+  std::array<PhaseRecord, AllocationTracker::MAX_PHASES> phases{};
+  size_t nPhases = 0;
+  std::array<SiteRecord, AllocationTracker::MAX_SITES> sites{};
+  size_t nSites = 0;
+};
+
+TrackerState state;
+
+inline bool isTrackingThread() noexcept
+{
+  return state.tracking.load(std::memory_order_acquire) && std::this_thread::get_id() == state.owner;
+}
+
+inline bool samePhase(const char * lhs, const char * rhs) noexcept
+{
+  return lhs == rhs || std::strcmp(lhs, rhs) == 0;
+}
+
+void chargePhase(const char * phase) noexcept
+{
+  for(size_t i = 0; i < state.nPhases; ++i)
+  {
+    if(samePhase(state.phases[i].name, phase))
+    {
+      state.phases[i].count++;
+      return;
+    }
+  }
+  if(state.nPhases < state.phases.size()) { state.phases[state.nPhases++] = {phase, 1}; }
+  else { state.phases.back().count++; }
+}
+
+void recordSite(size_t size) noexcept
+{
+  SiteRecord site;
+  site.phase = state.phase;
+  site.count = 1;
+  site.size = size;
+  site.frames.fill(nullptr);
+  // Skip this function, onAllocation and the allocator hook
+  size_t depth = boost::stacktrace::safe_dump_to(3, site.frames.data(), sizeof(site.frames));
+  site.nFrames = depth > 0 ? std::min(depth - 1, AllocationTracker::MAX_FRAMES) : 0;
+  for(size_t i = 0; i < state.nSites; ++i)
+  {
+    auto & other = state.sites[i];
+    if(other.nFrames == site.nFrames && samePhase(other.phase, site.phase)
+       && std::equal(site.frames.begin(), site.frames.begin() + site.nFrames, other.frames.begin()))
+    {
+      other.count++;
+      other.size = size;
+      return;
+    }
+  }
+  if(state.nSites < state.sites.size()) { state.sites[state.nSites++] = site; }
+}
+
+} // namespace
+
+bool AllocationTracker::hooksLoaded() noexcept
+{
+  return state.hooks.load(std::memory_order_relaxed);
+}
+
+void AllocationTracker::start() noexcept
+{
+  state.owner = std::this_thread::get_id();
+  state.tracking.store(true, std::memory_order_release);
+}
+
+void AllocationTracker::stop() noexcept
+{
+  state.tracking.store(false, std::memory_order_release);
+}
+
+bool AllocationTracker::tracking() noexcept
+{
+  return state.tracking.load(std::memory_order_relaxed);
+}
+
+void AllocationTracker::reset() noexcept
+{
+  state.allocations = 0;
+  state.bytes = 0;
+  state.nPhases = 0;
+  state.nSites = 0;
+}
+
+uint64_t AllocationTracker::allocations() noexcept
+{
+  return state.allocations;
+}
+
+AllocationTracker::Report AllocationTracker::report(bool symbolize)
+{
+  Pause pause;
+  Report out;
+  out.allocations = state.allocations;
+  out.bytes = state.bytes;
+  for(size_t i = 0; i < state.nPhases; ++i) { out.phases[state.phases[i].name] += state.phases[i].count; }
+  out.sites.reserve(state.nSites);
+  for(size_t i = 0; i < state.nSites; ++i)
+  {
+    const auto & record = state.sites[i];
+    auto & site = out.sites.emplace_back();
+    site.phase = record.phase;
+    site.count = record.count;
+    site.size = record.size;
+    if(symbolize)
+    {
+      for(size_t j = 0; j < record.nFrames && record.frames[j]; ++j)
+      {
+        site.backtrace.push_back(boost::stacktrace::to_string(boost::stacktrace::frame(record.frames[j])));
+      }
+    }
+  }
+  std::stable_sort(out.sites.begin(), out.sites.end(),
+                   [](const Site & lhs, const Site & rhs) { return lhs.count > rhs.count; });
+  return out;
+}
+
+std::string AllocationTracker::Report::to_string() const
+{
+  std::string out = fmt::format("{} allocations ({} bytes)", allocations, bytes);
+  for(const auto & p : phases) { out += fmt::format("\n- {}: {} allocations", p.first, p.second); }
+  for(size_t i = 0; i < sites.size(); ++i)
+  {
+    const auto & site = sites[i];
+    out += fmt::format("\nSite #{}: {} allocations in {} (last size: {} bytes)", i, site.count, site.phase, site.size);
+    for(size_t j = 0; j < site.backtrace.size(); ++j) { out += fmt::format("\n  #{} {}", j, site.backtrace[j]); }
+  }
+  return out;
+}
+
+void AllocationTracker::check(uint64_t maxAllocations)
+{
+  if(state.allocations <= maxAllocations) { return; }
+  Pause pause;
+  mc_rtc::log::error_and_throw("[AllocationTracker] {} allocations while at most {} were expected\n{}",
+                               state.allocations, maxAllocations, report().to_string());
+}
+
+AllocationTracker::Phase::Phase(const char * name) noexcept
+: previous_(isTrackingThread() ? state.phase : nullptr)
+{
+  if(previous_) { state.phase = name; }
+}
+
+AllocationTracker::Phase::~Phase() noexcept
+{
+  if(previous_) { state.phase = previous_; }
+}
+
+AllocationTracker::Pause::Pause() noexcept : active_(isTrackingThread())
+{
+  if(active_) { state.suspended++; }
+}
+
+AllocationTracker::Pause::~Pause() noexcept
+{
+  if(active_) { state.suspended--; }
+}
+
+void AllocationTracker::onAllocation(size_t size) noexcept
+{
+  if(!isTrackingThread() || state.suspended) { return; }
+  state.suspended++;
+  state.allocations++;
+  state.bytes += size;
+  chargePhase(state.phase);
+  recordSite(size);
+  state.suspended--;
+}
+
+void AllocationTracker::onHooksLoaded() noexcept
+{
+  state.hooks.store(true, std::memory_order_relaxed);
+}
+
+} // namespace mc_rtc
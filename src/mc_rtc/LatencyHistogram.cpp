@@ -0,0 +1,120 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rtc/LatencyHistogram.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace mc_rtc
+{
+
+namespace
+{
+
+/** Values below SUB_BUCKETS are stored exactly, above that each power of two
+ * is split into HALF_SUB_BUCKETS linear buckets */
+constexpr unsigned SUB_BUCKETS_BITS = 7;
+constexpr uint64_t SUB_BUCKETS = uint64_t{1} << SUB_BUCKETS_BITS;
+constexpr uint64_t HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+/** Highest power of two that can be recorded (2^40 ns ~ 18 minutes) */
+constexpr unsigned MAX_VALUE_BITS = 40;
+constexpr uint64_t MAX_VALUE = (uint64_t{1} << MAX_VALUE_BITS) - 1;
+constexpr size_t N_BUCKETS = SUB_BUCKETS + (MAX_VALUE_BITS - SUB_BUCKETS_BITS) * HALF_SUB_BUCKETS;
+
+inline unsigned msb(uint64_t v) noexcept
+{
+  unsigned r = 0;
+  while(v >>= 1) { ++r; }
+  return r;
+}
+
+inline size_t bucket_index(uint64_t v) noexcept
+{
+  if(v < SUB_BUCKETS) { return static_cast<size_t>(v); }
+  unsigned shift = msb(v) - SUB_BUCKETS_BITS + 1;
+  return static_cast<size_t>(SUB_BUCKETS + (shift - 1) * HALF_SUB_BUCKETS + ((v >> shift) - HALF_SUB_BUCKETS));
+}
+
+/** Highest value that falls into the given bucket */
+inline uint64_t bucket_upper(size_t idx) noexcept
+{
+  if(idx < SUB_BUCKETS) { return idx; }
+  uint64_t shift = (idx - SUB_BUCKETS) / HALF_SUB_BUCKETS + 1;
+  uint64_t sub = (idx - SUB_BUCKETS) % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS;
+  return ((sub + 1) << shift) - 1;
+}
+
+inline double to_ms(uint64_t ns) noexcept
+{
+  return static_cast<double>(ns) * 1e-6;
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram() : buckets_(N_BUCKETS, 0) {}
+
+void LatencyHistogram::record(double ms) noexcept
+{
+  double ns_d = std::max(ms * 1e6, 0.0);
+  uint64_t ns = ns_d >= static_cast<double>(MAX_VALUE) ? MAX_VALUE : static_cast<uint64_t>(std::llround(ns_d));
+  buckets_[bucket_index(ns)]++;
+  if(count_ == 0 || ns < min_) { min_ = ns; }
+  if(ns > max_) { max_ = ns; }
+  sum_ += ms;
+  count_++;
+}
+
+double LatencyHistogram::min() const noexcept
+{
+  return to_ms(min_);
+}
+
+double LatencyHistogram::max() const noexcept
+{
+  return to_ms(max_);
+}
+
+double LatencyHistogram::mean() const noexcept
+{
+  if(count_ == 0) { return 0.0; }
+  return sum_ / static_cast<double>(count_);
+}
+
+double LatencyHistogram::percentile(double p) const noexcept
+{
+  if(count_ == 0) { return 0.0; }
+  p = std::min(std::max(p, 0.0), 100.0);
+  auto target = static_cast<uint64_t>(std::ceil(p / 100.0 * static_cast<double>(count_)));
+  target = std::max<uint64_t>(target, 1);
+  uint64_t acc = 0;
+  for(size_t i = 0; i < buckets_.size(); ++i)
+  {
+    acc += buckets_[i];
+    if(acc >= target) { return to_ms(std::min(std::max(bucket_upper(i), min_), max_)); }
+  }
+  return max();
+}
+
+void LatencyHistogram::merge(const LatencyHistogram & other) noexcept
+{
+  if(other.count_ == 0) { return; }
+  for(size_t i = 0; i < buckets_.size(); ++i) { buckets_[i] += other.buckets_[i]; }
+  if(count_ == 0 || other.min_ < min_) { min_ = other.min_; }
+  max_ = std::max(max_, other.max_);
+  sum_ += other.sum_;
+  count_ += other.count_;
+}
+
+void LatencyHistogram::reset() noexcept
+{
+  std::fill(buckets_.begin(), buckets_.end(), 0);
+  count_ = 0;
+  min_ = 0;
+  max_ = 0;
+  sum_ = 0;
+}
+
+} // namespace mc_rtc
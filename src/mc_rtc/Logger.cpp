@@ -34,6 +34,8 @@ struct LoggerImpl
   virtual void flush() {}
 
   std::vector<char> data_;
+  /** Size of the data serialized in data_ and not yet written */
+  size_t serialized_size_ = 0;
 
   bfs::path directory;
   std::string tmpl;
@@ -263,6 +265,19 @@ void Logger::open(const std::string & file, double timestep, double start_t)
 }
 
 void Logger::log()
+{
+  serialize();
+  write();
+}
+
+void Logger::write()
+{
+  if(impl_->serialized_size_ == 0) { return; }
+  impl_->write(impl_->data_.data(), impl_->serialized_size_);
+  impl_->serialized_size_ = 0;
+}
+
+void Logger::serialize()
 {
   mc_rtc::MessagePackBuilder builder(impl_->data_);
   builder.start_array(2);
@@ -320,8 +335,7 @@ void Logger::log()
   for(auto & e : log_entries_) { e.log_cb(builder); }
   builder.finish_array();
   builder.finish_array();
-  size_t s = builder.finish();
-  impl_->write(impl_->data_.data(), s);
+  impl_->serialized_size_ = builder.finish();
 }
 
 void Logger::removeLogEntry(const std::string & name)
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rtc/WorkerPool.h>
+
+#include <algorithm>
+
+namespace mc_rtc
+{
+
+namespace
+{
+
+/** Number of jobs being executed by this thread */
+thread_local unsigned jobDepth = 0;
+
+struct JobScope
+{
+  JobScope() noexcept { jobDepth++; }
+  ~JobScope() noexcept { jobDepth--; }
+};
+
+} // namespace
+
+bool WorkerPool::inJob() noexcept
+{
+  return jobDepth > 0;
+}
+
+WorkerPool::WorkerPool(size_t nThreads, std::chrono::microseconds spin) : spin_(spin)
+{
+  if(nThreads == 0) { nThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1); }
+  errors_.resize(nThreads);
+  workers_.reserve(nThreads - 1);
+  for(size_t i = 1; i < nThreads; ++i) { workers_.emplace_back([this, i]() { work(i); }); }
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::unique_lock<std::mutex> lck(mtx_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for(auto & w : workers_) { w.join(); }
+}
+
+void WorkerPool::run(size_t n, void (*fn)(void *, size_t, size_t), void * data)
+{
+  if(n == 0) { return; }
+  if(workers_.empty() || n == 1)
+  {
+    JobScope scope;
+    fn(data, 0, n);
+    return;
+  }
+  n_ = n;
+  fn_ = fn;
+  data_ = data;
+  for(auto & e : errors_) { e = nullptr; }
+  pending_ = workers_.size();
+  generation_++;
+  // A worker that is about to park either sees the new generation or is seen here
+  if(parked_ > 0)
+  {
+    { std::unique_lock<std::mutex> lck(mtx_); }
+    cv_.notify_all();
+  }
+  runRange(0);
+  while(pending_ != 0) { std::this_thread::yield(); }
+  for(auto & e : errors_)
+  {
+    if(e) { std::rethrow_exception(e); }
+  }
+}
+
+void WorkerPool::runRange(size_t participant) noexcept
+{
+  size_t P = size();
+  size_t begin = n_ * participant / P;
+  size_t end = n_ * (participant + 1) / P;
+  if(begin == end) { return; }
+  JobScope scope;
+  try
+  {
+    fn_(data_, begin, end);
+  }
+  catch(...)
+  {
+    errors_[participant] = std::current_exception();
+  }
+}
+
+void WorkerPool::work(size_t idx)
+{
+  uint64_t seen = 0;
+  while(true)
+  {
+    auto start = std::chrono::steady_clock::now();
+    while(generation_ == seen && !stop_)
+    {
+      if(std::chrono::steady_clock::now() - start < spin_) { std::this_thread::yield(); }
+      else
+      {
+        std::unique_lock<std::mutex> lck(mtx_);
+        parked_++;
+        cv_.wait(lck, [&]() { return generation_ != seen || stop_; });
+        parked_--;
+      }
+    }
+    if(stop_) { return; }
+    seen = generation_;
+    runRange(idx);
+    pending_--;
+  }
+}
+
+} // namespace mc_rtc
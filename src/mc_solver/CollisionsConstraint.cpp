@@ -11,8 +11,10 @@
 #include <mc_tvm/CollisionFunction.h>
 
 #include <mc_rbdyn/SCHAddon.h>
+#include <mc_rbdyn/SelfCollisionFilter.h>
 #include <mc_rbdyn/configuration_io.h>
 
+#include <mc_rtc/WorkerPool.h>
 #include <mc_rtc/gui/Arrow.h>
 #include <mc_rtc/gui/Checkbox.h>
 #include <mc_rtc/gui/Label.h>
@@ -38,11 +40,43 @@ struct TVMCollisionConstraint
     mc_rbdyn::Collision collision;
     mc_tvm::CollisionFunctionPtr function;
     tvm::TaskWithRequirementsPtr task;
+    mc_tvm::Convex * c1 = nullptr;
+    mc_tvm::Convex * c2 = nullptr;
   };
   /** All collisions handled by this constraint */
   std::vector<CollisionData> data_;
   /** Solver this has been added to */
   mc_solver::TVMQPSolver * solver;
+  /** Pool used to evaluate the collisions in parallel (if any) */
+  std::unique_ptr<mc_rtc::WorkerPool> pool_;
+  /** Convexes involved in the collisions */
+  std::vector<mc_tvm::Convex *> convexes_;
+  bool convexesDirty_ = true;
+
+  /** Compute every collision distance in parallel before the solver graph is updated */
+  void precompute()
+  {
+    if(convexesDirty_)
+    {
+      convexes_.clear();
+      for(const auto & d : data_)
+      {
+        for(auto * c : {d.c1, d.c2})
+        {
+          if(std::find(convexes_.begin(), convexes_.end(), c) == convexes_.end()) { convexes_.push_back(c); }
+        }
+      }
+      convexesDirty_ = false;
+    }
+    // Convexes are shared between collisions so they are moved before the parallel section
+    for(auto * c : convexes_) { c->updateFromRobot(); }
+    pool_->run(data_.size(),
+               [this](size_t i)
+               {
+                 auto & d = data_[i];
+                 if(d.task) { d.function->precompute(); }
+               });
+  }
 
   auto getData(const mc_rbdyn::Collision & col)
   {
@@ -64,7 +98,11 @@ struct TVMCollisionConstraint
       solver.problem().remove(*it->task);
       if constexpr(!Delete) { it->task.reset(); }
     }
-    if constexpr(Delete) { return data_.erase(it); }
+    if constexpr(Delete)
+    {
+      convexesDirty_ = true;
+      return data_.erase(it);
+    }
     else { return it; }
   }
 
@@ -101,9 +139,11 @@ struct TVMCollisionConstraint
   {
     data_.push_back({id, col});
     auto & data = data_.back();
-    auto & c1 = r1.tvmConvex(col.body1);
-    auto & c2 = r2.tvmConvex(col.body2);
-    data.function = std::make_shared<mc_tvm::CollisionFunction>(c1, c2, r1Selector, r2Selector, solver.dt());
+    data.c1 = &r1.tvmConvex(col.body1);
+    data.c2 = &r2.tvmConvex(col.body2);
+    data.function =
+        std::make_shared<mc_tvm::CollisionFunction>(*data.c1, *data.c2, r1Selector, r2Selector, solver.dt());
+    convexesDirty_ = true;
     return data;
   }
 
@@ -151,6 +191,36 @@ bool handle_wildcard(const mc_rbdyn::Robot & robot, const std::string & body, Ca
   return true;
 }
 
+/** Add a collision to the Tasks constraint, the robot with dofs is always the first robot in Tasks */
+static void addTasksCollision(tasks::qp::CollisionConstr & collConstr,
+                              const mc_rbdyn::Robots & robots,
+                              int collId,
+                              unsigned int r1Index,
+                              unsigned int r2Index,
+                              const mc_rbdyn::Collision & col,
+                              const Eigen::VectorXd & r1Selector,
+                              const Eigen::VectorXd & r2Selector)
+{
+  const mc_rbdyn::Robot & r1 = robots.robot(r1Index);
+  const mc_rbdyn::Robot & r2 = robots.robot(r2Index);
+  const auto & body1 = r1.convex(col.body1);
+  const auto & body2 = r2.convex(col.body2);
+  const sva::PTransformd & X_b1_c = r1.collisionTransform(col.body1);
+  const sva::PTransformd & X_b2_c = r2.collisionTransform(col.body2);
+  if(r1.mb().nrDof() == 0)
+  {
+    collConstr.addCollision(robots.mbs(), collId, static_cast<int>(r2Index), body2.first, body2.second.get(), X_b2_c,
+                            static_cast<int>(r1Index), body1.first, body1.second.get(), X_b1_c, col.iDist, col.sDist,
+                            col.damping, CollisionsConstraint::defaultDampingOffset, r2Selector, r1Selector);
+  }
+  else
+  {
+    collConstr.addCollision(robots.mbs(), collId, static_cast<int>(r1Index), body1.first, body1.second.get(), X_b1_c,
+                            static_cast<int>(r2Index), body2.first, body2.second.get(), X_b2_c, col.iDist, col.sDist,
+                            col.damping, CollisionsConstraint::defaultDampingOffset, r1Selector, r2Selector);
+  }
+}
+
 static mc_rtc::void_ptr make_constraint(QPSolver::Backend backend, const mc_rbdyn::Robots & robots, double timeStep)
 {
   switch(backend)
@@ -193,6 +263,10 @@ bool CollisionsConstraint::removeCollision(QPSolver & solver, const std::string
     {
       case QPSolver::Backend::Tasks:
       {
+        auto bp = broadPhaseData_.find(p.first);
+        bool culled = bp != broadPhaseData_.end() && bp->second.culled;
+        if(bp != broadPhaseData_.end()) { broadPhaseData_.erase(bp); }
+        if(culled) { return true; }
         auto collConstr = tasks_constraint(constraint_);
         auto & qpsolver = tasks_solver(solver);
         bool ret = collConstr->rmCollision(p.first);
@@ -235,8 +309,10 @@ bool CollisionsConstraint::removeCollisionByBody(QPSolver & solver,
       {
         case QPSolver::Backend::Tasks:
         {
-          auto collConstr = tasks_constraint(constraint_);
-          collConstr->rmCollision(out.first);
+          auto bp = broadPhaseData_.find(out.first);
+          bool culled = bp != broadPhaseData_.end() && bp->second.culled;
+          if(bp != broadPhaseData_.end()) { broadPhaseData_.erase(bp); }
+          if(!culled) { tasks_constraint(constraint_)->rmCollision(out.first); }
           break;
         }
         case QPSolver::Backend::TVM:
@@ -274,7 +350,9 @@ bool CollisionsConstraint::removeCollisionByBody(QPSolver & solver,
   return toRm.size() > 0;
 }
 
-void CollisionsConstraint::__addCollision(mc_solver::QPSolver & solver, const mc_rbdyn::Collision & col)
+void CollisionsConstraint::__addCollision(mc_solver::QPSolver & solver,
+                                          const mc_rbdyn::Collision & col,
+                                          bool fromWildcard)
 {
   const auto & robots = solver.robots();
   const mc_rbdyn::Robot & r1 = robots.robot(r1Index);
@@ -288,15 +366,27 @@ void CollisionsConstraint::__addCollision(mc_solver::QPSolver & solver, const mc
   {
     auto nCol = col;
     nCol.body1 = nb1;
-    __addCollision(solver, nCol);
+    __addCollision(solver, nCol, true);
   };
   auto on_b2_wildcard = [&](const std::string & nb2)
   {
     auto nCol = col;
     nCol.body2 = nb2;
-    __addCollision(solver, nCol);
+    __addCollision(solver, nCol, true);
   };
   if(handle_wildcard(r1, col.body1, on_b1_wildcard) || handle_wildcard(r2, col.body2, on_b2_wildcard)) { return; }
+  if(fromWildcard && selfCollisionFilter_ && r1Index == r2Index)
+  {
+    // Far pairs are kept if they came within the interaction distance of this collision while sampling
+    const auto * filter = r1.module().selfCollisionFilter();
+    const auto * exclusion = filter ? filter->exclusion(col.body1, col.body2) : nullptr;
+    if(exclusion
+       && (exclusion->reason == mc_rbdyn::SelfCollisionFilter::Reason::Adjacent
+           || exclusion->minDistance > col.iDist + selfCollisionFilterMargin_))
+    {
+      return;
+    }
+  }
   int collId = __createCollId(col);
   if(collId < 0) { return; }
   cols.push_back(col);
@@ -329,23 +419,19 @@ void CollisionsConstraint::__addCollision(mc_solver::QPSolver & solver, const mc
   {
     case QPSolver::Backend::Tasks:
     {
-      auto collConstr = tasks_constraint(constraint_);
-      const auto & body1 = r1.convex(col.body1);
-      const auto & body2 = r2.convex(col.body2);
-      const sva::PTransformd & X_b1_c = r1.collisionTransform(col.body1);
-      const sva::PTransformd & X_b2_c = r2.collisionTransform(col.body2);
-      if(r1.mb().nrDof() == 0)
-      {
-        collConstr->addCollision(robots.mbs(), collId, static_cast<int>(r2Index), body2.first, body2.second.get(),
-                                 X_b2_c, static_cast<int>(r1Index), body1.first, body1.second.get(), X_b1_c, col.iDist,
-                                 col.sDist, col.damping, defaultDampingOffset, r2Selector, r1Selector);
-      }
-      else
+      addTasksCollision(*tasks_constraint(constraint_), robots, collId, r1Index, r2Index, col, r1Selector, r2Selector);
+      auto sphere = [](const mc_rbdyn::Robot & robot, const std::string & cName)
       {
-        collConstr->addCollision(robots.mbs(), collId, static_cast<int>(r1Index), body1.first, body1.second.get(),
-                                 X_b1_c, static_cast<int>(r2Index), body2.first, body2.second.get(), X_b2_c, col.iDist,
-                                 col.sDist, col.damping, defaultDampingOffset, r1Selector, r2Selector);
-      }
+        const auto & convex = robot.convex(cName);
+        BroadPhaseSphere out;
+        out.bodyIndex = robot.bodyIndexByName(convex.first);
+        out.X_b_c = robot.collisionTransform(cName);
+        auto X_0_c = out.X_b_c * robot.mbc().bodyPosW[out.bodyIndex];
+        sch::mc_rbdyn::transform(*convex.second, X_0_c);
+        sch::mc_rbdyn::boundingSphere(*convex.second, X_0_c, out.center, out.radius);
+        return out;
+      };
+      broadPhaseData_[collId] = {col, r1Selector, r2Selector, sphere(r1, col.body1), sphere(r2, col.body2)};
       break;
     }
     case QPSolver::Backend::TVM:
@@ -420,9 +506,21 @@ void CollisionsConstraint::toggleCollisionMonitor(int collId, const mc_rbdyn::Co
       {
         auto collConstr = tasks_constraint(constraint_);
         addMonitor(
-            [collConstr, collId]() { return collConstr->getCollisionData(collId).distance; },
-            [collConstr, collId]() -> const Eigen::Vector3d & { return collConstr->getCollisionData(collId).p1; },
-            [collConstr, collId]() -> const Eigen::Vector3d & { return collConstr->getCollisionData(collId).p2; });
+            [this, collConstr, collId]()
+            {
+              auto culled = culledCollision(collId);
+              return culled ? culled->distance : collConstr->getCollisionData(collId).distance;
+            },
+            [this, collConstr, collId]() -> const Eigen::Vector3d &
+            {
+              auto culled = culledCollision(collId);
+              return culled ? culled->p1 : collConstr->getCollisionData(collId).p1;
+            },
+            [this, collConstr, collId]() -> const Eigen::Vector3d &
+            {
+              auto culled = culledCollision(collId);
+              return culled ? culled->p2 : collConstr->getCollisionData(collId).p2;
+            });
         break;
       }
       case QPSolver::Backend::TVM:
@@ -494,8 +592,115 @@ void CollisionsConstraint::addToSolverImpl(QPSolver & solver)
   for(const auto & cols : collIdDict) { addMonitorButton(cols.second.first, cols.second.second); }
 }
 
-void CollisionsConstraint::update(QPSolver &)
+void CollisionsConstraint::threads(size_t n)
 {
+  threads_ = n;
+  switch(backend_)
+  {
+    case QPSolver::Backend::Tasks:
+      if(n != 1)
+      {
+        mc_rtc::log::warning("[CollisionsConstraint] Parallel evaluation is not supported in Tasks backend");
+      }
+      break;
+    case QPSolver::Backend::TVM:
+    {
+      auto collConstr = tvm_constraint(constraint_);
+      if(n == 1) { collConstr->pool_.reset(); }
+      else { collConstr->pool_ = std::make_unique<mc_rtc::WorkerPool>(n); }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+const CollisionsConstraint::BroadPhaseData * CollisionsConstraint::culledCollision(int collId) const noexcept
+{
+  auto it = broadPhaseData_.find(collId);
+  if(it == broadPhaseData_.end() || !it->second.culled) { return nullptr; }
+  return &it->second;
+}
+
+bool CollisionsConstraint::updateBroadPhase(QPSolver & solver)
+{
+  const auto & robots = solver.robots();
+  const auto & mbc1 = robots.robot(r1Index).mbc();
+  const auto & mbc2 = robots.robot(r2Index).mbc();
+  auto center = [](const rbd::MultiBodyConfig & mbc, const BroadPhaseSphere & s) -> Eigen::Vector3d
+  { return (sva::PTransformd(s.center) * s.X_b_c * mbc.bodyPosW[s.bodyIndex]).translation(); };
+  auto & collConstr = *tasks_constraint(constraint_);
+  bool changed = false;
+  for(auto & [collId, data] : broadPhaseData_)
+  {
+    const auto & col = data.collision;
+    if(!broadPhase_)
+    {
+      if(data.culled)
+      {
+        addTasksCollision(collConstr, robots, collId, r1Index, r2Index, col, data.r1Selector, data.r2Selector);
+        data.culled = false;
+        changed = true;
+      }
+      continue;
+    }
+    Eigen::Vector3d c1 = center(mbc1, data.s1);
+    Eigen::Vector3d c2 = center(mbc2, data.s2);
+    Eigen::Vector3d c12 = c1 - c2;
+    double cDist = c12.norm();
+    double dist = cDist - data.s1.radius - data.s2.radius;
+    if(data.culled && dist < col.iDist + broadPhaseMargin / 2)
+    {
+      addTasksCollision(collConstr, robots, collId, r1Index, r2Index, col, data.r1Selector, data.r2Selector);
+      data.culled = false;
+      changed = true;
+    }
+    else if(!data.culled && dist > col.iDist + broadPhaseMargin)
+    {
+      collConstr.rmCollision(collId);
+      data.culled = true;
+      changed = true;
+    }
+    if(data.culled)
+    {
+      c12 /= cDist;
+      data.distance = dist;
+      data.p1 = c1 - data.s1.radius * c12;
+      data.p2 = c2 + data.s2.radius * c12;
+    }
+  }
+  return changed;
+}
+
+void CollisionsConstraint::update(QPSolver & solver)
+{
+  switch(backend_)
+  {
+    case QPSolver::Backend::Tasks:
+      if(updateBroadPhase(solver))
+      {
+        auto & qpsolver = tasks_solver(solver);
+        tasks_constraint(constraint_)->updateNrVars({}, qpsolver.data());
+        // Deferred until the problem is solved if this runs in an update group
+        qpsolver.updateConstrSize();
+      }
+      break;
+    case QPSolver::Backend::TVM:
+    {
+      auto collConstr = tvm_constraint(constraint_);
+      for(auto & d : collConstr->data_) { d.function->broadPhaseDistance(broadPhase_ ? d.collision.iDist : 0.0); }
+      if(collConstr->pool_)
+      {
+        // The robots are only read in the parallel section
+        solver.robots().robot(r1Index).updateKinematics(mc_rbdyn::Robot::ForwardOrder::Velocity);
+        solver.robots().robot(r2Index).updateKinematics(mc_rbdyn::Robot::ForwardOrder::Velocity);
+        collConstr->precompute();
+      }
+      break;
+    }
+    default:
+      break;
+  }
   if(!autoMonitor_) { return; }
   auto getDistance = [this](int collId)
   {
@@ -503,6 +708,8 @@ void CollisionsConstraint::update(QPSolver &)
     {
       case QPSolver::Backend::Tasks:
       {
+        auto culled = culledCollision(collId);
+        if(culled) { return culled->distance; }
         auto collConstr = tasks_constraint(constraint_);
         return collConstr->getCollisionData(collId).distance;
       }
@@ -552,6 +759,7 @@ void CollisionsConstraint::reset()
 {
   cols.clear();
   collIdDict.clear();
+  broadPhaseData_.clear();
   switch(backend_)
   {
     case QPSolver::Backend::Tasks:
@@ -614,6 +822,10 @@ static auto registered = mc_solver::ConstraintSetLoader::register_load_function(
           solver.robots(), robotIndexFromConfig(config, solver.robots(), "collision", false, "r1Index", "r1", ""),
           robotIndexFromConfig(config, solver.robots(), "collision", false, "r2Index", "r2", ""), solver.dt());
       ret->automaticMonitor(config("automaticMonitor", true));
+      ret->broadPhase(config("broadPhase", false));
+      ret->selfCollisionFilter(config("selfCollisionFilter", true));
+      ret->selfCollisionFilterMargin(config("selfCollisionFilterMargin", ret->selfCollisionFilterMargin()));
+      ret->threads(config("threads", size_t{1}));
       if(ret->r1Index == ret->r2Index)
       {
         if(config("useCommon", false))
@@ -13,4 +13,16 @@ ConstraintSetLoader::storage_t & ConstraintSetLoader::storage()
   return storage_;
 }
 
+ConstraintSetLoader::Handle ConstraintSetLoader::register_load_function(const std::string & type, load_fun fn)
+{
+  return GenericLoader::register_load_function(
+      type,
+      [fn](mc_solver::QPSolver & solver, const mc_rtc::Configuration & config)
+      {
+        auto constraint = fn(solver, config);
+        if(constraint && config.has("updateGroup")) { constraint->updateGroup(config("updateGroup")); }
+        return constraint;
+      });
+}
+
 } // namespace mc_solver
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_solver/utils/ContactsDiff.h>
+
+#include <mc_rbdyn/Surface.h>
+
+#include <algorithm>
+#include <functional>
+
+namespace mc_solver
+{
+
+namespace utils
+{
+
+ContactKey::ContactKey(const mc_rbdyn::Contact & contact)
+: r1Surface(contact.r1Surface()->name()), r2Surface(contact.r2Surface()->name())
+{
+}
+
+size_t ContactKeyHash::operator()(const ContactKey & key) const noexcept
+{
+  size_t h = std::hash<std::string>{}(key.r1Surface);
+  return h ^ (std::hash<std::string>{}(key.r2Surface) + 0x9e3779b9 + (h << 6) + (h >> 2));
+}
+
+ContactsIndex indexContacts(const std::vector<mc_rbdyn::Contact> & contacts)
+{
+  ContactsIndex out;
+  out.reserve(contacts.size());
+  for(size_t i = 0; i < contacts.size(); ++i) { out.emplace(contacts[i], i); }
+  return out;
+}
+
+ContactsDiff::ContactsDiff(const std::vector<mc_rbdyn::Contact> & current, const std::vector<mc_rbdyn::Contact> & next)
+{
+  auto nextIndex = indexContacts(next);
+  std::vector<bool> inCurrent(next.size(), false);
+  for(size_t i = current.size(); i > 0; --i)
+  {
+    auto it = nextIndex.find(current[i - 1]);
+    if(it == nextIndex.end()) { removed.push_back(i - 1); }
+    else
+    {
+      kept.emplace_back(i - 1, it->second);
+      inCurrent[it->second] = true;
+    }
+  }
+  std::reverse(kept.begin(), kept.end());
+  for(size_t i = 0; i < next.size(); ++i)
+  {
+    // Duplicated contacts are only added once
+    if(!inCurrent[i] && nextIndex.at(next[i]) == i) { added.push_back(i); }
+  }
+}
+
+} // namespace utils
+
+} // namespace mc_solver
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_solver/utils/JointsFeedback.h>
+
+#include <algorithm>
+
+namespace mc_solver
+{
+
+namespace utils
+{
+
+namespace
+{
+
+void flatten(const std::vector<std::vector<double>> & in, std::vector<double> & out) noexcept
+{
+  auto it = out.begin();
+  for(const auto & v : in) { it = std::copy(v.begin(), v.end(), it); }
+}
+
+void unflatten(const std::vector<double> & in, std::vector<std::vector<double>> & out) noexcept
+{
+  auto it = in.begin();
+  for(auto & v : out)
+  {
+    std::copy(it, it + static_cast<std::ptrdiff_t>(v.size()), v.begin());
+    it += static_cast<std::ptrdiff_t>(v.size());
+  }
+}
+
+} // namespace
+
+void JointsFeedback::reset(const mc_rbdyn::Robots & robots)
+{
+  if(source_ == &robots && generation_ == robots.generation()) { return; }
+  std::vector<RobotData> data(robots.size());
+  for(size_t i = 0; i < robots.size(); ++i)
+  {
+    const auto & robot = robots.robot(i);
+    auto & d = data[i];
+    d.robot = &robot;
+    const auto & rjo = robot.refJointOrder();
+    d.encoderToJoint.reserve(rjo.size());
+    for(size_t j = 0; j < rjo.size(); ++j)
+    {
+      auto jI = robot.jointIndexInMBC(j);
+      if(jI == -1) { continue; }
+      d.encoderToJoint.emplace_back(j, static_cast<size_t>(jI));
+    }
+    d.q.resize(static_cast<size_t>(robot.mb().nrParams()));
+    d.alpha.resize(static_cast<size_t>(robot.mb().nrDof()));
+    // Keep the encoders history of robots that were already loaded
+    if(source_ == &robots)
+    {
+      auto it = std::find_if(robots_.begin(), robots_.end(),
+                             [&](const RobotData & rd) { return rd.robot == &robot; });
+      if(it != robots_.end() && it->prevEncoders.size() == rjo.size())
+      {
+        d.prevEncoders = std::move(it->prevEncoders);
+        d.encodersAlpha = std::move(it->encodersAlpha);
+      }
+    }
+  }
+  robots_ = std::move(data);
+  source_ = &robots;
+  generation_ = robots.generation();
+}
+
+void JointsFeedback::saveControlState(size_t i, const mc_rbdyn::Robot & robot) noexcept
+{
+  auto & d = robots_[i];
+  flatten(robot.mbc().q, d.q);
+  flatten(robot.mbc().alpha, d.alpha);
+}
+
+void JointsFeedback::restoreControlState(size_t i, mc_rbdyn::Robot & robot) const noexcept
+{
+  const auto & d = robots_[i];
+  unflatten(d.q, robot.mbc().q);
+  unflatten(d.alpha, robot.mbc().alpha);
+}
+
+bool JointsFeedback::applyEncoders(size_t i, mc_rbdyn::Robot & robot, double dt, bool wVelocity)
+{
+  const auto & encoders = robot.encoderValues();
+  if(encoders.empty()) { return false; }
+  auto & d = robots_[i];
+  // FIXME Not correct for every joint types
+  if(d.prevEncoders.size() != encoders.size())
+  {
+    d.prevEncoders = encoders;
+    d.encodersAlpha.resize(encoders.size());
+  }
+  for(size_t j = 0; j < encoders.size(); ++j)
+  {
+    d.encodersAlpha[j] = (encoders[j] - d.prevEncoders[j]) / dt;
+    d.prevEncoders[j] = encoders[j];
+  }
+  auto & q = robot.mbc().q;
+  auto & alpha = robot.mbc().alpha;
+  for(const auto & m : d.encoderToJoint)
+  {
+    if(m.first >= encoders.size()) { break; }
+    q[m.second][0] = encoders[m.first];
+    if(wVelocity) { alpha[m.second][0] = d.encodersAlpha[m.first]; }
+  }
+  return true;
+}
+
+} // namespace utils
+
+} // namespace mc_solver
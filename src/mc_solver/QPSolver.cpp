@@ -13,12 +13,44 @@
 #include <mc_rtc/gui/Button.h>
 #include <mc_rtc/gui/Force.h>
 #include <mc_rtc/gui/Form.h>
+#include <mc_rtc/gui/Table.h>
 
+#include <mc_rtc/WorkerPool.h>
+#include <mc_rtc/clock.h>
 #include <mc_rtc/logging.h>
 
+#include <boost/core/demangle.hpp>
+
+#include <map>
+#include <tuple>
+#include <typeinfo>
+
 namespace mc_solver
 {
 
+namespace
+{
+
+/** Split objects (by index) between update groups and objects updated serially */
+template<typename T>
+void makeUpdateGroups(const std::vector<T *> & objects,
+                      std::vector<std::vector<size_t>> & groups,
+                      std::vector<size_t> & serial)
+{
+  std::map<int, std::vector<size_t>> byGroup;
+  serial.clear();
+  for(size_t i = 0; i < objects.size(); ++i)
+  {
+    int group = objects[i]->updateGroup();
+    if(group < 0) { serial.push_back(i); }
+    else { byGroup[group].push_back(i); }
+  }
+  groups.clear();
+  for(auto & g : byGroup) { groups.push_back(std::move(g.second)); }
+}
+
+} // namespace
+
 static thread_local QPSolver::Backend CONTEXT_BACKEND = QPSolver::Backend::Unset;
 
 QPSolver::Backend QPSolver::context_backend()
@@ -45,6 +77,12 @@ QPSolver::QPSolver(mc_rbdyn::RobotsPtr robots, double timeStep, Backend backend)
 
 QPSolver::QPSolver(double timeStep, Backend backend) : QPSolver{mc_rbdyn::Robots::make(), timeStep, backend} {}
 
+QPSolver::~QPSolver()
+{
+  if(logger_) { removeTimingsFromLogger(); }
+  if(gui_) { gui_->removeElement({"Solver"}, "Timings"); }
+}
+
 void QPSolver::addConstraintSet(ConstraintSet & cs)
 {
   if(cs.backend() != backend_)
@@ -56,6 +94,7 @@ void QPSolver::addConstraintSet(ConstraintSet & cs)
   auto it = std::find(constraints_.begin(), constraints_.end(), &cs);
   if(it != constraints_.end()) { return; }
   constraints_.push_back(&cs);
+  updatePlanDirty_ = true;
   cs.addToSolver(*this);
   if(dynamic_cast<DynamicsConstraint *>(&cs) != nullptr)
   {
@@ -74,6 +113,7 @@ void QPSolver::removeConstraintSet(ConstraintSet & cs)
   auto it = std::find(constraints_.begin(), constraints_.end(), &cs);
   if(it == constraints_.end()) { return; }
   constraints_.erase(it);
+  updatePlanDirty_ = true;
   cs.removeFromSolver(*this);
   removeDynamicsConstraint(&cs);
 }
@@ -88,9 +128,15 @@ void QPSolver::addTask(mc_tasks::MetaTask * task)
                                    task->backend(), backend_);
     }
     metaTasks_.push_back(task);
+    taskTimings_.push_back(std::make_unique<double>(0.0));
+    updatePlanDirty_ = true;
     task->addToSolver(*this);
     task->resetIterInSolver();
-    if(logger_) { task->addToLogger(*logger_); }
+    if(logger_)
+    {
+      task->addToLogger(*logger_);
+      addTaskTimingToLogger(metaTasks_.size() - 1);
+    }
     if(gui_) { addTaskToGUI(task); }
     mc_rtc::log::info("Added task {}", task->name());
   }
@@ -107,12 +153,19 @@ void QPSolver::removeTask(mc_tasks::MetaTask * task)
           "[QPSolver::removeTask] Task backend ({}) is different from this solver backend ({})", task->backend(),
           backend_);
     }
+    auto idx = static_cast<size_t>(std::distance(metaTasks_.begin(), it));
     task->removeFromSolver(*this);
     task->resetIterInSolver();
-    if(logger_) { task->removeFromLogger(*logger_); }
+    if(logger_)
+    {
+      task->removeFromLogger(*logger_);
+      logger_->removeLogEntries(taskTimings_[idx].get());
+    }
     if(gui_) { task->removeFromGUI(*gui_); }
     mc_rtc::log::info("Removed task {}", task->name());
     metaTasks_.erase(it);
+    taskTimings_.erase(taskTimings_.begin() + static_cast<std::ptrdiff_t>(idx));
+    updatePlanDirty_ = true;
     shPtrTasksStorage.erase(std::remove_if(shPtrTasksStorage.begin(), shPtrTasksStorage.end(),
                                            [task](const std::shared_ptr<void> & p) { return task == p.get(); }),
                             shPtrTasksStorage.end());
@@ -121,7 +174,86 @@ void QPSolver::removeTask(mc_tasks::MetaTask * task)
 
 bool QPSolver::run(FeedbackType fType)
 {
-  return run_impl(fType);
+  auto start_t = mc_rtc::clock::now();
+  // Only set by the implementations when the solve succeeds
+  timings_.robots = 0;
+  // The backends read the robots' mbc directly
+  robots_p->updateKinematics();
+  realRobots_p->updateKinematics();
+  auto r = run_impl(fType);
+  timings_.total = mc_rtc::duration_ms(mc_rtc::clock::now() - start_t).count();
+  return r;
+}
+
+void QPSolver::parallelUpdate(size_t threads)
+{
+  if(threads > 1) { updatePool_ = std::make_unique<mc_rtc::WorkerPool>(threads); }
+  else { updatePool_.reset(); }
+  updatePlanDirty_ = true;
+}
+
+size_t QPSolver::parallelUpdate() const noexcept
+{
+  return updatePool_ ? updatePool_->size() : 1;
+}
+
+void QPSolver::updateConstraint(size_t i)
+{
+  auto start_t = mc_rtc::clock::now();
+  constraints_[i]->update(*this);
+  timings_.constraints[i] = mc_rtc::duration_ms(mc_rtc::clock::now() - start_t).count();
+}
+
+void QPSolver::updateTask(size_t i)
+{
+  auto start_t = mc_rtc::clock::now();
+  auto & t = *metaTasks_[i];
+  t.update(*this);
+  t.incrementIterInSolver();
+  timings_.tasks[i] = mc_rtc::duration_ms(mc_rtc::clock::now() - start_t).count();
+  *taskTimings_[i] = timings_.tasks[i];
+}
+
+void QPSolver::updateConstrsAndTasks()
+{
+  auto start_t = mc_rtc::clock::now();
+  // The feedback modes modify the state after run() started, this also makes the robots read-only in the parallel
+  // update
+  robots_p->updateKinematics();
+  timings_.constraints.resize(constraints_.size());
+  timings_.tasks.resize(metaTasks_.size());
+  if(!updatePool_)
+  {
+    for(size_t i = 0; i < constraints_.size(); ++i) { updateConstraint(i); }
+    for(size_t i = 0; i < metaTasks_.size(); ++i) { updateTask(i); }
+    timings_.update = mc_rtc::duration_ms(mc_rtc::clock::now() - start_t).count();
+    return;
+  }
+  if(updatePlanDirty_)
+  {
+    makeUpdateGroups(constraints_, updatePlan_.constraintGroups, updatePlan_.constraints);
+    makeUpdateGroups(metaTasks_, updatePlan_.taskGroups, updatePlan_.tasks);
+    updatePlanDirty_ = false;
+  }
+  if(updatePlan_.constraintGroups.size())
+  {
+    updatePool_->run(updatePlan_.constraintGroups.size(),
+                     [this](size_t i)
+                     {
+                       for(auto c : updatePlan_.constraintGroups[i]) { updateConstraint(c); }
+                     });
+  }
+  for(auto c : updatePlan_.constraints) { updateConstraint(c); }
+  if(updatePlan_.taskGroups.size())
+  {
+    updatePool_->run(updatePlan_.taskGroups.size(),
+                     [this](size_t i)
+                     {
+                       for(auto t : updatePlan_.taskGroups[i]) { updateTask(t); }
+                     });
+  }
+  for(auto t : updatePlan_.tasks) { updateTask(t); }
+  timings_.update = mc_rtc::duration_ms(mc_rtc::clock::now() - start_t).count();
 }
 
 const mc_rbdyn::Robot & QPSolver::robot() const
@@ -183,11 +315,13 @@ void QPSolver::logger(std::shared_ptr<mc_rtc::Logger> logger)
   if(logger_)
   {
     for(auto t : metaTasks_) { t->removeFromLogger(*logger_); }
+    removeTimingsFromLogger();
   }
   logger_ = logger;
   if(logger_)
   {
     for(auto t : metaTasks_) { t->addToLogger(*logger_); }
+    addTimingsToLogger();
   }
 }
 
@@ -201,11 +335,13 @@ void QPSolver::gui(std::shared_ptr<mc_rtc::gui::StateBuilder> gui)
   if(gui_)
   {
     for(auto t : metaTasks_) { t->removeFromGUI(*gui_); }
+    gui_->removeElement({"Solver"}, "Timings");
   }
   gui_ = gui;
   if(gui_)
   {
     for(auto t : metaTasks_) { addTaskToGUI(t); }
+    addTimingsToGUI();
   }
 }
 
@@ -223,4 +359,60 @@ void QPSolver::addTaskToGUI(mc_tasks::MetaTask * t)
                    mc_rtc::gui::Button("Remove from solver", [this, t]() { this->removeTask(t); }));
 }
 
+void QPSolver::addTimingsToLogger()
+{
+  assert(logger_);
+  logger_->addLogEntry("perf_QPSolver_update", this, [this]() { return timings_.update; });
+  logger_->addLogEntry("perf_QPSolver_build", this, [this]() { return timings_.build; });
+  logger_->addLogEntry("perf_QPSolver_solve", this, [this]() { return timings_.solve; });
+  logger_->addLogEntry("perf_QPSolver_robots", this, [this]() { return timings_.robots; });
+  logger_->addLogEntry("perf_QPSolver_total", this, [this]() { return timings_.total; });
+  logger_->addLogEntry("perf_QPSolver_constraints", this,
+                       [this]() -> const std::vector<double> & { return timings_.constraints; });
+  for(size_t i = 0; i < metaTasks_.size(); ++i) { addTaskTimingToLogger(i); }
+}
+
+void QPSolver::removeTimingsFromLogger()
+{
+  assert(logger_);
+  logger_->removeLogEntries(this);
+  for(const auto & slot : taskTimings_) { logger_->removeLogEntries(slot.get()); }
+}
+
+void QPSolver::addTaskTimingToLogger(size_t i)
+{
+  assert(logger_);
+  const double * slot = taskTimings_[i].get();
+  logger_->addLogEntry("perf_QPSolver_task_" + metaTasks_[i]->name(), slot, [slot]() { return *slot; }, true);
+}
+
+void QPSolver::addTimingsToGUI()
+{
+  assert(gui_);
+  gui_->addElement({"Solver"},
+                   mc_rtc::gui::Table("Timings", {"Name", "Time [ms]"}, {"{}", "{:.3f}"},
+                                      [this]()
+                                      {
+                                        std::vector<std::tuple<std::string, double>> data;
+                                        data.emplace_back("Total", timings_.total);
+                                        data.emplace_back("Update", timings_.update);
+                                        data.emplace_back("Build", timings_.build);
+                                        data.emplace_back("Solve", timings_.solve);
+                                        data.emplace_back("Robots", timings_.robots);
+                                        for(size_t i = 0; i < metaTasks_.size() && i < timings_.tasks.size(); ++i)
+                                        {
+                                          data.emplace_back("Task: " + metaTasks_[i]->name(), timings_.tasks[i]);
+                                        }
+                                        for(size_t i = 0;
+                                            i < constraints_.size() && i < timings_.constraints.size(); ++i)
+                                        {
+                                          const auto & c = *constraints_[i];
+                                          data.emplace_back(fmt::format("Constraint {}: {}", i,
+                                                                        boost::core::demangle(typeid(c).name())),
+                                                            timings_.constraints[i]);
+                                        }
+                                        return data;
+                                      }));
+}
+
 } // namespace mc_solver
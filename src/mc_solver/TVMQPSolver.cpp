@@ -37,36 +37,32 @@ TVMQPSolver::TVMQPSolver(double dt) : QPSolver(dt, Backend::TVM), solver_(tvm::s
 
 size_t TVMQPSolver::getContactIdx(const mc_rbdyn::Contact & contact)
 {
-  for(size_t i = 0; i < contacts_.size(); ++i)
-  {
-    if(contacts_[i] == contact) { return i; }
-  }
+  auto it = contactsIndex_.find(contact);
+  if(it != contactsIndex_.end()) { return it->second; }
   return contacts_.size();
 }
 
 void TVMQPSolver::setContacts(ControllerToken, const std::vector<mc_rbdyn::Contact> & contacts)
 {
-  for(const auto & c : contacts) { addContact(c); }
-  size_t i = 0;
-  for(auto it = contacts_.begin(); it != contacts_.end();)
-  {
-    const auto & c = *it;
-    if(std::find(contacts.begin(), contacts.end(), c) == contacts.end())
-    {
-      const std::string & r1 = robots().robot(c.r1Index()).name();
-      const std::string & r1S = c.r1Surface()->name();
-      const std::string & r2 = robots().robot(c.r2Index()).name();
-      const std::string & r2S = c.r2Surface()->name();
-      logger_->removeLogEntry("contact_" + r1 + "::" + r1S + "_" + r2 + "::" + r2S);
-      if(gui_) { gui_->removeElement({"Contacts", "Forces"}, fmt::format("{}::{}/{}::{}", r1, r1S, r2, r2S)); }
-      it = removeContact(i);
-    }
-    else
-    {
-      ++i;
-      ++it;
-    }
-  }
+  robots_p->updateKinematics();
+  utils::ContactsDiff diff(contacts_, contacts);
+  removeContacts(diff.removed);
+  for(const auto & k : diff.kept) { addContact(contacts[k.second]); }
+  for(auto i : diff.added) { addContact(contacts[i]); }
+  resumeDynamics();
+}
+
+void TVMQPSolver::suspendDynamics(DynamicsConstraint * dyn)
+{
+  if(std::find(suspendedDynamics_.begin(), suspendedDynamics_.end(), dyn) != suspendedDynamics_.end()) { return; }
+  dyn->removeFromSolverImpl(*this);
+  suspendedDynamics_.push_back(dyn);
+}
+
+void TVMQPSolver::resumeDynamics()
+{
+  for(auto * dyn : suspendedDynamics_) { dyn->addToSolverImpl(*this); }
+  suspendedDynamics_.clear();
 }
 
 const sva::ForceVecd TVMQPSolver::desiredContactForce(const mc_rbdyn::Contact & id) const
@@ -112,15 +108,12 @@ bool TVMQPSolver::run_impl(FeedbackType fType)
 
 bool TVMQPSolver::runCommon()
 {
-  for(auto & c : constraints_) { c->update(*this); }
-  for(auto & t : metaTasks_)
-  {
-    t->update(*this);
-    t->incrementIterInSolver();
-  }
+  updateConstrsAndTasks();
   auto start_t = mc_rtc::clock::now();
   auto r = solver_.solve(problem_);
   solve_dt_ = mc_rtc::clock::now() - start_t;
+  timings_.build = 0;
+  timings_.solve = solve_dt_.count();
   return r;
 }
 
@@ -128,11 +121,13 @@ bool TVMQPSolver::runOpenLoop()
 {
   if(runCommon())
   {
+    auto robots_start_t = mc_rtc::clock::now();
     for(auto & robot : *robots_p)
     {
       auto & mb = robot.mb();
       if(mb.nrDof() > 0) { updateRobot(robot); }
     }
+    timings_.robots = mc_rtc::duration_ms(mc_rtc::clock::now() - robots_start_t).count();
     return true;
   }
   return false;
@@ -140,55 +135,27 @@ bool TVMQPSolver::runOpenLoop()
 
 bool TVMQPSolver::runJointsFeedback(bool wVelocity)
 {
-  if(control_q_.size() < robots().size())
-  {
-    prev_encoders_.resize(robots().size());
-    encoders_alpha_.resize(robots().size());
-    control_q_.resize(robots().size());
-    control_alpha_.resize(robots().size());
-  }
+  feedback_.reset(robots());
   for(size_t i = 0; i < robots().size(); ++i)
   {
     auto & robot = robots_p->robot(i);
-    control_q_[i] = robot.q();
-    control_alpha_[i] = robot.alpha();
-    const auto & encoders = robot.encoderValues();
-    if(encoders.size())
+    feedback_.saveControlState(i, robot);
+    if(feedback_.applyEncoders(i, robot, timeStep, wVelocity))
     {
-      // FIXME Not correct for every joint types
-      if(prev_encoders_[i].size() == 0)
-      {
-        prev_encoders_[i] = robot.encoderValues();
-        encoders_alpha_[i].resize(prev_encoders_[i].size());
-      }
-      for(size_t j = 0; j < encoders.size(); ++j)
-      {
-        encoders_alpha_[i][j] = (encoders[j] - prev_encoders_[i][j]) / timeStep;
-        prev_encoders_[i][j] = encoders[j];
-      }
-      const auto & rjo = robot.module().ref_joint_order();
-      for(size_t j = 0; j < rjo.size(); ++j)
-      {
-        auto jI = robot.jointIndexInMBC(j);
-        if(jI == -1) { continue; }
-        robot.q()[static_cast<size_t>(jI)][0] = encoders[j];
-        if(wVelocity) { robot.alpha()[static_cast<size_t>(jI)][0] = encoders_alpha_[i][j]; }
-      }
-      robot.forwardKinematics();
-      robot.forwardVelocity();
-      robot.forwardAcceleration();
+      robot.forwardAll();
     }
   }
   if(runCommon())
   {
+    auto robots_start_t = mc_rtc::clock::now();
     for(size_t i = 0; i < robots_p->size(); ++i)
     {
       auto & robot = robots_p->robot(i);
       if(robot.mb().nrDof() == 0) { continue; }
-      robot.q() = control_q_[i];
-      robot.alpha() = control_alpha_[i];
+      feedback_.restoreControlState(i, robot);
       updateRobot(robot);
     }
+    timings_.robots = mc_rtc::duration_ms(mc_rtc::clock::now() - robots_start_t).count();
     return true;
   }
   return false;
@@ -196,11 +163,7 @@ bool TVMQPSolver::runJointsFeedback(bool wVelocity)
 
 bool TVMQPSolver::runClosedLoop(bool integrateControlState)
 {
-  if(control_q_.size() < robots().size())
-  {
-    control_q_.resize(robots().size());
-    control_alpha_.resize(robots().size());
-  }
+  feedback_.reset(robots());
 
   for(size_t i = 0; i < robots().size(); ++i)
   {
@@ -208,34 +171,26 @@ bool TVMQPSolver::runClosedLoop(bool integrateControlState)
     const auto & realRobot = realRobots().robot(i);
 
     // Save old integrator state
-    if(integrateControlState)
-    {
-      control_q_[i] = robot.mbc().q;
-      control_alpha_[i] = robot.mbc().alpha;
-    }
+    if(integrateControlState) { feedback_.saveControlState(i, robot); }
 
     // Set robot state from estimator
     robot.mbc().q = realRobot.mbc().q;
     robot.mbc().alpha = realRobot.mbc().alpha;
-    robot.forwardKinematics();
-    robot.forwardVelocity();
-    robot.forwardAcceleration();
+    robot.forwardAll();
   }
 
   // Solve QP and integrate
   if(runCommon())
   {
+    auto robots_start_t = mc_rtc::clock::now();
     for(size_t i = 0; i < robots_p->size(); ++i)
     {
       auto & robot = robots_p->robot(i);
       if(robot.mb().nrDof() == 0) { continue; }
-      if(integrateControlState)
-      {
-        robot.q() = control_q_[i];
-        robot.alpha() = control_alpha_[i];
-      }
+      if(integrateControlState) { feedback_.restoreControlState(i, robot); }
       updateRobot(robot);
     }
+    timings_.robots = mc_rtc::duration_ms(mc_rtc::clock::now() - robots_start_t).count();
     return true;
   }
   return false;
@@ -244,12 +199,10 @@ bool TVMQPSolver::runClosedLoop(bool integrateControlState)
 void TVMQPSolver::updateRobot(mc_rbdyn::Robot & robot)
 {
   auto & tvm_robot = robot.tvmRobot();
-  rbd::vectorToParam(tvm_robot.tau()->value(), robot.controlTorque());
-  rbd::vectorToParam(tvm_robot.alphaD()->value(), robot.alphaD());
+  tvm_robot.vectorToDof(tvm_robot.tau()->value(), robot.controlTorque());
+  tvm_robot.vectorToDof(tvm_robot.alphaD()->value(), robot.alphaD());
   robot.eulerIntegration(timeStep);
-  robot.forwardKinematics();
-  robot.forwardVelocity();
-  robot.forwardAcceleration();
+  robot.forwardAll();
 }
 
 void TVMQPSolver::addDynamicsConstraint(mc_solver::DynamicsConstraint * dyn)
@@ -291,6 +244,7 @@ void TVMQPSolver::addDynamicsConstraint(mc_solver::DynamicsConstraint * dyn)
       }
     }
   }
+  resumeDynamics();
 }
 
 void TVMQPSolver::removeDynamicsConstraint(mc_solver::ConstraintSet * maybe_dyn)
@@ -345,10 +299,9 @@ void TVMQPSolver::addContactToDynamics(const std::string & robot,
   }
   else
   {
-    it->second->removeFromSolverImpl(*this);
+    suspendDynamics(it->second);
     auto & dyn = it->second->dynamicFunction();
     forces = dyn.addContact(frame, points, dir);
-    it->second->addToSolverImpl(*this);
   }
   for(int i = 0; i < forces.numberOfVariables(); ++i)
   {
@@ -374,6 +327,7 @@ auto TVMQPSolver::addVirtualContactImpl(const mc_rbdyn::Contact & contact) -> st
   else
   {
     hasWork = true;
+    contactsIndex_.emplace(contact, contacts_.size());
     contacts_.push_back(contact);
   }
   auto & data = idx < contactsData_.size() ? contactsData_[idx] : contactsData_.emplace_back();
@@ -386,12 +340,16 @@ auto TVMQPSolver::addVirtualContactImpl(const mc_rbdyn::Contact & contact) -> st
     auto contact_fn = std::make_shared<mc_tvm::ContactFunction>(f1, f2, contact.dof());
     data.contactConstraint_ = problem_.add(contact_fn == 0., tvm::task_dynamics::PD(1.0 / dt(), 1.0 / dt()),
                                            {tvm::requirements::PriorityLevel(0)});
-    logger_->addLogEntry(fmt::format("contact_{}::{}_{}::{}", r1.name(), f1.name(), r2.name(), f2.name()),
-                         [this, contact]() { return desiredContactForce(contact); });
-    gui_->addElement({"Contacts", "Forces"},
-                     mc_rtc::gui::Force(
-                         fmt::format("{}::{}/{}::{}", r1.name(), f1.name(), r2.name(), f2.name()), [this, contact]()
-                         { return desiredContactForce(contact); }, [&f1]() { return f1.position(); }));
+    data.logEntry_ = fmt::format("contact_{}::{}_{}::{}", r1.name(), f1.name(), r2.name(), f2.name());
+    data.guiEntry_ = fmt::format("{}::{}/{}::{}", r1.name(), f1.name(), r2.name(), f2.name());
+    if(logger_) { logger_->addLogEntry(data.logEntry_, [this, contact]() { return desiredContactForce(contact); }); }
+    if(gui_)
+    {
+      gui_->addElement({"Contacts", "Forces"},
+                       mc_rtc::gui::Force(
+                           data.guiEntry_, [this, contact]() { return desiredContactForce(contact); },
+                           [&f1]() { return f1.position(); }));
+    }
   }
   else
   {
@@ -434,35 +392,35 @@ void TVMQPSolver::addContact(const mc_rbdyn::Contact & contact)
   addContactForce(r2.name(), f2, s2Points, data.f2_, data.f2Constraints_, -1.0);
 }
 
-auto TVMQPSolver::removeContact(size_t idx) -> ContactIterator
+void TVMQPSolver::removeContacts(const std::vector<size_t> & indices)
 {
-  auto & contact = contacts_[idx];
-  auto & data = contactsData_[idx];
-  const auto & r1 = robot(contact.r1Index());
-  auto r1DynamicsIt = dynamics_.find(r1.name());
-  if(r1DynamicsIt != dynamics_.end())
-  {
-    r1DynamicsIt->second->removeFromSolverImpl(*this);
-    r1DynamicsIt->second->dynamicFunction().removeContact(r1.frame(contact.r1Surface()->name()));
-    r1DynamicsIt->second->addToSolverImpl(*this);
-  }
-  const auto & r2 = robot(contact.r2Index());
-  auto r2DynamicsIt = dynamics_.find(r2.name());
-  if(r2DynamicsIt != dynamics_.end())
+  if(indices.empty()) { return; }
+  for(auto idx : indices)
   {
-    r2DynamicsIt->second->removeFromSolverImpl(*this);
-    r2DynamicsIt->second->dynamicFunction().removeContact(r2.frame(contact.r2Surface()->name()));
-    r2DynamicsIt->second->addToSolverImpl(*this);
-  }
-  for(const auto & c : data.f1Constraints_) { problem_.remove(*c); }
-  for(const auto & c : data.f2Constraints_) { problem_.remove(*c); }
-  if(data.contactConstraint_)
-  {
-    problem_.remove(*data.contactConstraint_);
-    data.contactConstraint_.reset();
+    auto & contact = contacts_[idx];
+    auto & data = contactsData_[idx];
+    auto removeFromDynamics = [&](const mc_rbdyn::Robot & r, const std::string & surface)
+    {
+      auto it = dynamics_.find(r.name());
+      if(it == dynamics_.end()) { return; }
+      suspendDynamics(it->second);
+      it->second->dynamicFunction().removeContact(r.frame(surface));
+    };
+    removeFromDynamics(robot(contact.r1Index()), contact.r1Surface()->name());
+    removeFromDynamics(robot(contact.r2Index()), contact.r2Surface()->name());
+    for(const auto & c : data.f1Constraints_) { problem_.remove(*c); }
+    for(const auto & c : data.f2Constraints_) { problem_.remove(*c); }
+    if(data.contactConstraint_)
+    {
+      problem_.remove(*data.contactConstraint_);
+      data.contactConstraint_.reset();
+    }
+    if(logger_) { logger_->removeLogEntry(data.logEntry_); }
+    if(gui_) { gui_->removeElement({"Contacts", "Forces"}, data.guiEntry_); }
+    contactsData_.erase(contactsData_.begin() + static_cast<decltype(contacts_)::difference_type>(idx));
+    contacts_.erase(contacts_.begin() + static_cast<decltype(contacts_)::difference_type>(idx));
   }
-  contactsData_.erase(contactsData_.begin() + static_cast<decltype(contacts_)::difference_type>(idx));
-  return contacts_.erase(contacts_.begin() + static_cast<decltype(contacts_)::difference_type>(idx));
+  contactsIndex_ = utils::indexContacts(contacts_);
 }
 
 } // namespace mc_solver
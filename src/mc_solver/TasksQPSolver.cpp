@@ -1,15 +1,20 @@
 #include <mc_solver/TasksQPSolver.h>
 
+#include <mc_rtc/WorkerPool.h>
+#include <mc_rtc/clock.h>
 #include <mc_rtc/gui.h>
 #include <mc_rtc/log/Logger.h>
 
 #include <mc_solver/ConstraintSet.h>
 #include <mc_solver/DynamicsConstraint.h>
+#include <mc_solver/utils/ContactsDiff.h>
 
 #include <mc_tasks/MetaTask.h>
 
 #include <boost/chrono.hpp>
 
+#include <algorithm>
+
 namespace mc_solver
 {
 
@@ -47,80 +52,89 @@ Eigen::VectorXd TasksQPSolver::lambdaVec(int cIndex) const
 
 void TasksQPSolver::setContacts(ControllerToken, const std::vector<mc_rbdyn::Contact> & contacts)
 {
-  if(logger_)
+  robots_p->updateKinematics();
+  std::vector<mc_rbdyn::Contact> next = contacts;
+  for(auto & c : next)
   {
-    for(const auto & contact : contacts_)
-    {
-      const std::string & r1 = robots().robot(contact.r1Index()).name();
-      const std::string & r1S = contact.r1Surface()->name();
-      const std::string & r2 = robots().robot(contact.r2Index()).name();
-      const std::string & r2S = contact.r2Surface()->name();
-      logger_->removeLogEntry("contact_" + r1 + "::" + r1S + "_" + r2 + "::" + r2S);
-    }
+    const auto & r1 = robots().robot(c.r1Index());
+    if(r1.mb().nrDof() == 0) { c = c.swap(robots()); }
   }
-  if(gui_)
+  utils::ContactsDiff diff(contacts_, next);
+  auto sameParameters = [&](const std::pair<size_t, size_t> & k)
   {
-    for(const auto & contact : contacts_)
-    {
-      const std::string & r1 = robots().robot(contact.r1Index()).name();
-      const std::string & r1S = contact.r1Surface()->name();
-      const std::string & r2 = robots().robot(contact.r2Index()).name();
-      const std::string & r2S = contact.r2Surface()->name();
-      gui_->removeElement({"Contacts", "Forces"}, fmt::format("{}::{}/{}::{}", r1, r1S, r2, r2S));
-    }
-  }
-  contacts_ = contacts;
-  for(auto & c : contacts_)
+    const auto & lhs = contacts_[k.first];
+    const auto & rhs = next[k.second];
+    return lhs.r1Index() == rhs.r1Index() && lhs.r2Index() == rhs.r2Index() && lhs.friction() == rhs.friction()
+           && lhs.ambiguityId() == rhs.ambiguityId() && lhs.X_r2s_r1s() == rhs.X_r2s_r1s()
+           && lhs.X_b_s() == rhs.X_b_s();
+  };
+  bool sameParams = std::all_of(diff.kept.begin(), diff.kept.end(), sameParameters);
+  auto logEntry = [this](const mc_rbdyn::Contact & contact)
   {
-    const auto & r1 = robots().robot(c.r1Index());
-    if(r1.mb().nrDof() == 0) { c = c.swap(robots()); }
+    return fmt::format("contact_{}::{}_{}::{}", robots().robot(contact.r1Index()).name(), contact.r1Surface()->name(),
+                       robots().robot(contact.r2Index()).name(), contact.r2Surface()->name());
+  };
+  auto guiEntry = [this](const mc_rbdyn::Contact & contact)
+  {
+    return fmt::format("{}::{}/{}::{}", robots().robot(contact.r1Index()).name(), contact.r1Surface()->name(),
+                       robots().robot(contact.r2Index()).name(), contact.r2Surface()->name());
+  };
+  for(auto i : diff.removed)
+  {
+    if(logger_) { logger_->removeLogEntry(logEntry(contacts_[i])); }
+    if(gui_) { gui_->removeElement({"Contacts", "Forces"}, guiEntry(contacts_[i])); }
   }
-  if(logger_)
+  for(auto i : diff.added)
   {
-    for(const auto & contact : contacts_)
+    const auto & contact = next[i];
+    if(logger_)
     {
-      const std::string & r1 = robots().robot(contact.r1Index()).name();
-      const std::string & r1S = contact.r1Surface()->name();
-      const std::string & r2 = robots().robot(contact.r2Index()).name();
-      const std::string & r2S = contact.r2Surface()->name();
-      logger_->addLogEntry("contact_" + r1 + "::" + r1S + "_" + r2 + "::" + r2S,
-                           [this, &contact]() { return desiredContactForce(contact); });
+      logger_->addLogEntry(logEntry(contact), [this, contact]() { return desiredContactForce(contact); });
     }
-  }
-  if(gui_)
-  {
-    for(const auto & contact : contacts_)
+    if(gui_)
     {
-      const std::string & r1 = robots().robot(contact.r1Index()).name();
-      const std::string & r1S = contact.r1Surface()->name();
-      const std::string & r2 = robots().robot(contact.r2Index()).name();
-      const std::string & r2S = contact.r2Surface()->name();
       gui_->addElement({"Contacts", "Forces"},
                        mc_rtc::gui::Force(
-                           fmt::format("{}::{}/{}::{}", r1, r1S, r2, r2S),
-                           [this, &contact]() { return desiredContactForce(contact); }, [this, &contact]()
+                           guiEntry(contact), [this, contact]() { return desiredContactForce(contact); },
+                           [this, contact]()
                            { return robots().robot(contact.r1Index()).surfacePose(contact.r1Surface()->name()); }));
     }
   }
-  uniContacts_.clear();
-  biContacts_.clear();
-
+  contacts_ = std::move(next);
+  std::vector<tasks::qp::UnilateralContact> uniContacts;
+  std::vector<tasks::qp::BilateralContact> biContacts;
   for(const mc_rbdyn::Contact & c : contacts_)
   {
     QPContactPtr qcptr = c.taskContact(*robots_p);
     if(qcptr.unilateralContact)
     {
-      uniContacts_.push_back(tasks::qp::UnilateralContact(*qcptr.unilateralContact));
+      uniContacts.push_back(tasks::qp::UnilateralContact(*qcptr.unilateralContact));
       delete qcptr.unilateralContact;
       qcptr.unilateralContact = 0;
     }
     else
     {
-      biContacts_.push_back(tasks::qp::BilateralContact(*qcptr.bilateralContact));
+      biContacts.push_back(tasks::qp::BilateralContact(*qcptr.bilateralContact));
       delete qcptr.bilateralContact;
       qcptr.bilateralContact = 0;
     }
   }
+  // The relative pose of the contact bodies is taken from the current robots' state, a re-submitted contact set must
+  // refresh the solver contacts unless the bodies did not move since the previous call
+  auto sameGeometry = [](const auto & lhs, const auto & rhs)
+  {
+    return lhs.size() == rhs.size()
+           && std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](const auto & l, const auto & r)
+                         { return l.X_b1_b2 == r.X_b1_b2 && l.r1Points == r.r1Points; });
+  };
+  // Variables and constraints do not need to be re-sized if the contacts did not change
+  if(diff.sameContacts() && sameParams && sameGeometry(uniContacts_, uniContacts)
+     && sameGeometry(biContacts_, biContacts))
+  {
+    return;
+  }
+  uniContacts_ = std::move(uniContacts);
+  biContacts_ = std::move(biContacts);
 
   solver_.nrVars(robots_p->mbs(), uniContacts_, biContacts_);
   updateConstrSize();
@@ -187,16 +201,21 @@ bool TasksQPSolver::run_impl(FeedbackType fType)
   return success;
 }
 
+bool TasksQPSolver::solve()
+{
+  if(constrSizePending_.exchange(false)) { solver_.updateConstrSize(); }
+  bool r = solver_.solveNoMbcUpdate(robots_p->mbs(), robots_p->mbcs());
+  timings_.solve = solveTime();
+  timings_.build = solveAndBuildTime() - timings_.solve;
+  return r;
+}
+
 bool TasksQPSolver::runOpenLoop()
 {
-  for(auto & c : constraints_) { c->update(*this); }
-  for(auto & t : metaTasks_)
-  {
-    t->update(*this);
-    t->incrementIterInSolver();
-  }
-  if(solver_.solveNoMbcUpdate(robots_p->mbs(), robots_p->mbcs()))
+  updateConstrsAndTasks();
+  if(solve())
   {
+    auto robots_start_t = mc_rtc::clock::now();
     for(size_t i = 0; i < robots_p->mbs().size(); ++i)
     {
       auto & robot = robots().robot(i);
@@ -204,11 +223,10 @@ bool TasksQPSolver::runOpenLoop()
       {
         solver_.updateMbc(robot.mbc(), static_cast<int>(i));
         robot.eulerIntegration(timeStep);
-        robot.forwardKinematics();
-        robot.forwardVelocity();
-        robot.forwardAcceleration();
+        robot.forwardAll();
       }
     }
+    timings_.robots = mc_rtc::duration_ms(mc_rtc::clock::now() - robots_start_t).count();
     return true;
   }
   return false;
@@ -216,71 +234,37 @@ bool TasksQPSolver::runOpenLoop()
 
 bool TasksQPSolver::runJointsFeedback(bool wVelocity)
 {
-  if(control_q_.size() < robots().size())
-  {
-    prev_encoders_.resize(robots().size());
-    encoders_alpha_.resize(robots().size());
-    control_q_.resize(robots().size());
-    control_alpha_.resize(robots().size());
-  }
+  feedback_.reset(robots());
   for(size_t i = 0; i < robots().size(); ++i)
   {
     auto & robot = robots().robot(i);
-    control_q_[i] = robot.mbc().q;
-    control_alpha_[i] = robot.mbc().alpha;
-    const auto & encoders = robot.encoderValues();
-    if(encoders.size())
+    feedback_.saveControlState(i, robot);
+    if(logger_ && i == 0 && robot.encoderValues().size() && feedback_.encodersAlpha(0).empty())
     {
-      // FIXME Not correct for every joint types
-      if(prev_encoders_[i].size() == 0)
-      {
-        prev_encoders_[i] = robot.encoderValues();
-        encoders_alpha_[i].resize(prev_encoders_[i].size());
-        if(logger_ && i == 0)
-        {
-          logger_->addLogEntry("alphaIn", [this]() -> const std::vector<double> & { return encoders_alpha_[0]; });
-        }
-      }
-      for(size_t j = 0; j < encoders.size(); ++j)
-      {
-        encoders_alpha_[i][j] = (encoders[j] - prev_encoders_[i][j]) / timeStep;
-        prev_encoders_[i][j] = encoders[j];
-      }
-      for(size_t j = 0; j < robot.refJointOrder().size(); ++j)
-      {
-        const auto & jN = robot.refJointOrder()[j];
-        if(!robot.hasJoint(jN)) { continue; }
-        auto jI = robot.jointIndexByName(jN);
-        robot.mbc().q[jI][0] = encoders[j];
-        if(wVelocity) { robot.mbc().alpha[jI][0] = encoders_alpha_[i][j]; }
-      }
-      robot.forwardKinematics();
-      robot.forwardVelocity();
-      robot.forwardAcceleration();
+      logger_->addLogEntry(
+          "alphaIn", [this]() -> const std::vector<double> & { return feedback_.encodersAlpha(0); }, true);
+    }
+    if(feedback_.applyEncoders(i, robot, timeStep, wVelocity))
+    {
+      robot.forwardAll();
     }
   }
-  for(auto & c : constraints_) { c->update(*this); }
-  for(auto & t : metaTasks_)
-  {
-    t->update(*this);
-    t->incrementIterInSolver();
-  }
-  if(solver_.solveNoMbcUpdate(robots_p->mbs(), robots_p->mbcs()))
+  updateConstrsAndTasks();
+  if(solve())
   {
+    auto robots_start_t = mc_rtc::clock::now();
     for(size_t i = 0; i < robots_p->mbs().size(); ++i)
     {
       auto & robot = robots().robot(i);
-      robot.mbc().q = control_q_[i];
-      robot.mbc().alpha = control_alpha_[i];
+      feedback_.restoreControlState(i, robot);
       if(robot.mb().nrDof() > 0)
       {
         solver_.updateMbc(robot.mbc(), static_cast<int>(i));
         robot.eulerIntegration(timeStep);
-        robot.forwardKinematics();
-        robot.forwardVelocity();
-        robot.forwardAcceleration();
+        robot.forwardAll();
       }
     }
+    timings_.robots = mc_rtc::duration_ms(mc_rtc::clock::now() - robots_start_t).count();
     return true;
   }
   return false;
@@ -288,11 +272,7 @@ bool TasksQPSolver::runJointsFeedback(bool wVelocity)
 
 bool TasksQPSolver::runClosedLoop(bool integrateControlState)
 {
-  if(control_q_.size() < robots().size())
-  {
-    control_q_.resize(robots().size());
-    control_alpha_.resize(robots().size());
-  }
+  feedback_.reset(robots());
 
   for(size_t i = 0; i < robots().size(); ++i)
   {
@@ -300,48 +280,33 @@ bool TasksQPSolver::runClosedLoop(bool integrateControlState)
     const auto & realRobot = realRobots().robot(i);
 
     // Save old integrator state
-    if(integrateControlState)
-    {
-      control_q_[i] = robot.mbc().q;
-      control_alpha_[i] = robot.mbc().alpha;
-    }
+    if(integrateControlState) { feedback_.saveControlState(i, robot); }
 
     // Set robot state from estimator
     robot.mbc().q = realRobot.mbc().q;
     robot.mbc().alpha = realRobot.mbc().alpha;
-    robot.forwardKinematics();
-    robot.forwardVelocity();
-    robot.forwardAcceleration();
+    robot.forwardAll();
   }
 
   // Update tasks and constraints from estimated robots
-  for(auto & c : constraints_) { c->update(*this); }
-  for(auto & t : metaTasks_)
-  {
-    t->update(*this);
-    t->incrementIterInSolver();
-  }
+  updateConstrsAndTasks();
 
   // Solve QP and integrate
-  if(solver_.solveNoMbcUpdate(robots_p->mbs(), robots_p->mbcs()))
+  if(solve())
   {
+    auto robots_start_t = mc_rtc::clock::now();
     for(size_t i = 0; i < robots_p->mbs().size(); ++i)
     {
       auto & robot = robots().robot(i);
-      if(integrateControlState)
-      {
-        robot.mbc().q = control_q_[i];
-        robot.mbc().alpha = control_alpha_[i];
-      }
+      if(integrateControlState) { feedback_.restoreControlState(i, robot); }
       if(robot.mb().nrDof() > 0)
       {
         solver_.updateMbc(robot.mbc(), static_cast<int>(i));
         robot.eulerIntegration(timeStep);
-        robot.forwardKinematics();
-        robot.forwardVelocity();
-        robot.forwardAcceleration();
+        robot.forwardAll();
       }
     }
+    timings_.robots = mc_rtc::duration_ms(mc_rtc::clock::now() - robots_start_t).count();
     return true;
   }
   return false;
@@ -349,6 +314,12 @@ bool TasksQPSolver::runClosedLoop(bool integrateControlState)
 
 void TasksQPSolver::updateConstrSize()
 {
+  // The solver data is shared by all update groups, it is resized on the solver thread before solving
+  if(mc_rtc::WorkerPool::inJob())
+  {
+    constrSizePending_ = true;
+    return;
+  }
   solver_.updateConstrSize();
 }
 
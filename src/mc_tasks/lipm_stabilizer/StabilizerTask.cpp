@@ -960,6 +960,152 @@ sva::ForceVecd StabilizerTask::computeDesiredWrench()
   return {measuredCoM_.cross(desiredForce) + desiredMoment, desiredForce};
 }
 
+void StabilizerTask::QPWorkspace::resize(int nrVar, int nrIneq)
+{
+  if(Q.rows() == nrVar && Aineq.rows() == nrIneq) { return; }
+  solver.problem(nrVar, 0, nrIneq);
+  Q.resize(nrVar, nrVar);
+  c.resize(nrVar);
+  Aineq.resize(nrIneq, nrVar);
+  bineq.resize(nrIneq);
+}
+
+void StabilizerTask::HorizonQPWorkspace::resize(int nbReferences)
+{
+  const int nbVariables = 2 * 2 * nbReferences; // Each reference induce 2 CoP which has 2 coordinates x y
+  const int nbIneqCstr = 8 * nbReferences; // Each CoP has 4 cstr to remain bounded in contact polygone
+  const int nbEqCstr = 2 * nbReferences;
+  if(Mcop.rows() == nbEqCstr) { return; }
+  QPWorkspace::resize(nbVariables, nbIneqCstr);
+  Mcop.resize(nbEqCstr, nbVariables);
+  bcop.resize(nbEqCstr);
+  McopReg.resize(nbVariables, nbVariables);
+  bcopReg.resize(nbVariables);
+  McopDiff.resize(2 * nbReferences, nbVariables);
+  bcopDiff.resize(2 * nbReferences);
+  Lx.setZero(nbReferences, nbReferences);
+  Ly.setZero(nbReferences, nbReferences);
+  Mstep.resize(2 * nbReferences, 4);
+  Z.resize(nbReferences, 4);
+  x.resize(nbVariables);
+  if(stepQ.rows() == 0)
+  {
+    stepSolver.problem(4, 0, 8);
+    stepQ.resize(4, 4);
+    stepc.resize(4);
+    stepBineq.resize(8);
+    // CoP of each foot bounded in the contact polygon
+    Eigen::Matrix<double, 4, 2> normals;
+    normals << 1, 0, -1, 0, 0, 1, 0, -1;
+    stepAineq.setZero(8, 4);
+    stepAineq.block<4, 2>(0, 0) = normals;
+    stepAineq.block<4, 2>(4, 2) = normals;
+  }
+}
+
+bool StabilizerTask::HorizonQPWorkspace::structured() const
+{
+  // The forward substitution amplifies the errors by the ratio between the terms of L and its diagonal
+  constexpr double eps = 1e-6;
+  auto wellConditioned = [](const Eigen::MatrixXd & L)
+  { return L.diagonal().cwiseAbs().minCoeff() > eps * L.cwiseAbs().maxCoeff(); };
+  return wellConditioned(Lx) && wellConditioned(Ly);
+}
+
+bool StabilizerTask::HorizonQPWorkspace::solve(int nbReferences,
+                                               double copWeight,
+                                               double copDiffWeight,
+                                               double copRegulationWeight)
+{
+  if(structured()) { return solveSteps(nbReferences, copWeight, copDiffWeight, copRegulationWeight); }
+  return solveDense(nbReferences, copWeight, copDiffWeight, copRegulationWeight);
+}
+
+bool StabilizerTask::HorizonQPWorkspace::solveSteps(int nbReferences,
+                                                    double copWeight,
+                                                    double copDiffWeight,
+                                                    double copRegulationWeight)
+{
+  // In terms of the modeled CoPs z_i = [zl_i zr_i] of iteration i the problem is:
+  // copWeight * |Mstep_i * z_i - bcop_i|^2
+  // + copDiffWeight * |zl_i - zr_i + bcopDiff_i|^2
+  // + copRegulationWeight * |z_i - bcopReg_i|^2
+  // subject to normals * zl_i <= bineq_l_i and normals * zr_i <= bineq_r_i
+  for(Eigen::Index i = 0; i < nbReferences; ++i)
+  {
+    const auto M = Mstep.block<2, 4>(2 * i, 0);
+    const auto b = bcop.segment<2>(2 * i);
+    const auto bDiff = bcopDiff.segment<2>(2 * i);
+    stepQ.noalias() = copWeight * M.transpose() * M;
+    stepQ.diagonal().array() += copRegulationWeight + copDiffWeight;
+    stepQ.block<2, 2>(0, 2).diagonal().array() -= copDiffWeight;
+    stepQ.block<2, 2>(2, 0).diagonal().array() -= copDiffWeight;
+    stepc.noalias() = -copWeight * M.transpose() * b;
+    stepc.head<2>() += copDiffWeight * bDiff - copRegulationWeight * bcopReg.segment<2>(2 * i);
+    stepc.tail<2>() -= copDiffWeight * bDiff + copRegulationWeight * bcopReg.segment<2>(2 * (i + nbReferences));
+    stepBineq.head<4>() = bineq.segment<4>(4 * i);
+    stepBineq.tail<4>() = bineq.segment<4>(4 * (i + nbReferences));
+    if(!stepSolver.solve(stepQ, stepc, Aeq, beq, stepAineq, stepBineq, /* isDecomp = */ false)) { return false; }
+    Z.row(i) = stepSolver.result().transpose();
+  }
+  // Recover the CoP references from the modeled CoPs
+  for(Eigen::Index j = 0; j < 4; ++j)
+  {
+    auto z = Z.col(j);
+    if(j % 2 == 0) { Lx.triangularView<Eigen::Lower>().solveInPlace(z); }
+    else { Ly.triangularView<Eigen::Lower>().solveInPlace(z); }
+    const Eigen::Index offset = (j < 2 ? 0 : 2 * nbReferences) + j % 2;
+    for(Eigen::Index i = 0; i < nbReferences; ++i) { x(offset + 2 * i) = z(i); }
+  }
+  return true;
+}
+
+bool StabilizerTask::HorizonQPWorkspace::solveDense(int nbReferences,
+                                                    double copWeight,
+                                                    double copDiffWeight,
+                                                    double copRegulationWeight)
+{
+  Mcop.setZero();
+  McopReg.setZero();
+  McopDiff.setZero();
+  Aineq.setZero();
+  const auto normals = stepAineq.block<4, 2>(0, 0);
+  for(Eigen::Index i = 0; i < nbReferences; ++i)
+  {
+    for(Eigen::Index k = 0; k <= i; ++k)
+    {
+      for(Eigen::Index j = 0; j < 2; ++j)
+      {
+        const double l = j == 0 ? Lx(i, k) : Ly(i, k);
+        const Eigen::Index left = 2 * k + j;
+        const Eigen::Index right = 2 * (nbReferences + k) + j;
+        // The task regulate zmp_i = (cop_l * f_z_l + cop_r * f_z_r)/f_z in world frame
+        Mcop.block<2, 1>(2 * i, left) = l * Mstep.block<2, 1>(2 * i, j);
+        Mcop.block<2, 1>(2 * i, right) = l * Mstep.block<2, 1>(2 * i, 2 + j);
+        McopReg(2 * i + j, left) = l;
+        McopReg(2 * (nbReferences + i) + j, right) = l;
+        McopDiff(2 * i + j, left) = l;
+        McopDiff(2 * i + j, right) = -l;
+        // CoP must remain bounded in polygon cstr
+        Aineq.block<4, 1>(4 * i, left) = l * normals.col(j);
+        Aineq.block<4, 1>(4 * (nbReferences + i), right) = l * normals.col(j);
+      }
+    }
+  }
+
+  Q.noalias() = copWeight * Mcop.transpose() * Mcop;
+  Q.noalias() += copDiffWeight * McopDiff.transpose() * McopDiff;
+  Q.noalias() += copRegulationWeight * McopReg.transpose() * McopReg;
+
+  c.noalias() = -copWeight * Mcop.transpose() * bcop;
+  c.noalias() += copDiffWeight * McopDiff.transpose() * bcopDiff;
+  c.noalias() -= copRegulationWeight * McopReg.transpose() * bcopReg;
+
+  if(!solver.solve(Q, c, Aeq, beq, Aineq, bineq, /* isDecomp = */ false)) { return false; }
+  x = solver.result();
+  return true;
+}
+
 void StabilizerTask::distributeWrench(const sva::ForceVecd & desiredWrench)
 {
   // Variables
@@ -991,12 +1137,10 @@ void StabilizerTask::distributeWrench(const sva::ForceVecd & desiredWrench)
   const sva::PTransformd & X_0_rankle = rightContact.anklePose();
   sva::PTransformd X_0_zmp(zmpTarget_);
 
-  constexpr unsigned NB_VAR = 6 + 6;
-  constexpr unsigned COST_DIM = 6 + NB_VAR + 1;
-  Eigen::MatrixXd A;
-  Eigen::VectorXd b;
-  A.setZero(COST_DIM, NB_VAR);
-  b.setZero(COST_DIM);
+  constexpr int NB_VAR = 6 + 6;
+  constexpr int COST_DIM = 6 + NB_VAR + 1;
+  Eigen::Matrix<double, COST_DIM, NB_VAR> A = Eigen::Matrix<double, COST_DIM, NB_VAR>::Zero();
+  Eigen::Matrix<double, COST_DIM, 1> b = Eigen::Matrix<double, COST_DIM, 1>::Zero();
 
   // |w_l_zmp + w_r_zmp - desiredWrench|^2
   // We handle moments around the ZMP instead of the world origin to avoid numerical errors due to large moment values.
@@ -1032,42 +1176,42 @@ void StabilizerTask::distributeWrench(const sva::ForceVecd & desiredWrench)
   A_pressure *= c_.fdqpWeights.pressureSqrt;
   // b_pressure = 0
 
-  Eigen::MatrixXd Q = A.transpose() * A;
-  Eigen::VectorXd c = -A.transpose() * b;
-
   // The CoP constraint represent 4 linear constraints for each foot
   const int cwc_const = 12 + (c_.constrainCoP ? 4 : 0);
   const int nb_const = 2 * cwc_const + 2;
-  Eigen::Matrix<double, -1, NB_VAR> A_ineq;
-  Eigen::VectorXd b_ineq;
-  A_ineq.setZero(nb_const, NB_VAR);
-  b_ineq.setZero(nb_const);
+  auto & qp = distribQP_;
+  qp.resize(NB_VAR, nb_const);
+
+  qp.Q.noalias() = A.transpose() * A;
+  qp.c.noalias() = -A.transpose() * b;
+
+  auto & A_ineq = qp.Aineq;
+  auto & b_ineq = qp.bineq;
+  A_ineq.setZero();
+  b_ineq.setZero();
   // CWC * w_l_lc <= 0
-  A_ineq.block(0, 0, cwc_const, 6) = leftContact.wrenchFaceMatrix().block(0, 0, cwc_const, 6) * X_0_lc.dualMatrix();
+  A_ineq.block(0, 0, cwc_const, 6).noalias() =
+      leftContact.wrenchFaceMatrix().block(0, 0, cwc_const, 6) * X_0_lc.dualMatrix();
   // b_ineq.segment(0,cwc_const) is already zero
   // CWC * w_r_rc <= 0
-  A_ineq.block(cwc_const, 6, cwc_const, 6) =
+  A_ineq.block(cwc_const, 6, cwc_const, 6).noalias() =
       rightContact.wrenchFaceMatrix().block(0, 0, cwc_const, 6) * X_0_rc.dualMatrix();
   // b_ineq.segment(cwc_const,cwc_const) is already zero
   // w_l_lc.force().z() >= MIN_DS_PRESSURE
-  A_ineq.block(nb_const - 2, 0, 1, 6) = -X_0_lc.dualMatrix().bottomRows<1>();
+  A_ineq.block<1, 6>(nb_const - 2, 0) = -X_0_lc.dualMatrix().bottomRows<1>();
   b_ineq(nb_const - 2) = -c_.safetyThresholds.MIN_DS_PRESSURE;
   // w_r_rc.force().z() >= MIN_DS_PRESSURE
-  A_ineq.block(nb_const - 1, 6, 1, 6) = -X_0_rc.dualMatrix().bottomRows<1>();
+  A_ineq.block<1, 6>(nb_const - 1, 6) = -X_0_rc.dualMatrix().bottomRows<1>();
   b_ineq(nb_const - 1) = -c_.safetyThresholds.MIN_DS_PRESSURE;
 
-  qpSolver_.problem(NB_VAR, 0, nb_const);
-  Eigen::MatrixXd A_eq(0, 0);
-  Eigen::VectorXd b_eq;
-  b_eq.resize(0);
-  bool solutionFound = qpSolver_.solve(Q, c, A_eq, b_eq, A_ineq, b_ineq, /* isDecomp = */ false);
+  bool solutionFound = qp.solver.solve(qp.Q, qp.c, qp.Aeq, qp.beq, A_ineq, b_ineq, /* isDecomp = */ false);
   if(!solutionFound)
   {
     mc_rtc::log::error("[StabilizerTask] DS force distribution QP: solver found no solution");
     return;
   }
 
-  Eigen::VectorXd x = qpSolver_.result();
+  const Eigen::VectorXd & x = qp.solver.result();
   sva::ForceVecd w_l_0(x.segment<3>(0), x.segment<3>(3));
   sva::ForceVecd w_r_0(x.segment<3>(6), x.segment<3>(9));
   distribWrench_ = w_l_0 + w_r_0;
@@ -1183,24 +1327,20 @@ void StabilizerTask::computeCoPonHorizon(const std::vector<Eigen::Vector2d> & zm
             Eigen::Vector2d{rightContact.halfLength(), rightContact.halfWidth()});
 
   const int nbReferences = static_cast<int>(zmp_ref.size());
-  const int nbVariables = 2 * 2 * nbReferences; // Each reference induce 2 CoP which has 2 coordinates x y
-  const int nbIneqCstr = 8 * nbReferences; // Each CoP has 4 cstr to remain bounded in contact polygone
-  const int nbEqCstr = 2 * nbReferences;
+
+  auto & qp = horizonQP_;
+  qp.resize(nbReferences);
 
   // Task to meet the CoPs to the reference ZMP
-  Eigen::MatrixXd Mcop = Eigen::MatrixXd::Zero(nbEqCstr, nbVariables);
-  Eigen::VectorXd bcop = Eigen::VectorXd::Zero(Mcop.rows());
+  auto & bcop = qp.bcop;
 
   // Task to regulate the CoPs under the foot ankle
-  Eigen::MatrixXd McopReg = Eigen::MatrixXd::Zero(nbVariables, nbVariables);
-  Eigen::VectorXd bcopReg = Eigen::VectorXd::Zero(McopReg.rows());
+  auto & bcopReg = qp.bcopReg;
 
   // Task to regulate the CoPs difference
-  Eigen::MatrixXd McopDiff = Eigen::MatrixXd::Zero(2 * nbReferences, nbVariables);
-  Eigen::VectorXd bcopDiff = Eigen::VectorXd::Zero(McopDiff.rows());
+  auto & bcopDiff = qp.bcopDiff;
 
-  Eigen::MatrixXd Aineq = Eigen::MatrixXd::Zero(nbIneqCstr, nbVariables);
-  Eigen::VectorXd bineq = Eigen::VectorXd::Zero(Aineq.rows());
+  auto & bineq = qp.bineq;
 
   Eigen::Matrix<double, 4, 2> normals; // normals matrix for CoP constraints
   Eigen::Vector4d offsetLeft = Eigen::Vector4d::Zero();
@@ -1231,6 +1371,9 @@ void StabilizerTask::computeCoPonHorizon(const std::vector<Eigen::Vector2d> & zm
 
   const double ratio0 = ratio;
 
+  const Eigen::Matrix2d R_lc_0 = X_0_lc.rotation().topLeftCorner<2, 2>().transpose();
+  const Eigen::Matrix2d R_rc_0 = X_0_rc.rotation().topLeftCorner<2, 2>().transpose();
+
   for(Eigen::Index i = 0; i < nbReferences; i++)
   {
 
@@ -1244,10 +1387,9 @@ void StabilizerTask::computeCoPonHorizon(const std::vector<Eigen::Vector2d> & zm
                     1 - (c_.safetyThresholds.MIN_DS_PRESSURE / fz_tot));
     }
 
-    // Acop convert the CoP reference into the modeled CoP
-    // x be vector cotaining the CoP reference for one foot
-    // Acop * x + cop_0 * e^(-lambda t_i) = cop i in foot frame (left/right)
-    Eigen::MatrixXd Acop = Eigen::MatrixXd::Zero(2, 2 * nbReferences);
+    // Lx and Ly convert the CoP reference into the modeled CoP
+    // x be vector cotaining the CoP reference for one foot along one axis
+    // L(i, :) * x + cop_0 * e^(-lambda t_i) = cop i in foot frame (left/right)
     double t = static_cast<double>(i) * delta;
     Eigen::Matrix2d exp_mat;
     exp_mat << exp(-c_.copFzLambda.x() * (t + delta - (i == 0 ? t_delay : c_.delayCoP))), 0, 0,
@@ -1256,75 +1398,50 @@ void StabilizerTask::computeCoPonHorizon(const std::vector<Eigen::Vector2d> & zm
     {
       if(k == i)
       {
-        Acop(0, 2 * k) =
+        qp.Lx(i, k) =
             (1 - exp(-c_.copFzLambda.x() * (delta - (i == 0 ? t_delay : c_.delayCoP)))) * exp(-c_.copFzLambda.x() * t);
-        Acop(1, 2 * k + 1) =
+        qp.Ly(i, k) =
             (1 - exp(-c_.copFzLambda.y() * (delta - (i == 0 ? t_delay : c_.delayCoP)))) * exp(-c_.copFzLambda.y() * t);
       }
       else
       {
-        Acop(0, 2 * k) = (1 - exp(-c_.copFzLambda.x() * delta)) * exp(-c_.copFzLambda.x() * t);
-        Acop(1, 2 * k + 1) = (1 - exp(-c_.copFzLambda.y() * delta)) * exp(-c_.copFzLambda.y() * t);
+        qp.Lx(i, k) = (1 - exp(-c_.copFzLambda.x() * delta)) * exp(-c_.copFzLambda.x() * t);
+        qp.Ly(i, k) = (1 - exp(-c_.copFzLambda.y() * delta)) * exp(-c_.copFzLambda.y() * t);
       }
       t -= delta;
     }
-    auto Acop_view = Acop.block(0, 0, 2, 2 * (i + 1));
-    // The task regulate zmp_i = (cop_l * f_z_l + cop_r * f_z_r)/f_z in world frame
-    Mcop.block(2 * i, 0, 2, Acop_view.cols()) = X_0_lc.inv().rotation().block(0, 0, 2, 2) * (1 - ratio) * Acop_view;
-    Mcop.block(2 * i, 2 * nbReferences, 2, Acop_view.cols()) =
-        X_0_rc.inv().rotation().block(0, 0, 2, 2) * ratio * Acop_view;
+    // The modeled ZMP is zmp_i = (cop_l * f_z_l + cop_r * f_z_r)/f_z in world frame
+    qp.Mstep.block<2, 2>(2 * i, 0) = (1 - ratio) * R_lc_0;
+    qp.Mstep.block<2, 2>(2 * i, 2) = ratio * R_rc_0;
 
     // clang-format off
-    bcop.segment(2 * i, 2) =
+    bcop.segment<2>(2 * i) =
         zmp_ref[i]
         - X_0_lc.translation().segment(0, 2) * (1 - ratio)
         - X_0_rc.translation().segment(0, 2) * (ratio)
-        - X_0_lc.inv().rotation().block(0, 0, 2, 2) * (1 - ratio) * exp_mat * measuredLeftCoP_delayed.segment(0, 2)
-        - X_0_rc.inv().rotation().block(0, 0, 2, 2) * (ratio) * exp_mat * measuredRightCoP_delayed.segment(0, 2);
+        - R_lc_0 * (1 - ratio) * exp_mat * measuredLeftCoP_delayed.segment(0, 2)
+        - R_rc_0 * (ratio) * exp_mat * measuredRightCoP_delayed.segment(0, 2);
     // clang-format on
 
-    McopReg.block(2 * i, 0, 2, Acop_view.cols()) = Acop_view;
-    McopReg.block(2 * nbReferences + 2 * i, 2 * nbReferences, 2, Acop_view.cols()) = Acop_view;
     bcopReg.segment(2 * i, 2) = -t_lankle_lc.segment(0, 2) - exp_mat * measuredLeftCoP_delayed.segment(0, 2);
     bcopReg.segment(2 * (i + nbReferences), 2) =
         -t_rankle_rc.segment(0, 2) - exp_mat * measuredRightCoP_delayed.segment(0, 2);
 
-    // CoP must remain bounded in polygon cstr
-    Aineq.block(4 * i, 0, 4, Acop_view.cols()) = normals * Acop_view;
-
     bineq.segment(4 * i, 4) = offsetLeft - normals * exp_mat * measuredLeftCoP_delayed.segment(0, 2);
     bineq.segment(4 * (nbReferences + i), 4) = offsetRight - normals * exp_mat * measuredRightCoP_delayed.segment(0, 2);
 
-    McopDiff.block(2 * i, 0, 2, Acop_view.cols()) = Acop_view;
-    McopDiff.block(2 * i, 2 * nbReferences, 2, Acop_view.cols()) = -Acop_view;
     bcopDiff.segment(2 * i, 2) = exp_mat * (measuredLeftCoP_delayed - measuredRightCoP_delayed).segment(0, 2);
   }
 
-  // We copy the constraint for the other contact
-  Aineq.block(4 * nbReferences, 2 * nbReferences, 4 * nbReferences, 2 * nbReferences) =
-      Aineq.block(0, 0, 4 * nbReferences, 2 * nbReferences);
-
-  Eigen::MatrixXd Q = c_.fdmpcWeights.cop_ * Mcop.transpose() * Mcop;
-  Q += c_.fdmpcWeights.copDiff_ * McopDiff.transpose() * McopDiff;
-  Q += c_.fdmpcWeights.copRegulation_ * McopReg.transpose() * McopReg;
-
-  Eigen::VectorXd c = c_.fdmpcWeights.cop_ * (-Mcop.transpose() * bcop);
-  c += c_.fdmpcWeights.copDiff_ * (McopDiff.transpose() * bcopDiff);
-  c += c_.fdmpcWeights.copRegulation_ * (-McopReg.transpose() * bcopReg);
-
-  qpSolver_.problem(nbVariables, 0, nbIneqCstr);
-  Eigen::MatrixXd Aeq(0, 0);
-  Eigen::VectorXd beq;
-  beq.resize(0);
-
-  bool solutionFound = qpSolver_.solve(Q, c, Aeq, beq, Aineq, bineq, /* isDecomp = */ false);
+  bool solutionFound =
+      qp.solve(nbReferences, c_.fdmpcWeights.cop_, c_.fdmpcWeights.copDiff_, c_.fdmpcWeights.copRegulation_);
   if(!solutionFound)
   {
     mc_rtc::log::error("[{}] DS force/CoP distribution QP: solver found no solution", name());
     return;
   }
 
-  Eigen::VectorXd x = qpSolver_.result();
+  const Eigen::VectorXd & x = qp.x;
   Eigen::Vector2d leftCoP(x.segment(0, 2));
   Eigen::Vector2d rightCoP(x.segment(2 * nbReferences, 2));
 
@@ -1451,7 +1568,7 @@ void StabilizerTask::saturateWrench(const sva::ForceVecd & desiredWrench,
 {
 
   const int nb_const = 12 + (c_.constrainCoP ? 4 : 0);
-  constexpr unsigned NB_VAR = 6;
+  constexpr int NB_VAR = 6;
 
   // Variables
   // ---------
@@ -1468,26 +1585,23 @@ void StabilizerTask::saturateWrench(const sva::ForceVecd & desiredWrench,
 
   const sva::PTransformd & X_0_c = contact.surfacePose();
 
-  Eigen::Matrix6d Q = Eigen::Matrix6d::Identity();
-  Eigen::Vector6d c = -desiredWrench.vector();
+  auto & qp = saturateQP_;
+  qp.resize(NB_VAR, nb_const);
 
-  Eigen::MatrixXd A_ineq = contact.wrenchFaceMatrix().block(0, 0, nb_const, 6) * X_0_c.dualMatrix();
-  Eigen::VectorXd b_ineq;
-  b_ineq.setZero(nb_const);
+  qp.Q.setIdentity();
+  qp.c = -desiredWrench.vector();
 
-  qpSolver_.problem(NB_VAR, 0, nb_const);
-  Eigen::MatrixXd A_eq(0, 0);
-  Eigen::VectorXd b_eq;
-  b_eq.resize(0);
+  qp.Aineq.noalias() = contact.wrenchFaceMatrix().block(0, 0, nb_const, 6) * X_0_c.dualMatrix();
+  qp.bineq.setZero();
 
-  bool solutionFound = qpSolver_.solve(Q, c, A_eq, b_eq, A_ineq, b_ineq, /* isDecomp = */ true);
+  bool solutionFound = qp.solver.solve(qp.Q, qp.c, qp.Aeq, qp.beq, qp.Aineq, qp.bineq, /* isDecomp = */ true);
   if(!solutionFound)
   {
     mc_rtc::log::error("[StabilizerTask] SS force distribution QP: solver found no solution");
     return;
   }
 
-  Eigen::VectorXd x = qpSolver_.result();
+  const Eigen::VectorXd & x = qp.solver.result();
   sva::ForceVecd w_0(x.head<3>(), x.tail<3>());
   sva::ForceVecd w_c = X_0_c.dualMul(w_0);
   Eigen::Vector2d cop = (constants::vertical.cross(w_c.couple()) / w_c.force()(2)).head<2>();
@@ -49,10 +49,11 @@ CollisionFunction::CollisionFunction(Convex & c1,
   auto addConvex = [this](Convex & convex, const Eigen::VectorXd & selector)
   {
     auto & r = convex.frame().robot();
+    // Also required for fixed objects as it provides the bounding sphere used by the broad phase
+    addInputDependency<CollisionFunction>(Update::Value, convex, Convex::Output::Position);
     if(r.mb().nrDof() > 0)
     {
       auto & tvm_robot = r.tvmRobot();
-      addInputDependency<CollisionFunction>(Update::Value, convex, Convex::Output::Position);
       addInputDependency<CollisionFunction>(Update::Jacobian, tvm_robot, mc_tvm::Robot::Output::FV);
       addInputDependency<CollisionFunction>(Update::NormalAcceleration, tvm_robot,
                                             mc_tvm::Robot::Output::NormalAcceleration);
@@ -69,19 +70,29 @@ CollisionFunction::CollisionFunction(Convex & c1,
   distJac_.resize(1, maxDof);
 }
 
-void CollisionFunction::updateValue()
+bool CollisionFunction::updateBroadPhase(double & dist)
 {
-  double dist = sch::mc_rbdyn::distance(pair_, p1_, p2_);
-  if(dist == 0) { dist = sch::epsilon; }
-  dist = dist >= 0 ? std::sqrt(dist) : -std::sqrt(-dist);
-  normVecDist_ = (p1_ - p2_) / dist;
-  if(iter_ == 1) { prevNormVecDist_ = normVecDist_; }
-  if(prevIter_ != iter_)
+  if(broadPhaseDistance_ <= 0) { return false; }
+  Eigen::Vector3d c12 = c1_->boundingSphereCenter() - c2_->boundingSphereCenter();
+  double cDist = c12.norm();
+  dist = cDist - c1_->boundingSphereRadius() - c2_->boundingSphereRadius();
+  if(dist <= broadPhaseDistance_) { return false; }
+  c12 /= cDist;
+  p1_ = c1_->boundingSphereCenter() - c1_->boundingSphereRadius() * c12;
+  p2_ = c2_->boundingSphereCenter() + c2_->boundingSphereRadius() * c12;
+  return true;
+}
+
+void CollisionFunction::computeDistance()
+{
+  culled_ = updateBroadPhase(dist_);
+  if(!culled_)
   {
-    speedVec_ = (normVecDist_ - prevNormVecDist_) / dt_;
-    prevNormVecDist_ = normVecDist_;
-    prevIter_ = iter_;
+    dist_ = sch::mc_rbdyn::distance(pair_, p1_, p2_);
+    if(dist_ == 0) { dist_ = sch::epsilon; }
+    dist_ = dist_ >= 0 ? std::sqrt(dist_) : -std::sqrt(-dist_);
   }
+  normVecDist_ = (p1_ - p2_) / dist_;
   auto object = std::ref(c1_);
   auto point = std::ref(p1_);
   for(size_t i = 0; i < data_.size(); ++i)
@@ -92,7 +103,28 @@ void CollisionFunction::updateValue()
     object = std::ref(c2_);
     point = std::ref(p2_);
   }
-  value_(0) = dist;
+}
+
+void CollisionFunction::precompute()
+{
+  computeDistance();
+  precomputed_ = true;
+}
+
+void CollisionFunction::updateValue()
+{
+  if(!precomputed_) { computeDistance(); }
+  precomputed_ = false;
+  // The normal jumps when switching from the bounding spheres to the actual objects
+  if(iter_ == 1 || (wasCulled_ && !culled_)) { prevNormVecDist_ = normVecDist_; }
+  wasCulled_ = culled_;
+  if(prevIter_ != iter_)
+  {
+    speedVec_ = (normVecDist_ - prevNormVecDist_) / dt_;
+    prevNormVecDist_ = normVecDist_;
+    prevIter_ = iter_;
+  }
+  value_(0) = dist_;
 }
 
 void CollisionFunction::tick()
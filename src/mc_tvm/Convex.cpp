@@ -22,7 +22,20 @@ Convex::Convex(NewConvexToken,
 
 void Convex::updatePosition()
 {
-  sch::mc_rbdyn::transform(*object_, X_f_c_ * frame_->tvm_frame().position());
+  setPosition(frame_->tvm_frame().position());
+}
+
+void Convex::updateFromRobot()
+{
+  setPosition(frame_->position());
+}
+
+void Convex::setPosition(const sva::PTransformd & X_0_f)
+{
+  position_ = X_f_c_ * X_0_f;
+  sch::mc_rbdyn::transform(*object_, position_);
+  if(sphereRadius_ < 0) { sch::mc_rbdyn::boundingSphere(*object_, position_, localSphereCenter_, sphereRadius_); }
+  sphereCenter_ = (sva::PTransformd(localSphereCenter_) * position_).translation();
 }
 
 } // namespace mc_tvm
@@ -4,20 +4,16 @@
 
 #include <mc_tvm/Robot.h>
 
+#include <algorithm>
+
 namespace mc_tvm
 {
 
-static inline void updateVar(const std::vector<std::vector<double>> & value, tvm::Variable & var)
+static inline void gather(const std::vector<Robot::JointSegment> & plan,
+                          const std::vector<std::vector<double>> & in,
+                          Eigen::Ref<Eigen::VectorXd> out) noexcept
 {
-  Eigen::DenseIndex idx = 0;
-  for(size_t i = 0; i < value.size(); ++i)
-  {
-    Eigen::DenseIndex size = static_cast<Eigen::DenseIndex>(value[i].size());
-    if(size == 0) { continue; }
-    Eigen::Map<const Eigen::VectorXd> qi(value[i].data(), size);
-    var.set(idx, size, qi);
-    idx += size;
-  }
+  for(const auto & s : plan) { std::copy_n(in[s.joint].data(), s.size, out.data() + s.offset); }
 }
 
 Robot::Robot(NewRobotToken, const mc_rbdyn::Robot & robot)
@@ -134,6 +130,18 @@ Robot::Robot(NewRobotToken, const mc_rbdyn::Robot & robot)
   ddq_->setZero();
   tau_->setZero();
 
+  for(int i = 0; i < robot.mb().nrJoints(); ++i)
+  {
+    const auto & j = robot.mb().joint(i);
+    if(j.params() > 0)
+    {
+      paramSegments_.push_back({static_cast<size_t>(i), robot.mb().jointPosInParam(i), j.params()});
+    }
+    if(j.dof() > 0) { dofSegments_.push_back({static_cast<size_t>(i), robot.mb().jointPosInDof(i), j.dof()}); }
+  }
+  paramBuffer_.resize(robot.mb().nrParams());
+  dofBuffer_.resize(robot.mb().nrDof());
+
   const auto & rjo = robot.refJointOrder();
   refJointIndexToQIndex_.resize(rjo.size());
   refJointIndexToQDotIndex_.resize(rjo.size());
@@ -173,20 +181,40 @@ Robot::Robot(NewRobotToken, const mc_rbdyn::Robot & robot)
   addInternalDependency(Update::NormalAcceleration, Update::FV);
 }
 
+void Robot::paramToVector(const std::vector<std::vector<double>> & param, Eigen::Ref<Eigen::VectorXd> out) const noexcept
+{
+  gather(paramSegments_, param, out);
+}
+
+void Robot::dofToVector(const std::vector<std::vector<double>> & dof, Eigen::Ref<Eigen::VectorXd> out) const noexcept
+{
+  gather(dofSegments_, dof, out);
+}
+
+void Robot::vectorToDof(const Eigen::Ref<const Eigen::VectorXd> & v,
+                        std::vector<std::vector<double>> & dof) const noexcept
+{
+  for(const auto & s : dofSegments_) { std::copy_n(v.data() + s.offset, s.size, dof[s.joint].data()); }
+}
+
 void Robot::updateFK()
 {
-  updateVar(robot_.mbc().q, *q_);
+  paramToVector(robot_.mbc().q, paramBuffer_);
+  q_->set(paramBuffer_);
 }
 
 void Robot::updateFV()
 {
-  updateVar(robot_.mbc().alpha, *dq_);
+  dofToVector(robot_.mbc().alpha, dofBuffer_);
+  dq_->set(dofBuffer_);
 }
 
 void Robot::updateFA()
 {
-  updateVar(robot_.mbc().alphaD, *ddq_);
-  updateVar(robot_.mbc().jointTorque, *tau_);
+  dofToVector(robot_.mbc().alphaD, dofBuffer_);
+  ddq_->set(dofBuffer_);
+  dofToVector(robot_.mbc().jointTorque, dofBuffer_);
+  tau_->set(dofBuffer_);
 }
 
 void Robot::updateNormalAcceleration()
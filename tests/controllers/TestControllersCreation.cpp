@@ -0,0 +1,67 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_control/api.h>
+#include <mc_control/mc_controller.h>
+#include <mc_rtc/logging.h>
+
+#include <chrono>
+#include <thread>
+
+/** Controllers used by test_controllers_creation
+ *
+ * - names containing "Slow" take CREATION_DELAY to be created
+ * - names containing "Throw" throw an exception in their constructor
+ */
+
+namespace mc_control
+{
+
+static constexpr std::chrono::milliseconds CREATION_DELAY{500};
+
+struct MC_CONTROL_DLLAPI TestControllersCreation : public MCController
+{
+public:
+  TestControllersCreation(const std::string & name, mc_rbdyn::RobotModulePtr rm, double dt) : MCController(rm, dt)
+  {
+    if(name.find("Slow") != std::string::npos) { std::this_thread::sleep_for(CREATION_DELAY); }
+    if(name.find("Throw") != std::string::npos) { mc_rtc::log::error_and_throw("{} failed on purpose", name); }
+    solver().addConstraintSet(contactConstraint);
+    solver().addConstraintSet(kinematicsConstraint);
+    solver().addTask(postureTask.get());
+    solver().setContacts({});
+    mc_rtc::log::success("Created {}", name);
+  }
+};
+
+} // namespace mc_control
+
+extern "C"
+{
+
+  CONTROLLER_MODULE_API void MC_RTC_CONTROLLER(std::vector<std::string> & names)
+  {
+    CONTROLLER_CHECK_VERSION("TestControllersCreation")
+    names = {"TestControllersCreation_A", "TestControllersCreation_B", "TestControllersCreation_Slow",
+             "TestControllersCreation_Throw", "TestControllersCreation_SlowThrow"};
+  }
+
+  CONTROLLER_MODULE_API void destroy(mc_control::MCController * ptr)
+  {
+    delete ptr;
+  }
+
+  CONTROLLER_MODULE_API unsigned int create_args_required()
+  {
+    return 4;
+  }
+
+  CONTROLLER_MODULE_API mc_control::MCController * create(const std::string & name,
+                                                          const mc_rbdyn::RobotModulePtr & rm,
+                                                          const double & dt,
+                                                          const mc_rtc::Configuration &)
+  {
+    return new mc_control::TestControllersCreation(name, rm, dt);
+  }
+}
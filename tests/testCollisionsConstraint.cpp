@@ -0,0 +1,149 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rbdyn/RobotLoader.h>
+#include <mc_rbdyn/Robots.h>
+#include <mc_rbdyn/SelfCollisionFilter.h>
+
+#include <mc_solver/CollisionsConstraint.h>
+#include <mc_solver/TVMQPSolver.h>
+#include <mc_solver/TasksQPSolver.h>
+
+#include <mc_tasks/PostureTask.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include "utils.h"
+
+namespace
+{
+
+mc_rbdyn::RobotsPtr make_robots()
+{
+  configureRobotLoader();
+  auto rm = mc_rbdyn::RobotLoader::get_robot_module("JVRC1");
+  auto env = mc_rbdyn::RobotLoader::get_robot_module("env/ground");
+  return mc_rbdyn::loadRobotAndEnv(*rm, *env);
+}
+
+/** A solver with the common self-collisions of the robot and a posture task moving the arms towards the body */
+template<typename SolverT>
+struct CollisionsSetup
+{
+  CollisionsSetup(bool broadPhase) : solver(make_robots(), 0.005), constraint(solver.robots(), 0, 0, solver.dt())
+  {
+    BOOST_REQUIRE(!constraint.broadPhase());
+    constraint.broadPhase(broadPhase);
+    constraint.automaticMonitor(false);
+    solver.addConstraintSet(constraint);
+    constraint.addCollisions(solver, solver.robot().module().commonSelfCollisions());
+    posture = std::make_shared<mc_tasks::PostureTask>(solver, 0, 10.0, 1.0);
+    posture->target({{"R_SHOULDER_R", {-0.2}}, {"L_SHOULDER_R", {0.2}}, {"R_ELBOW_P", {-2.0}}, {"L_ELBOW_P", {-2.0}}});
+    solver.addTask(posture);
+  }
+
+  SolverT solver;
+  mc_solver::CollisionsConstraint constraint;
+  std::shared_ptr<mc_tasks::PostureTask> posture;
+};
+
+template<typename SolverT>
+void testBroadPhase()
+{
+  CollisionsSetup<SolverT> narrow(false);
+  CollisionsSetup<SolverT> broad(true);
+  BOOST_REQUIRE(!narrow.constraint.cols.empty());
+  const auto & q_narrow = narrow.solver.robot().mbc().q;
+  const auto & q_broad = broad.solver.robot().mbc().q;
+  for(size_t i = 0; i < 500; ++i)
+  {
+    BOOST_REQUIRE(narrow.solver.run());
+    BOOST_REQUIRE(broad.solver.run());
+    for(size_t j = 0; j < q_narrow.size(); ++j)
+    {
+      for(size_t k = 0; k < q_narrow[j].size(); ++k) { BOOST_REQUIRE_SMALL(q_narrow[j][k] - q_broad[j][k], 1e-6); }
+    }
+  }
+}
+
+/** Minimum distance of the far pairs in the filter */
+constexpr double farDistance = 0.3;
+/** Self-collision filter margin used in the test */
+constexpr double margin = 0.02;
+
+/** JVRC1 with a self-collision filter that excludes the pairs of R_WRIST_Y_S and the R_HIP convexes
+ *
+ * The first R_HIP convex (in \p hips) is adjacent, the others never came closer than farDistance
+ */
+mc_rbdyn::RobotsPtr make_filtered_robots(std::vector<std::string> & hips)
+{
+  configureRobotLoader();
+  auto rm = *mc_rbdyn::RobotLoader::get_robot_module("JVRC1");
+  auto env = mc_rbdyn::RobotLoader::get_robot_module("env/ground");
+  hips.clear();
+  for(const auto & c : rm.convexHull())
+  {
+    if(c.first.rfind("R_HIP", 0) == 0) { hips.push_back(c.first); }
+  }
+  BOOST_REQUIRE(hips.size() >= 2);
+  mc_rbdyn::SelfCollisionFilter filter;
+  filter.exclude("R_WRIST_Y_S", hips[0], mc_rbdyn::SelfCollisionFilter::Reason::Adjacent, 0.0);
+  for(size_t i = 1; i < hips.size(); ++i)
+  {
+    filter.exclude("R_WRIST_Y_S", hips[i], mc_rbdyn::SelfCollisionFilter::Reason::Far, farDistance);
+  }
+  rm._selfCollisionFilter = std::make_shared<mc_rbdyn::SelfCollisionFilter>(filter);
+  return mc_rbdyn::loadRobotAndEnv(rm, *env);
+}
+
+/** Number of collisions in the constraint after adding \p col */
+template<typename SolverT>
+size_t filteredCollisions(const mc_rbdyn::Collision & col, bool filter, std::vector<std::string> & hips)
+{
+  SolverT solver(make_filtered_robots(hips), 0.005);
+  mc_solver::CollisionsConstraint constraint(solver.robots(), 0, 0, solver.dt());
+  BOOST_REQUIRE(constraint.selfCollisionFilter());
+  constraint.selfCollisionFilter(filter);
+  constraint.selfCollisionFilterMargin(margin);
+  constraint.automaticMonitor(false);
+  solver.addConstraintSet(constraint);
+  constraint.addCollisions(solver, {col});
+  return constraint.cols.size();
+}
+
+template<typename SolverT>
+void testSelfCollisionFilter()
+{
+  std::vector<std::string> hips;
+  // Far pairs are beyond the interaction distance: only the pairs that are not excluded remain
+  BOOST_REQUIRE_EQUAL(filteredCollisions<SolverT>({"R_WRIST_Y_S", "R_HIP*", farDistance - margin - 0.01, 0.01, 0.0},
+                                                  true, hips),
+                      0);
+  // Far pairs may come within the interaction distance: only the adjacent pair is skipped
+  BOOST_REQUIRE_EQUAL(filteredCollisions<SolverT>({"R_WRIST_Y_S", "R_HIP*", farDistance - margin + 0.01, 0.01, 0.0},
+                                                  true, hips),
+                      hips.size() - 1);
+  // The filter is disabled
+  BOOST_REQUIRE_EQUAL(filteredCollisions<SolverT>({"R_WRIST_Y_S", "R_HIP*", 0.1, 0.01, 0.0}, false, hips),
+                      hips.size());
+  // The filter only applies to wildcards
+  BOOST_REQUIRE_EQUAL(filteredCollisions<SolverT>({"R_WRIST_Y_S", hips[0], 0.1, 0.01, 0.0}, true, hips), 1);
+  BOOST_REQUIRE_EQUAL(filteredCollisions<SolverT>({"R_WRIST_Y_S", hips[1], 0.1, 0.01, 0.0}, true, hips), 1);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestBroadPhase)
+{
+  // Pairs that are far apart are culled by the broad phase, this must not change the solution
+  testBroadPhase<mc_solver::TasksQPSolver>();
+  testBroadPhase<mc_solver::TVMQPSolver>();
+}
+
+BOOST_AUTO_TEST_CASE(TestSelfCollisionFilter)
+{
+  // Wildcard pairs excluded by the robot's filter are not added unless they may come within the interaction distance
+  testSelfCollisionFilter<mc_solver::TasksQPSolver>();
+  testSelfCollisionFilter<mc_solver::TVMQPSolver>();
+}
@@ -286,5 +286,10 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(TestConstraintSetLoaderTasksBackend, T, test_types
   auto conf = tester.json();
   auto loaded = mc_solver::ConstraintSetLoader::load(solver, conf);
   tester.check(ref, loaded, solver);
+  // The update group is common to all constraints
+  BOOST_REQUIRE_EQUAL(loaded->updateGroup(), -1);
+  mc_rtc::Configuration grouped(conf);
+  grouped.add("updateGroup", 2);
+  BOOST_REQUIRE_EQUAL(mc_solver::ConstraintSetLoader::load(solver, grouped)->updateGroup(), 2);
   bfs::remove(conf);
 }
@@ -5,11 +5,15 @@
 #include <mc_rbdyn/RobotLoader.h>
 #include <mc_rbdyn/Robots.h>
 #include <mc_rbdyn/lipm_stabilizer/StabilizerConfiguration.h>
+#include <mc_rtc/ConcurrentDataStore.h>
 #include <mc_rtc/DataStore.h>
 #include <boost/test/unit_test.hpp>
 #include "utils.h"
 #include <Eigen/Core>
 
+#include <atomic>
+#include <thread>
+
 using DataStore = mc_rtc::DataStore;
 
 BOOST_AUTO_TEST_CASE(TestDataStore)
@@ -405,3 +409,54 @@ BOOST_AUTO_TEST_CASE(TestStabilizer)
   store.make<std::function<StabilizerConfiguration(void)>>("getConf");
   BOOST_CHECK_NO_THROW(store.get<std::function<StabilizerConfiguration(void)>>("getConf"));
 }
+
+BOOST_AUTO_TEST_CASE(TestConcurrentDataStore)
+{
+  mc_rtc::ConcurrentDataStore store;
+  auto & slot = store.make<Eigen::Vector6d>("vec", Eigen::Vector6d::Zero());
+  BOOST_CHECK(store.has("vec"));
+  BOOST_CHECK(slot.version() == 0);
+  BOOST_CHECK_THROW(store.make<Eigen::Vector6d>("vec"), std::runtime_error);
+  BOOST_CHECK_THROW(store.get<Eigen::Vector3d>("vec"), std::runtime_error);
+  BOOST_CHECK_THROW(store.get<Eigen::Vector6d>("non-existing key"), std::runtime_error);
+  BOOST_CHECK(&store.get<Eigen::Vector6d>("vec") == &slot);
+  // Failed calls leave the store untouched
+  BOOST_CHECK(store.keys() == std::vector<std::string>{"vec"});
+
+  store.write("vec", Eigen::Vector6d::Constant(42.0));
+  BOOST_CHECK(slot.version() == 1);
+  BOOST_CHECK(store.read<Eigen::Vector6d>("vec") == Eigen::Vector6d::Constant(42.0));
+
+  // A writer publishes vectors with identical coefficients, readers must never see a torn value
+  // Boost.Test assertions are not thread-safe so failures are counted and checked afterwards
+  std::atomic<bool> done{false};
+  std::atomic<size_t> failures{0};
+  std::thread writer(
+      [&]()
+      {
+        for(size_t i = 0; i < 100000; ++i) { slot.write(Eigen::Vector6d::Constant(static_cast<double>(i))); }
+        done = true;
+      });
+  auto reader = [&]()
+  {
+    Eigen::Vector6d v;
+    size_t prev = 0;
+    while(!done)
+    {
+      size_t version = slot.read(v);
+      if(version < prev || !(v.array() == v(0)).all()) { ++failures; }
+      prev = version;
+    }
+  };
+  std::thread reader1(reader);
+  std::thread reader2(reader);
+  writer.join();
+  reader1.join();
+  reader2.join();
+  BOOST_CHECK(failures == 0);
+  BOOST_CHECK(slot.version() == 100001);
+  BOOST_CHECK(slot.read() == Eigen::Vector6d::Constant(99999.0));
+
+  store.remove("vec");
+  BOOST_CHECK(!store.has("vec"));
+}
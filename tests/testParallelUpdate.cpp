@@ -0,0 +1,236 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rbdyn/RobotLoader.h>
+#include <mc_rbdyn/Robots.h>
+
+#include <mc_solver/CollisionsConstraint.h>
+#include <mc_solver/ConstraintSet.h>
+#include <mc_solver/TVMQPSolver.h>
+#include <mc_solver/TasksQPSolver.h>
+
+#include <mc_tasks/CoMTask.h>
+#include <mc_tasks/EndEffectorTask.h>
+#include <mc_tasks/PostureTask.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <thread>
+
+#include "utils.h"
+
+namespace
+{
+
+mc_rbdyn::RobotsPtr make_robots()
+{
+  configureRobotLoader();
+  auto rm = mc_rbdyn::RobotLoader::get_robot_module("JVRC1");
+  auto env = mc_rbdyn::RobotLoader::get_robot_module("env/ground");
+  return mc_rbdyn::loadRobotAndEnv(*rm, *env);
+}
+
+/** Records which object was updated, in which order and on which thread */
+struct UpdateLog
+{
+  void record(const std::string & name)
+  {
+    std::unique_lock<std::mutex> lck(mutex_);
+    events_.push_back({name, std::this_thread::get_id()});
+  }
+
+  void clear() { events_.clear(); }
+
+  size_t size() const noexcept { return events_.size(); }
+
+  size_t index(const std::string & name) const
+  {
+    auto it = std::find_if(events_.begin(), events_.end(), [&](const auto & e) { return e.first == name; });
+    BOOST_REQUIRE(it != events_.end());
+    return static_cast<size_t>(std::distance(events_.begin(), it));
+  }
+
+  std::thread::id thread(const std::string & name) const { return events_[index(name)].second; }
+
+private:
+  std::mutex mutex_;
+  std::vector<std::pair<std::string, std::thread::id>> events_;
+};
+
+/** A constraint that only records its updates */
+struct ProbeConstraint : public mc_solver::ConstraintSet
+{
+  ProbeConstraint(UpdateLog & log, const std::string & name, int group) : log_(log), name_(name)
+  {
+    updateGroup(group);
+  }
+
+  void update(mc_solver::QPSolver &) override { log_.record(name_); }
+
+protected:
+  void addToSolverImpl(mc_solver::QPSolver &) override {}
+
+  void removeFromSolverImpl(mc_solver::QPSolver &) override {}
+
+private:
+  UpdateLog & log_;
+  std::string name_;
+};
+
+/** A posture task that records its updates, it can also take some time and change its target in its update */
+struct ProbePostureTask : public mc_tasks::PostureTask
+{
+  ProbePostureTask(const mc_solver::QPSolver & solver, UpdateLog * log, const std::string & name, int group)
+  : mc_tasks::PostureTask(solver, 0, 5.0, 1.0), log_(log)
+  {
+    this->name(name);
+    updateGroup(group);
+  }
+
+  /** Sleep for \p delay and move the neck target in every update */
+  std::chrono::microseconds delay{0};
+
+protected:
+  void update(mc_solver::QPSolver & solver) override
+  {
+    if(delay.count())
+    {
+      std::this_thread::sleep_for(delay);
+      target({{"NECK_Y", {0.5 * std::sin(0.05 * static_cast<double>(iter_++))}}});
+    }
+    if(log_) { log_->record(name()); }
+    mc_tasks::PostureTask::update(solver);
+  }
+
+private:
+  UpdateLog * log_;
+  size_t iter_ = 0;
+};
+
+template<typename SolverT>
+void testUpdateOrder()
+{
+  SolverT solver(make_robots(), 0.005);
+  solver.parallelUpdate(3);
+  BOOST_REQUIRE_EQUAL(solver.parallelUpdate(), 3);
+  UpdateLog log;
+  ProbeConstraint c0(log, "c0", 0);
+  ProbeConstraint c1(log, "c1", 1);
+  ProbeConstraint c2(log, "c2", -1);
+  ProbeConstraint c3(log, "c3", 0);
+  ProbeConstraint c4(log, "c4", -1);
+  for(auto * c : {&c0, &c1, &c2, &c3, &c4}) { solver.addConstraintSet(*c); }
+  auto t0 = std::make_shared<ProbePostureTask>(solver, &log, "t0", 1);
+  auto t1 = std::make_shared<ProbePostureTask>(solver, &log, "t1", -1);
+  auto t2 = std::make_shared<ProbePostureTask>(solver, &log, "t2", 1);
+  // Slow down the first group so that the other objects would be updated first if the groups were not joined
+  t0->delay = std::chrono::microseconds(2000);
+  for(const auto & t : {t0, t1, t2}) { solver.addTask(t); }
+  const auto main = std::this_thread::get_id();
+  for(size_t i = 0; i < 20; ++i)
+  {
+    log.clear();
+    BOOST_REQUIRE(solver.run());
+    BOOST_REQUIRE_EQUAL(log.size(), 8);
+    // Objects in the same group are updated in order on the same thread
+    BOOST_REQUIRE(log.index("c0") < log.index("c3"));
+    BOOST_REQUIRE(log.thread("c0") == log.thread("c3"));
+    BOOST_REQUIRE(log.index("t0") < log.index("t2"));
+    BOOST_REQUIRE(log.thread("t0") == log.thread("t2"));
+    // Objects without a group are updated in order on the solver thread once the groups are done
+    BOOST_REQUIRE(log.thread("c2") == main);
+    BOOST_REQUIRE(log.thread("c4") == main);
+    BOOST_REQUIRE(log.thread("t1") == main);
+    BOOST_REQUIRE(log.index("c2") < log.index("c4"));
+    for(const auto & c : {"c0", "c1", "c3"}) { BOOST_REQUIRE(log.index(c) < log.index("c2")); }
+    BOOST_REQUIRE(log.index("t2") < log.index("t1"));
+    // Constraints are updated before tasks
+    BOOST_REQUIRE(log.index("c4") < log.index("t0"));
+  }
+}
+
+/** A problem with update groups, the result must not depend on the number of threads */
+template<typename SolverT>
+struct ParallelSetup
+{
+  ParallelSetup(size_t threads) : solver(make_robots(), 0.005), collisions(solver.robots(), 0, 0, solver.dt())
+  {
+    solver.parallelUpdate(threads);
+    // In Tasks backend, the broad phase resizes the problem from the collisions group
+    collisions.broadPhase(true);
+    collisions.automaticMonitor(false);
+    collisions.updateGroup(0);
+    solver.addConstraintSet(collisions);
+    collisions.addCollisions(solver, solver.robot().module().commonSelfCollisions());
+    posture = std::make_shared<mc_tasks::PostureTask>(solver, 0, 10.0, 1.0);
+    posture->target({{"R_SHOULDER_R", {-0.2}}, {"L_SHOULDER_R", {0.2}}, {"R_ELBOW_P", {-2.0}}, {"L_ELBOW_P", {-2.0}}});
+    solver.addTask(posture);
+    com = std::make_shared<mc_tasks::CoMTask>(solver.robots(), 0, 5.0, 100.0);
+    com->move_com(Eigen::Vector3d(0.0, 0.0, -0.05));
+    com->updateGroup(1);
+    solver.addTask(com);
+    left = std::make_shared<mc_tasks::EndEffectorTask>(solver.robot().frame("L_WRIST_Y_S"), 5.0, 10.0);
+    left->add_ef_pose(sva::PTransformd(Eigen::Vector3d(0.05, 0.0, 0.05)));
+    left->updateGroup(1);
+    solver.addTask(left);
+    right = std::make_shared<mc_tasks::EndEffectorTask>(solver.robot().frame("R_WRIST_Y_S"), 5.0, 10.0);
+    right->add_ef_pose(sva::PTransformd(Eigen::Vector3d(0.05, 0.0, 0.05)));
+    right->updateGroup(2);
+    solver.addTask(right);
+    // The solution depends on the target set in this update, it would differ if the problem was solved before the join
+    neck = std::make_shared<ProbePostureTask>(solver, nullptr, "neck", 3);
+    neck->delay = std::chrono::microseconds(1000);
+    solver.addTask(neck);
+  }
+
+  SolverT solver;
+  mc_solver::CollisionsConstraint collisions;
+  std::shared_ptr<mc_tasks::PostureTask> posture;
+  std::shared_ptr<mc_tasks::CoMTask> com;
+  std::shared_ptr<mc_tasks::EndEffectorTask> left;
+  std::shared_ptr<mc_tasks::EndEffectorTask> right;
+  std::shared_ptr<ProbePostureTask> neck;
+};
+
+template<typename SolverT>
+void testDeterminism()
+{
+  ParallelSetup<SolverT> serial(1);
+  ParallelSetup<SolverT> parallel(4);
+  BOOST_REQUIRE_EQUAL(serial.solver.parallelUpdate(), 1);
+  BOOST_REQUIRE_EQUAL(parallel.solver.parallelUpdate(), 4);
+  const auto & q_serial = serial.solver.robot().mbc().q;
+  const auto & q_parallel = parallel.solver.robot().mbc().q;
+  for(size_t i = 0; i < 300; ++i)
+  {
+    BOOST_REQUIRE(serial.solver.run());
+    BOOST_REQUIRE(parallel.solver.run());
+    for(size_t j = 0; j < q_serial.size(); ++j)
+    {
+      for(size_t k = 0; k < q_serial[j].size(); ++k)
+      {
+        BOOST_REQUIRE_SMALL(q_serial[j][k] - q_parallel[j][k], 1e-10);
+      }
+    }
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestParallelUpdateOrder)
+{
+  testUpdateOrder<mc_solver::TasksQPSolver>();
+  testUpdateOrder<mc_solver::TVMQPSolver>();
+}
+
+BOOST_AUTO_TEST_CASE(TestParallelUpdateDeterminism)
+{
+  // The parallel update gives the same result as the serial update
+  testDeterminism<mc_solver::TasksQPSolver>();
+  testDeterminism<mc_solver::TVMQPSolver>();
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rbdyn/RobotLoader.h>
+#include <mc_rbdyn/Robots.h>
+#include <mc_rtc/config.h>
+
+#include <mc_solver/TVMQPSolver.h>
+#include <mc_solver/TasksQPSolver.h>
+#include <mc_solver/utils/ContactsDiff.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include "utils.h"
+
+mc_rbdyn::RobotsPtr make_robots()
+{
+  configureRobotLoader();
+  auto rm = mc_rbdyn::RobotLoader::get_robot_module("JVRC1");
+  auto env = mc_rbdyn::RobotLoader::get_robot_module("env", std::string(mc_rtc::MC_ENV_DESCRIPTION_PATH),
+                                                     std::string("ground"));
+  return mc_rbdyn::loadRobots({rm, env});
+}
+
+BOOST_AUTO_TEST_CASE(TestContactsDiff)
+{
+  auto robots = make_robots();
+  mc_rbdyn::Contact left(*robots, "LeftFoot", "AllGround");
+  mc_rbdyn::Contact right(*robots, "RightFoot", "AllGround");
+  mc_rbdyn::Contact gripper(*robots, "LeftGripper", "AllGround");
+  mc_solver::utils::ContactsDiff diff({left, right}, {right, gripper, right});
+  BOOST_REQUIRE(!diff.sameContacts());
+  BOOST_REQUIRE(diff.removed == std::vector<size_t>{0});
+  BOOST_REQUIRE(diff.added == std::vector<size_t>{1});
+  BOOST_REQUIRE_EQUAL(diff.kept.size(), 1);
+  BOOST_REQUIRE_EQUAL(diff.kept[0].first, 1);
+  BOOST_REQUIRE_EQUAL(diff.kept[0].second, 0);
+  BOOST_REQUIRE(mc_solver::utils::ContactsDiff({left, right}, {right, left}).sameContacts());
+}
+
+template<typename SolverT>
+void testSetContacts()
+{
+  SolverT solver(make_robots(), 0.005);
+  auto & robots = solver.robots();
+  mc_rbdyn::Contact left(robots, "LeftFoot", "AllGround");
+  mc_rbdyn::Contact right(robots, "RightFoot", "AllGround");
+  solver.setContacts({left, right});
+  BOOST_REQUIRE(solver.contacts() == std::vector<mc_rbdyn::Contact>({left, right}));
+  BOOST_REQUIRE(solver.run());
+  solver.setContacts({right});
+  BOOST_REQUIRE(solver.contacts() == std::vector<mc_rbdyn::Contact>({right}));
+  BOOST_REQUIRE(solver.run());
+  solver.setContacts({right, left});
+  BOOST_REQUIRE_EQUAL(solver.contacts().size(), 2);
+  BOOST_REQUIRE(solver.run());
+  solver.setContacts({});
+  BOOST_REQUIRE(solver.contacts().empty());
+  BOOST_REQUIRE(solver.run());
+}
+
+BOOST_AUTO_TEST_CASE(TestSetContacts)
+{
+  testSetContacts<mc_solver::TasksQPSolver>();
+  testSetContacts<mc_solver::TVMQPSolver>();
+}
+
+BOOST_AUTO_TEST_CASE(TestResubmitContacts)
+{
+  // Re-submitting the same contacts after the robot moved refreshes the relative pose used by Tasks
+  mc_solver::TasksQPSolver solver(make_robots(), 0.005);
+  auto & robots = solver.robots();
+  auto & robot = solver.robot();
+  mc_rbdyn::Contact left(robots, "LeftFoot", "AllGround");
+  auto X_b1_b2 = [&]()
+  {
+    const auto & X_0_b1 = robot.bodyPosW(left.r1Surface()->bodyName());
+    const auto & X_0_b2 = robots.robot(left.r2Index()).bodyPosW(left.r2Surface()->bodyName());
+    return X_0_b2 * X_0_b1.inv();
+  };
+  auto checkContact = [&]()
+  {
+    auto qp_c = solver.contactById(left.contactId(robots));
+    BOOST_REQUIRE(qp_c.first != -1);
+    BOOST_REQUIRE_SMALL((qp_c.second.X_b1_b2.translation() - X_b1_b2().translation()).norm(), 1e-12);
+    BOOST_REQUIRE_SMALL((qp_c.second.X_b1_b2.rotation() - X_b1_b2().rotation()).norm(), 1e-12);
+  };
+  solver.setContacts({left});
+  checkContact();
+  robot.posW(sva::PTransformd(Eigen::Vector3d(0.0, 0.0, 0.1)) * robot.posW());
+  robot.forwardKinematics();
+  solver.setContacts({left});
+  checkContact();
+  BOOST_REQUIRE(solver.run());
+}
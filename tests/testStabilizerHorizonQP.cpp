@@ -0,0 +1,130 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_tasks/lipm_stabilizer/StabilizerTask.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+
+namespace
+{
+
+/** Gives access to the horizon CoP distribution workspace */
+struct StabilizerTaskAccess : public mc_tasks::lipm_stabilizer::StabilizerTask
+{
+  using StabilizerTask::HorizonQPWorkspace;
+};
+
+using HorizonQPWorkspace = StabilizerTaskAccess::HorizonQPWorkspace;
+
+constexpr double copWeight = 100.0;
+constexpr double copDiffWeight = 1.0;
+constexpr double copRegulationWeight = 0.1;
+
+/** Fill \p qp with a random feasible horizon of \p n references, the data is built as in computeCoPonHorizon */
+void randomHorizon(std::mt19937 & gen, HorizonQPWorkspace & qp, int n, double delta, double delay, double delayCoP)
+{
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  auto random = [&](double min, double max) { return min + (max - min) * unit(gen); };
+  qp.resize(n);
+  const Eigen::Vector2d lambda{random(10, 100), random(10, 100)};
+  const double halfLength = random(0.05, 0.12);
+  const double halfWidth = random(0.03, 0.07);
+  Eigen::Matrix<double, 4, 2> normals;
+  normals << 1, 0, -1, 0, 0, 1, 0, -1;
+  const Eigen::Vector4d offset{halfLength, halfLength, halfWidth, halfWidth};
+  // The measured CoPs are inside the contact polygon so that the constraints are feasible
+  const Eigen::Vector2d leftCoP{random(-halfLength, halfLength), random(-halfWidth, halfWidth)};
+  const Eigen::Vector2d rightCoP{random(-halfLength, halfLength), random(-halfWidth, halfWidth)};
+  const Eigen::Matrix2d R_lc_0 = Eigen::Rotation2Dd(random(-0.3, 0.3)).toRotationMatrix();
+  const Eigen::Matrix2d R_rc_0 = Eigen::Rotation2Dd(random(-0.3, 0.3)).toRotationMatrix();
+  const Eigen::Vector2d leftPos{random(-0.02, 0.02), random(0.08, 0.12)};
+  const Eigen::Vector2d rightPos{random(-0.02, 0.02), random(-0.12, -0.08)};
+  for(Eigen::Index i = 0; i < n; ++i)
+  {
+    const double d = i == 0 ? delay : delayCoP;
+    double t = static_cast<double>(i) * delta;
+    const Eigen::Vector2d expDecay{exp(-lambda.x() * (t + delta - d)), exp(-lambda.y() * (t + delta - d))};
+    for(Eigen::Index k = 0; k <= i; ++k)
+    {
+      const double dk = k == i ? delta - d : delta;
+      qp.Lx(i, k) = (1 - exp(-lambda.x() * dk)) * exp(-lambda.x() * t);
+      qp.Ly(i, k) = (1 - exp(-lambda.y() * dk)) * exp(-lambda.y() * t);
+      t -= delta;
+    }
+    const double ratio = random(0.1, 0.9);
+    qp.Mstep.block<2, 2>(2 * i, 0) = (1 - ratio) * R_lc_0;
+    qp.Mstep.block<2, 2>(2 * i, 2) = ratio * R_rc_0;
+    const Eigen::Vector2d zmp = (1 - ratio) * leftPos + ratio * rightPos
+                                + Eigen::Vector2d{random(-halfLength, halfLength), random(-halfWidth, halfWidth)};
+    qp.bcop.segment<2>(2 * i) = zmp - (1 - ratio) * leftPos - ratio * rightPos
+                                - (1 - ratio) * R_lc_0 * expDecay.cwiseProduct(leftCoP)
+                                - ratio * R_rc_0 * expDecay.cwiseProduct(rightCoP);
+    qp.bcopReg.segment<2>(2 * i) = -expDecay.cwiseProduct(leftCoP);
+    qp.bcopReg.segment<2>(2 * (i + n)) = -expDecay.cwiseProduct(rightCoP);
+    qp.bineq.segment<4>(4 * i) = offset - normals * expDecay.cwiseProduct(leftCoP);
+    qp.bineq.segment<4>(4 * (i + n)) = offset - normals * expDecay.cwiseProduct(rightCoP);
+    qp.bcopDiff.segment<2>(2 * i) = expDecay.cwiseProduct(leftCoP - rightCoP);
+  }
+}
+
+/** Wrench applied at \p cop by a vertical force \p fz, as in computeCoPonHorizon */
+Eigen::Vector6d wrench(const Eigen::Vector2d & cop, double fz)
+{
+  Eigen::Vector6d out;
+  out << cop.y() * fz, -cop.x() * fz, 0, 0, 0, fz;
+  return out;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestHorizonStructuredSolve)
+{
+  // The iteration by iteration resolution must match the dense QP on random feasible horizons, the delays are kept
+  // below half the sampling period since the dense problem becomes ill-conditioned for long horizons otherwise
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  HorizonQPWorkspace qp;
+  for(size_t trial = 0; trial < 200; ++trial)
+  {
+    const int n = 1 + static_cast<int>(trial % 15);
+    const double delta = 0.005 * (1 + static_cast<double>(trial % 4));
+    randomHorizon(gen, qp, n, delta, unit(gen) * 0.5 * delta, unit(gen) * 0.5 * delta);
+    BOOST_REQUIRE(qp.structured());
+    BOOST_REQUIRE(qp.solveDense(n, copWeight, copDiffWeight, copRegulationWeight));
+    const Eigen::VectorXd dense = qp.x;
+    BOOST_REQUIRE(qp.solve(n, copWeight, copDiffWeight, copRegulationWeight));
+    const Eigen::VectorXd & structured = qp.x;
+    const Eigen::Vector2d denseLeft = dense.segment<2>(0);
+    const Eigen::Vector2d denseRight = dense.segment<2>(2 * n);
+    const Eigen::Vector2d structuredLeft = structured.segment<2>(0);
+    const Eigen::Vector2d structuredRight = structured.segment<2>(2 * n);
+    BOOST_REQUIRE_SMALL((denseLeft - structuredLeft).norm(), 1e-8);
+    BOOST_REQUIRE_SMALL((denseRight - structuredRight).norm(), 1e-8);
+    const double fz = 100 + 500 * unit(gen);
+    BOOST_REQUIRE_SMALL((wrench(denseLeft, fz) - wrench(structuredLeft, fz)).norm(), 1e-6);
+    BOOST_REQUIRE_SMALL((wrench(denseRight, fz) - wrench(structuredRight, fz)).norm(), 1e-6);
+    BOOST_REQUIRE_SMALL((dense - structured).norm(), 1e-8);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestHorizonDenseFallback)
+{
+  // When the delay is (nearly) equal to the sampling period the modeled CoPs do not depend on the current reference
+  std::mt19937 gen(42);
+  HorizonQPWorkspace qp;
+  for(double eps : {0.0, 1e-12, 1e-10})
+  {
+    const int n = 5;
+    const double delta = 0.005;
+    randomHorizon(gen, qp, n, delta, delta - eps, 0.5 * delta);
+    BOOST_REQUIRE(!qp.structured());
+    // The dense problem may be singular, solve must give the same outcome anyway
+    const bool denseSolved = qp.solveDense(n, copWeight, copDiffWeight, copRegulationWeight);
+    const Eigen::VectorXd dense = qp.x;
+    BOOST_REQUIRE(qp.solve(n, copWeight, copDiffWeight, copRegulationWeight) == denseSolved);
+    if(denseSolved) { BOOST_REQUIRE_SMALL((dense - qp.x).norm(), 1e-12); }
+  }
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_control/mc_global_controller.h>
+#include <mc_rtc/gui/Button.h>
+#include <mc_rtc/io_utils.h>
+#include <mc_rtc/log/FlatLog.h>
+
+#include "utils.h"
+
+static bool initialized = configureRobotLoader();
+
+/** This test checks that the AsyncPostRun option does not change the behavior of the controller:
+ *
+ * - the log is the same with and without AsyncPostRun
+ * - a GUI request is applied before the next solve with AsyncPostRun
+ */
+
+namespace
+{
+
+const std::vector<std::string> category = {"AsyncPostRun"};
+
+mc_control::MCGlobalController::GlobalConfiguration makeConfiguration(const std::string & conf, bool async)
+{
+  mc_control::MCGlobalController::GlobalConfiguration config(conf);
+  config.enable_log = true;
+  config.log_policy = mc_rtc::Logger::Policy::NON_THREADED;
+  config.log_directory = bfs::temp_directory_path().string();
+  config.log_template = async ? "mc-rtc-test-async-post-run" : "mc-rtc-test-sync-post-run";
+  config.async_post_run = async;
+  config.enable_gui_server = true;
+  config.gui_server_configuration.ipc_socket = getTmpFile();
+  config.gui_server_configuration.tcp_config = std::nullopt;
+  return config;
+}
+
+/** Add a button that moves the posture target of \p joint */
+void addButton(mc_control::MCGlobalController & gc, const std::string & joint)
+{
+  gc.controller().gui()->addElement(category,
+                                    mc_rtc::gui::Button("Move",
+                                                        [&gc, joint]()
+                                                        {
+                                                          auto & robot = gc.controller().robot();
+                                                          auto posture = gc.controller().getPostureTask(robot.name());
+                                                          auto target = posture->posture();
+                                                          target[robot.jointIndexByName(joint)][0] += 0.1;
+                                                          posture->posture(target);
+                                                        }));
+}
+
+void pushButtonRequest(mc_control::MCGlobalController & gc)
+{
+  gc.server().push_requests({{category, "Move", mc_rtc::Configuration{}}});
+}
+
+/** Run the controller for \p nIter iterations and return the path to its log, the button is pushed half-way
+ *
+ * Without AsyncPostRun the requests are handled after the solve so the request is pushed one iteration earlier to
+ * affect the same solve
+ */
+std::string runAndLog(const std::string & conf, size_t nIter, bool async)
+{
+  mc_control::MCGlobalController gc(makeConfiguration(conf, async));
+  gc.init();
+  gc.running = true;
+  addButton(gc, gc.ref_joint_order()[0]);
+  for(size_t i = 0; i < nIter; ++i)
+  {
+    if(i + (async ? 0 : 1) == nIter / 2) { pushButtonRequest(gc); }
+    if(!gc.run()) { mc_rtc::log::error_and_throw("Failed at iteration {} (async: {})", i, async); }
+  }
+  return gc.controller().logger().path();
+}
+
+bool sameLogs(const std::string & syncPath, const std::string & asyncPath)
+{
+  mc_rtc::log::FlatLog syncLog(syncPath);
+  mc_rtc::log::FlatLog asyncLog(asyncPath);
+  bool ok = true;
+  auto check = [&ok](bool cond, const std::string & what)
+  {
+    if(!cond)
+    {
+      mc_rtc::log::critical("AsyncPostRun log differs: {}", what);
+      ok = false;
+    }
+  };
+  check(syncLog.size() == asyncLog.size(), "size");
+  check(syncLog.entries() == asyncLog.entries(), "entries");
+  for(const auto & entry : syncLog.entries())
+  {
+    // Timings are expected to differ
+    if(entry.rfind("perf_", 0) == 0 || !asyncLog.has(entry)) { continue; }
+    switch(syncLog.type(entry))
+    {
+      case mc_rtc::log::LogType::Double:
+        check(syncLog.get<double>(entry) == asyncLog.get<double>(entry), entry);
+        break;
+      case mc_rtc::log::LogType::VectorDouble:
+        check(syncLog.get<std::vector<double>>(entry) == asyncLog.get<std::vector<double>>(entry), entry);
+        break;
+      default:
+        break;
+    }
+  }
+  // The GUI event is logged one iteration earlier without AsyncPostRun
+  auto flatten = [](const mc_rtc::log::FlatLog & log)
+  {
+    std::vector<std::string> out;
+    for(const auto & events : log.guiEvents())
+    {
+      for(const auto & e : events) { out.push_back(mc_rtc::io::to_string(e.category, "/") + "/" + e.name); }
+    }
+    return out;
+  };
+  check(flatten(syncLog) == flatten(asyncLog), "GUI events");
+  check(flatten(asyncLog).size() == 1, "GUI events count");
+  return ok;
+}
+
+/** Check that a request pushed between two iterations affects the solve of the next iteration */
+bool requestAppliedBeforeSolve(const std::string & conf)
+{
+  mc_control::MCGlobalController gc(makeConfiguration(conf, true));
+  gc.init();
+  gc.running = true;
+  const auto & joint = gc.ref_joint_order()[0];
+  addButton(gc, joint);
+  for(size_t i = 0; i < 10; ++i) { gc.run(); }
+  auto jIdx = gc.controller().robot().jointIndexByName(joint);
+  double alpha = gc.controller().robot().mbc().alpha[jIdx][0];
+  pushButtonRequest(gc);
+  gc.run();
+  double alphaAfter = gc.controller().robot().mbc().alpha[jIdx][0];
+  if(alphaAfter - alpha < 1e-6)
+  {
+    mc_rtc::log::critical("GUI request was not applied before the solve (alpha: {} -> {})", alpha, alphaAfter);
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+  if(argc < 3)
+  {
+    mc_rtc::log::critical("Wrong usage, expected: {} [conf] [nIter]", argv[0]);
+    return 1;
+  }
+  std::string conf = argv[1];
+  size_t nIter = std::max<size_t>(std::stoul(argv[2]), 4);
+  auto syncLog = runAndLog(conf, nIter, false);
+  auto asyncLog = runAndLog(conf, nIter, true);
+  bool ok = sameLogs(syncLog, asyncLog);
+  bfs::remove(syncLog);
+  bfs::remove(asyncLog);
+  ok = requestAppliedBeforeSolve(conf) && ok;
+  return ok ? 0 : 1;
+}
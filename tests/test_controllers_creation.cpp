@@ -0,0 +1,154 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_control/mc_global_controller.h>
+
+#include "utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+static bool initialized = configureRobotLoader();
+
+/** This test checks the ParallelControllersCreation and LazyControllersCreation options:
+ *
+ * - all enabled controllers are available with both options
+ * - the first creation exception (in the order of the Enabled list) is re-thrown by the constructor
+ * - EnableController on a controller that is still being created switches once the controller is adopted
+ * - EnableController on a controller whose lazy creation fails keeps the current controller
+ *
+ * The test controllers are provided by TestControllersCreation.cpp
+ */
+
+namespace
+{
+
+bool ok = true;
+
+void check(bool cond, const std::string & what)
+{
+  if(!cond)
+  {
+    mc_rtc::log::critical("ControllersCreation test failed: {}", what);
+    ok = false;
+  }
+}
+
+std::string ctl(const std::string & name)
+{
+  return "TestControllersCreation_" + name;
+}
+
+mc_control::MCGlobalController::GlobalConfiguration makeConfig(const std::string & conf,
+                                                               const std::vector<std::string> & enabled,
+                                                               bool parallel,
+                                                               bool lazy)
+{
+  mc_control::MCGlobalController::GlobalConfiguration config(conf);
+  config.enable_log = false;
+  config.enable_gui_server = false;
+  config.include_halfsit_controller = false;
+  config.enabled_controllers.clear();
+  for(const auto & c : enabled) { config.enabled_controllers.push_back(ctl(c)); }
+  config.initial_controller = config.enabled_controllers[0];
+  config.parallel_controllers_creation = parallel;
+  config.lazy_controllers_creation = lazy;
+  return config;
+}
+
+bool isEnabled(const mc_control::MCGlobalController & gc, const std::string & name)
+{
+  auto enabled = gc.enabled_controllers();
+  return std::find(enabled.begin(), enabled.end(), ctl(name)) != enabled.end();
+}
+
+/** Run \p gc until \p done returns true or a timeout expires */
+template<typename Callback>
+bool runUntil(mc_control::MCGlobalController & gc, Callback && done)
+{
+  auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+  while(std::chrono::steady_clock::now() < timeout)
+  {
+    gc.run();
+    if(done()) { return true; }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  return false;
+}
+
+void testCreation(const std::string & conf, bool parallel, bool lazy)
+{
+  auto step = fmt::format("creation (parallel: {}, lazy: {})", parallel, lazy);
+  mc_control::MCGlobalController gc(makeConfig(conf, {"A", "B", "Slow"}, parallel, lazy));
+  gc.init();
+  check(gc.current_controller() == ctl("A"), step + ": initial controller");
+  for(const auto & c : {"A", "B", "Slow"}) { check(isEnabled(gc, c), step + ": " + c + " is enabled"); }
+  for(const auto & c : {"B", "Slow", "A"})
+  {
+    check(gc.EnableController(ctl(c)), step + ": enable " + c);
+    check(runUntil(gc, [&]() { return gc.current_controller() == ctl(c); }), step + ": switch to " + c);
+    for(size_t i = 0; i < 10; ++i) { check(gc.run(), step + ": run " + c); }
+  }
+}
+
+void testCreationFailure(const std::string & conf, bool parallel)
+{
+  // SlowThrow fails after Throw but comes first in the Enabled list
+  auto step = fmt::format("creation failure (parallel: {})", parallel);
+  try
+  {
+    mc_control::MCGlobalController gc(makeConfig(conf, {"A", "SlowThrow", "B", "Throw"}, parallel, false));
+    check(false, step + ": the constructor throws");
+  }
+  catch(const std::exception & e)
+  {
+    check(std::string(e.what()).find(ctl("SlowThrow")) != std::string::npos,
+          step + ": the first exception is re-thrown, got: " + e.what());
+  }
+}
+
+void testLazySwitch(const std::string & conf, bool parallel)
+{
+  auto step = fmt::format("lazy switch (parallel: {})", parallel);
+  mc_control::MCGlobalController gc(makeConfig(conf, {"A", "B", "Slow"}, parallel, true));
+  gc.init();
+  check(gc.EnableController(ctl("Slow")), step + ": EnableController accepts a pending controller");
+  gc.run();
+  check(gc.current_controller() == ctl("A"), step + ": the switch waits for the creation");
+  check(runUntil(gc, [&]() { return gc.current_controller() == ctl("Slow"); }), step + ": the switch happens");
+  for(size_t i = 0; i < 10; ++i) { check(gc.run(), step + ": run"); }
+}
+
+void testLazySwitchFailure(const std::string & conf, bool parallel)
+{
+  auto step = fmt::format("lazy switch failure (parallel: {})", parallel);
+  mc_control::MCGlobalController gc(makeConfig(conf, {"A", "SlowThrow"}, parallel, true));
+  gc.init();
+  check(gc.EnableController(ctl("SlowThrow")), step + ": EnableController accepts a pending controller");
+  check(runUntil(gc, [&]() { return !isEnabled(gc, "SlowThrow"); }), step + ": the failed controller is dropped");
+  check(gc.current_controller() == ctl("A"), step + ": the current controller remains active");
+  for(size_t i = 0; i < 10; ++i) { check(gc.run(), step + ": run"); }
+  check(!gc.EnableController(ctl("SlowThrow")), step + ": the failed controller cannot be enabled");
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+  if(argc < 2)
+  {
+    mc_rtc::log::critical("Wrong usage, expected: {} [conf]", argv[0]);
+    return 1;
+  }
+  std::string conf = argv[1];
+  for(bool parallel : {false, true})
+  {
+    for(bool lazy : {false, true}) { testCreation(conf, parallel, lazy); }
+    testCreationFailure(conf, parallel);
+    testLazySwitch(conf, parallel);
+    testLazySwitchFailure(conf, parallel);
+  }
+  return ok ? 0 : 1;
+}
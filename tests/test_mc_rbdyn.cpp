@@ -1,12 +1,24 @@
+#include <mc_rbdyn/GeometryCache.h>
 #include <mc_rbdyn/RobotLoader.h>
+#include <mc_rbdyn/RobotModuleBundle.h>
 #include <mc_rbdyn/Robots.h>
+#include <mc_rbdyn/SCHAddon.h>
+#include <mc_rbdyn/SelfCollisionFilter.h>
 #include <mc_rbdyn/rpy_utils.h>
+#include <mc_rbdyn/surface_hull.h>
+#include <mc_tvm/Robot.h>
 #include <boost/test/unit_test.hpp>
 #include "utils.h"
+#include <mc_rtc/path.h>
+#include <boost/filesystem.hpp>
 #include <chrono>
+#include <fstream>
 #include <random>
 
+#include <RBDyn/CoM.h>
+
 #include <sch/S_Object/S_Sphere.h>
+#include <sch/S_Polyhedron/S_Polyhedron.h>
 
 mc_rbdyn::Robots & get_robots()
 {
@@ -55,6 +67,25 @@ void TestRobotLoadingCommon(mc_rbdyn::RobotModulePtr rm, mc_rbdyn::RobotModulePt
   BOOST_REQUIRE_EQUAL(robotCopy.robotIndex(), 2);
   BOOST_REQUIRE_EQUAL(robotCopy.name(), "robotCopy");
   auto & robot = robots_ptr->robot("renamed");
+  // The module is shared between copies
+  BOOST_REQUIRE(&robot.module() == &robotCopy.module());
+  {
+    // The graph is shared until one of the copies is mutated
+    const auto & cRobot = robot;
+    const auto & cCopy = robotCopy;
+    BOOST_REQUIRE(&cRobot.mbg() == &cCopy.mbg());
+    auto nrBodies = cRobot.mbg().nrBodies();
+    robotCopy.mbg().addBody(rbd::Body(sva::RBInertiad(), "robotCopyExtraBody"));
+    BOOST_REQUIRE(&cRobot.mbg() != &cCopy.mbg());
+    BOOST_REQUIRE_EQUAL(cCopy.mbg().nrBodies(), nrBodies + 1);
+    BOOST_REQUIRE_EQUAL(cRobot.mbg().nrBodies(), nrBodies);
+    // The configuration is never shared
+    auto q = cRobot.mbc().q[1][0];
+    robotCopy.mbc().q[1][0] = q + 1.0;
+    BOOST_REQUIRE_EQUAL(cRobot.mbc().q[1][0], q);
+    robot.mbc().q[1][0] = q - 1.0;
+    BOOST_REQUIRE_EQUAL(cCopy.mbc().q[1][0], q + 1.0);
+  }
   for(const auto & c : robot.convexes()) { BOOST_REQUIRE(robotCopy.hasConvex(c.first)); }
   for(const auto & s : robot.surfaces()) { BOOST_REQUIRE(robotCopy.hasSurface(s.first)); }
   for(const auto & fs : robot.forceSensors()) { BOOST_REQUIRE(robotCopy.hasForceSensor(fs.name())); }
@@ -86,6 +117,226 @@ BOOST_AUTO_TEST_CASE(TestRobotLoadingWithCollisionObjects)
   TestRobotLoadingCommon(rm, envrm);
 }
 
+BOOST_AUTO_TEST_CASE(TestGeometryCache)
+{
+  configureRobotLoader();
+  auto rm = mc_rbdyn::RobotLoader::get_robot_module("JVRC1");
+  mc_rbdyn::GeometryCache::clear();
+  auto robots_a = mc_rbdyn::loadRobot(*rm);
+  auto cache_size = mc_rbdyn::GeometryCache::size();
+  BOOST_REQUIRE(cache_size > 0);
+  auto robots_b = mc_rbdyn::loadRobot(*rm);
+  BOOST_REQUIRE_EQUAL(mc_rbdyn::GeometryCache::size(), cache_size);
+  const auto & a = robots_a->robot();
+  const auto & b = robots_b->robot();
+  BOOST_REQUIRE_EQUAL(a.convexes().size(), b.convexes().size());
+  BOOST_REQUIRE_EQUAL(a.surfaces().size(), b.surfaces().size());
+  for(const auto & c : a.convexes())
+  {
+    BOOST_REQUIRE(b.hasConvex(c.first));
+    // Each robot owns its objects
+    BOOST_REQUIRE(c.second.second != b.convex(c.first).second);
+  }
+  for(const auto & s : a.surfaces())
+  {
+    BOOST_REQUIRE(b.hasSurface(s.first));
+    BOOST_REQUIRE(s.second != b.surfaces().at(s.first));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestSurfaceHullCache)
+{
+  const auto & robot = get_robots().robot();
+  std::vector<const mc_rbdyn::Surface *> surfaces;
+  for(const auto & s : robot.surfaces()) { surfaces.push_back(s.second.get()); }
+  BOOST_REQUIRE(surfaces.size() > 1);
+  mc_rbdyn::surface_hull_cache_clear();
+  auto hull = mc_rbdyn::surface_hull(*surfaces[0]);
+  BOOST_REQUIRE(hull);
+  BOOST_REQUIRE_EQUAL(mc_rbdyn::surface_hull_cache_size(), 1);
+  // Cached hulls are shared
+  BOOST_REQUIRE(mc_rbdyn::surface_hull(*surfaces[0]) == hull);
+  // Changing the parameters or the surface creates a new hull
+  BOOST_REQUIRE(mc_rbdyn::surface_hull(*surfaces[0], 0.02) != hull);
+  auto copy = surfaces[0]->copy();
+  copy->name(copy->name() + "_copy");
+  BOOST_REQUIRE(mc_rbdyn::surface_hull(*copy) != hull);
+  BOOST_REQUIRE_EQUAL(mc_rbdyn::surface_hull_cache_size(), 3);
+  // surface_to_sch returns an independent copy of the cached hull
+  std::unique_ptr<sch::S_Object> object(mc_rbdyn::surface_to_sch(*surfaces[0]));
+  BOOST_REQUIRE(object);
+  BOOST_REQUIRE(object.get() != hull.get());
+  BOOST_REQUIRE_EQUAL(static_cast<sch::S_Polyhedron *>(object.get())->getPolyhedronAlgorithm()->vertexes_.size(),
+                      hull->getPolyhedronAlgorithm()->vertexes_.size());
+  // Batch computation gives the same result as individual computations
+  auto hulls = mc_rbdyn::surface_hulls(surfaces, 0.01, 8, 4);
+  BOOST_REQUIRE_EQUAL(hulls.size(), surfaces.size());
+  BOOST_REQUIRE(hulls[0] == hull);
+  for(size_t i = 0; i < surfaces.size(); ++i) { BOOST_REQUIRE(hulls[i] == mc_rbdyn::surface_hull(*surfaces[i])); }
+  // The least recently used hulls are evicted first
+  auto capacity = mc_rbdyn::surface_hull_cache_capacity();
+  mc_rbdyn::surface_hull_cache_capacity(1);
+  BOOST_REQUIRE_EQUAL(mc_rbdyn::surface_hull_cache_size(), 1);
+  BOOST_REQUIRE(mc_rbdyn::surface_hull(*surfaces.back()) == hulls.back());
+  BOOST_REQUIRE(mc_rbdyn::surface_hull(*surfaces[0]) != hull);
+  mc_rbdyn::surface_hull_cache_capacity(capacity);
+  mc_rbdyn::surface_hull_cache_clear();
+}
+
+BOOST_AUTO_TEST_CASE(TestBoundingSphere)
+{
+  auto & robot = get_robots().robot();
+  std::mt19937 gen(42);
+  std::normal_distribution<double> dist;
+  for(const auto & c : robot.convexes())
+  {
+    const auto & object = *c.second.second;
+    auto X_0_c = robot.collisionTransform(c.first) * robot.bodyPosW(c.second.first);
+    sch::mc_rbdyn::transform(*c.second.second, X_0_c);
+    Eigen::Vector3d center;
+    double radius;
+    sch::mc_rbdyn::boundingSphere(object, X_0_c, center, radius);
+    Eigen::Vector3d center_0 = (sva::PTransformd(center) * X_0_c).translation();
+    for(size_t i = 0; i < 100; ++i)
+    {
+      sch::Vector3 v(dist(gen), dist(gen), dist(gen));
+      auto p = object.support(v);
+      BOOST_REQUIRE((Eigen::Vector3d(p[0], p[1], p[2]) - center_0).norm() <= radius + 1e-9);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestSelfCollisionFilter)
+{
+  const auto & robot = get_robots().robot();
+  mc_rbdyn::SelfCollisionFilter::Options options;
+  options.samples = 20;
+  auto filter = mc_rbdyn::SelfCollisionFilter::compute(robot.module(), options);
+  BOOST_REQUIRE(filter.exclusions().size() > 0);
+  for(const auto & [names, e] : filter.exclusions())
+  {
+    BOOST_REQUIRE(filter.excluded(names.second, names.first));
+    if(e.reason == mc_rbdyn::SelfCollisionFilter::Reason::Far) { BOOST_REQUIRE(e.minDistance > options.distance); }
+  }
+  // Convexes attached to the same body are always excluded
+  for(const auto & c : robot.convexes())
+  {
+    for(const auto & c2 : robot.convexes())
+    {
+      if(c.first != c2.first && c.second.first == c2.second.first)
+      {
+        BOOST_REQUIRE(filter.excluded(c.first, c2.first));
+      }
+    }
+  }
+  auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("mc_rtc_filter_%%%%.yaml");
+  filter.save(path.string());
+  auto loaded = mc_rbdyn::SelfCollisionFilter::load(path.string());
+  boost::filesystem::remove(path);
+  BOOST_REQUIRE(loaded.exclusions().size() == filter.exclusions().size());
+  BOOST_REQUIRE(loaded.options().samples == options.samples);
+  for(const auto & [names, e] : filter.exclusions())
+  {
+    BOOST_REQUIRE(loaded.excluded(names.first, names.second));
+    BOOST_REQUIRE(loaded.exclusions().at(names).reason == e.reason);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestRobotModuleBundle)
+{
+  configureRobotLoader();
+  auto rm = mc_rbdyn::RobotLoader::get_robot_module("JVRC1");
+  auto dir = mc_rtc::temp_directory_path("mc_rtc_test_bundle");
+  boost::filesystem::remove_all(dir);
+  auto bundle = (boost::filesystem::path(dir) / "JVRC1.bin").string();
+  auto source = (boost::filesystem::path(dir) / "source.txt").string();
+  boost::filesystem::create_directories(dir);
+  {
+    std::ofstream ofs(source);
+    ofs << "source";
+  }
+  BOOST_REQUIRE(mc_rbdyn::RobotModuleBundle::load(bundle) == nullptr);
+  BOOST_REQUIRE(mc_rbdyn::RobotModuleBundle::save(*rm, bundle, {source}));
+  auto loaded = mc_rbdyn::RobotModuleBundle::load(bundle);
+  BOOST_REQUIRE(loaded);
+  BOOST_REQUIRE_EQUAL(loaded->name, rm->name);
+  BOOST_REQUIRE_EQUAL(loaded->urdf_path, rm->urdf_path);
+  BOOST_REQUIRE_EQUAL(loaded->rsdf_dir, rm->rsdf_dir);
+  BOOST_REQUIRE_EQUAL(loaded->mb.nrDof(), rm->mb.nrDof());
+  BOOST_REQUIRE_EQUAL(loaded->mbg.nrNodes(), rm->mbg.nrNodes());
+  BOOST_REQUIRE(loaded->ref_joint_order() == rm->ref_joint_order());
+  BOOST_REQUIRE(loaded->bounds() == rm->bounds());
+  BOOST_REQUIRE(loaded->stance() == rm->stance());
+  BOOST_REQUIRE(loaded->convexHull() == rm->convexHull());
+  BOOST_REQUIRE_EQUAL(loaded->_collision.size(), rm->_collision.size());
+  BOOST_REQUIRE_EQUAL(loaded->forceSensors().size(), rm->forceSensors().size());
+  BOOST_REQUIRE_EQUAL(loaded->grippers().size(), rm->grippers().size());
+  BOOST_REQUIRE_EQUAL(loaded->frames().size(), rm->frames().size());
+  {
+    // A robot created from the bundle matches a robot created from the original module
+    auto robots = mc_rbdyn::loadRobot(*rm);
+    auto robots_loaded = mc_rbdyn::loadRobot(*loaded);
+    const auto & robot = robots->robot();
+    const auto & robot_loaded = robots_loaded->robot();
+    BOOST_REQUIRE_EQUAL(robot.convexes().size(), robot_loaded.convexes().size());
+    BOOST_REQUIRE_EQUAL(robot.surfaces().size(), robot_loaded.surfaces().size());
+    BOOST_REQUIRE(robot.posW().translation().isApprox(robot_loaded.posW().translation()));
+    BOOST_REQUIRE(robot.com().isApprox(robot_loaded.com()));
+  }
+  // Changing a source invalidates the bundle
+  {
+    std::ofstream ofs(source, std::ios::app);
+    ofs << " modified";
+  }
+  BOOST_REQUIRE(mc_rbdyn::RobotModuleBundle::load(bundle) == nullptr);
+  // A custom post-processing callback cannot be stored
+  BOOST_REQUIRE(rm->hasDefaultControlToCanonicalPostProcess());
+  mc_rbdyn::RobotModule custom = *rm;
+  custom.controlToCanonicalPostProcess = [](const mc_rbdyn::Robot &, mc_rbdyn::Robot &) {};
+  BOOST_REQUIRE(!custom.hasDefaultControlToCanonicalPostProcess());
+  BOOST_REQUIRE(!mc_rbdyn::RobotModuleBundle::save(custom, bundle, {source}));
+  boost::filesystem::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_CASE(TestRobotLoaderBundles)
+{
+  configureRobotLoader();
+  auto dir = mc_rtc::temp_directory_path("mc_rtc_test_loader_bundles");
+  boost::filesystem::remove_all(dir);
+  boost::filesystem::create_directories(dir);
+  auto bundles = [&]()
+  {
+    std::vector<boost::filesystem::path> out;
+    for(const auto & p : boost::filesystem::directory_iterator(dir))
+    {
+      if(p.path().extension() == ".bin") { out.push_back(p.path()); }
+    }
+    return out;
+  };
+  mc_rbdyn::RobotLoader::enable_bundles(dir);
+  BOOST_REQUIRE_EQUAL(mc_rbdyn::RobotLoader::bundles_directory(), dir);
+  // The first request creates the module from its library and saves the bundle
+  auto rm = mc_rbdyn::RobotLoader::get_robot_module("JVRC1");
+  auto saved = bundles();
+  BOOST_REQUIRE_EQUAL(saved.size(), 1);
+  // Move the bundle modification time to the past, it would be updated if the bundle was saved again
+  auto past = boost::filesystem::last_write_time(saved[0]) - 3600;
+  boost::filesystem::last_write_time(saved[0], past);
+  // The second request loads the bundle
+  auto loaded = mc_rbdyn::RobotLoader::get_robot_module("JVRC1");
+  BOOST_REQUIRE(bundles() == saved);
+  BOOST_REQUIRE_EQUAL(boost::filesystem::last_write_time(saved[0]), past);
+  BOOST_REQUIRE(loaded != rm);
+  BOOST_REQUIRE_EQUAL(loaded->name, rm->name);
+  BOOST_REQUIRE(loaded->parameters() == rm->parameters());
+  BOOST_REQUIRE_EQUAL(loaded->mb.nrDof(), rm->mb.nrDof());
+  BOOST_REQUIRE(loaded->bounds() == rm->bounds());
+  BOOST_REQUIRE(loaded->hasDefaultControlToCanonicalPostProcess());
+  mc_rbdyn::RobotLoader::disable_bundles();
+  BOOST_REQUIRE(mc_rbdyn::RobotLoader::bundles_directory().empty());
+  boost::filesystem::remove_all(dir);
+}
+
 BOOST_AUTO_TEST_CASE(TestRobotPosWVelWAccW)
 {
   auto & robots = get_robots();
@@ -118,6 +369,148 @@ BOOST_AUTO_TEST_CASE(TestRobotPosWVelWAccW)
   }
 }
 
+BOOST_AUTO_TEST_CASE(TestRobotForwardAll)
+{
+  const auto & robot = get_robots().robot();
+  auto mbc = robot.mbc();
+  for(size_t i = 0; i < mbc.q.size(); ++i)
+  {
+    if(mbc.q[i].size() == 1) { mbc.q[i][0] += 0.5 * Eigen::Vector2d::Random()(0); }
+    for(auto & a : mbc.alpha[i]) { a = Eigen::Vector2d::Random()(0); }
+    for(auto & a : mbc.alphaD[i]) { a = Eigen::Vector2d::Random()(0); }
+  }
+  sva::MotionVecd A_0(Eigen::Vector3d::Random(), Eigen::Vector3d::Random());
+  auto expected = mbc;
+  robot.forwardKinematics(expected);
+  robot.forwardVelocity(expected);
+  robot.forwardAcceleration(expected, A_0);
+  auto checkKinematics = [&](const rbd::MultiBodyConfig & actual)
+  {
+    for(size_t i = 0; i < actual.bodyPosW.size(); ++i)
+    {
+      BOOST_REQUIRE(actual.bodyPosW[i].matrix().isApprox(expected.bodyPosW[i].matrix()));
+      BOOST_REQUIRE(actual.parentToSon[i].matrix().isApprox(expected.parentToSon[i].matrix()));
+    }
+  };
+  auto checkVelocity = [&](const rbd::MultiBodyConfig & actual)
+  {
+    for(size_t i = 0; i < actual.bodyVelB.size(); ++i)
+    {
+      BOOST_REQUIRE(actual.bodyVelB[i].vector().isApprox(expected.bodyVelB[i].vector()));
+      BOOST_REQUIRE(actual.bodyVelW[i].vector().isApprox(expected.bodyVelW[i].vector()));
+    }
+  };
+  {
+    auto actual = mbc;
+    robot.forwardAll(actual, mc_rbdyn::Robot::ForwardOrder::Acceleration, A_0);
+    checkKinematics(actual);
+    checkVelocity(actual);
+    for(size_t i = 0; i < actual.bodyAccB.size(); ++i)
+    {
+      BOOST_REQUIRE(actual.bodyAccB[i].vector().isApprox(expected.bodyAccB[i].vector()));
+    }
+  }
+  {
+    auto actual = mbc;
+    robot.forwardAll(actual, mc_rbdyn::Robot::ForwardOrder::Velocity);
+    checkKinematics(actual);
+    checkVelocity(actual);
+  }
+  {
+    auto actual = mbc;
+    robot.forwardAll(actual, mc_rbdyn::Robot::ForwardOrder::Kinematics);
+    checkKinematics(actual);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestRobotLazyKinematics)
+{
+  auto & robot = get_robots().robot();
+  auto initial = robot.mbc();
+  auto mbc = robot.mbc();
+  for(size_t i = 0; i < mbc.q.size(); ++i)
+  {
+    if(mbc.q[i].size() == 1) { mbc.q[i][0] += 0.5 * Eigen::Vector2d::Random()(0); }
+    for(auto & a : mbc.alpha[i]) { a = Eigen::Vector2d::Random()(0); }
+    for(auto & a : mbc.alphaD[i]) { a = Eigen::Vector2d::Random()(0); }
+  }
+  auto expected = mbc;
+  robot.forwardAll(expected);
+
+  robot.lazyKinematics(true);
+  BOOST_REQUIRE(robot.lazyKinematics());
+  robot.mbc() = mbc;
+  robot.forwardKinematics();
+  robot.forwardVelocity();
+  robot.forwardAcceleration();
+  // Nothing is computed until the kinematics are accessed through the robot
+  const auto & body = robot.mb().body(robot.mb().nrBodies() - 1).name();
+  auto bodyIdx = robot.bodyIndexByName(body);
+  BOOST_REQUIRE(robot.mbc().bodyPosW[bodyIdx] == mbc.bodyPosW[bodyIdx]);
+  // Only the chain from the root to the body is computed
+  BOOST_REQUIRE(robot.bodyPosW(body).matrix().isApprox(expected.bodyPosW[bodyIdx].matrix()));
+  BOOST_REQUIRE(robot.bodyVelW(body).vector().isApprox(expected.bodyVelW[bodyIdx].vector()));
+  BOOST_REQUIRE(robot.bodyAccB(body).vector().isApprox(expected.bodyAccB[bodyIdx].vector()));
+  std::vector<bool> inChain(robot.mbc().bodyPosW.size(), false);
+  for(int b = static_cast<int>(bodyIdx); b != -1; b = robot.mb().parent(b)) { inChain[static_cast<size_t>(b)] = true; }
+  for(size_t i = 0; i < inChain.size(); ++i)
+  {
+    if(inChain[i]) { BOOST_REQUIRE(robot.mbc().bodyPosW[i].matrix().isApprox(expected.bodyPosW[i].matrix())); }
+    else { BOOST_REQUIRE(robot.mbc().bodyPosW[i] == mbc.bodyPosW[i]); }
+  }
+  BOOST_REQUIRE(robot.com().isApprox(rbd::computeCoM(robot.mb(), expected)));
+  const auto & bodyPosW = robot.bodyPosW();
+  const auto & bodyVelW = robot.bodyVelW();
+  const auto & bodyAccB = robot.bodyAccB();
+  for(size_t i = 0; i < bodyPosW.size(); ++i)
+  {
+    BOOST_REQUIRE(bodyPosW[i].matrix().isApprox(expected.bodyPosW[i].matrix()));
+    BOOST_REQUIRE(bodyVelW[i].vector().isApprox(expected.bodyVelW[i].vector()));
+    BOOST_REQUIRE(bodyAccB[i].vector().isApprox(expected.bodyAccB[i].vector()));
+  }
+
+  // Only the requested orders are computed
+  robot.mbc().q = initial.q;
+  robot.forwardKinematics();
+  robot.lazyKinematics(false);
+  BOOST_REQUIRE(!robot.lazyKinematics());
+  auto kinematicsOnly = expected;
+  kinematicsOnly.q = initial.q;
+  robot.forwardKinematics(kinematicsOnly);
+  for(size_t i = 0; i < robot.mbc().bodyPosW.size(); ++i)
+  {
+    BOOST_REQUIRE(robot.mbc().bodyPosW[i].matrix().isApprox(kinematicsOnly.bodyPosW[i].matrix()));
+    BOOST_REQUIRE(robot.mbc().bodyVelW[i].vector().isApprox(expected.bodyVelW[i].vector()));
+  }
+
+  robot.mbc() = initial;
+  robot.forwardKinematics();
+}
+
+BOOST_AUTO_TEST_CASE(TestTVMRobotCopyPlan)
+{
+  const auto & robot = get_robots().robot();
+  const auto & tvm_robot = robot.tvmRobot();
+  auto mbc = robot.mbc();
+  for(size_t i = 0; i < mbc.q.size(); ++i)
+  {
+    for(auto & q : mbc.q[i]) { q = Eigen::Vector2d::Random()(0); }
+    for(auto & a : mbc.alpha[i]) { a = Eigen::Vector2d::Random()(0); }
+  }
+  Eigen::VectorXd q(robot.mb().nrParams());
+  tvm_robot.paramToVector(mbc.q, q);
+  BOOST_REQUIRE(q == rbd::paramToVector(robot.mb(), mbc.q));
+  Eigen::VectorXd alpha(robot.mb().nrDof());
+  tvm_robot.dofToVector(mbc.alpha, alpha);
+  BOOST_REQUIRE(alpha == rbd::dofToVector(robot.mb(), mbc.alpha));
+  auto alphaD = mbc.alphaD;
+  tvm_robot.vectorToDof(alpha, alphaD);
+  BOOST_REQUIRE(alphaD == mbc.alpha);
+  size_t nDof = 0;
+  for(const auto & s : tvm_robot.dofSegments()) { nDof += static_cast<size_t>(s.size); }
+  BOOST_REQUIRE_EQUAL(nDof, static_cast<size_t>(robot.mb().nrDof()));
+}
+
 BOOST_AUTO_TEST_CASE(TestRobotZMPSimple)
 {
   auto & robots = get_robots();
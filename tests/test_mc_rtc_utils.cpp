@@ -1,5 +1,10 @@
+#include <mc_rtc/AllocationTracker.h>
+#include <mc_rtc/LatencyHistogram.h>
+#include <mc_rtc/WorkerPool.h>
 #include <mc_rtc/constants.h>
 #include <boost/test/unit_test.hpp>
+#include <cstdlib>
+#include <stdexcept>
 
 BOOST_AUTO_TEST_CASE(TestConstants)
 {
@@ -11,3 +16,114 @@ BOOST_AUTO_TEST_CASE(TestConstants)
 
   BOOST_REQUIRE(cst::GRAVITY > 0);
 }
+
+BOOST_AUTO_TEST_CASE(TestLatencyHistogram)
+{
+  mc_rtc::LatencyHistogram hist;
+  BOOST_REQUIRE(hist.count() == 0);
+  BOOST_REQUIRE(hist.percentile(99) == 0);
+  // 1000 samples from 0.001ms to 1ms
+  for(size_t i = 1; i <= 1000; ++i) { hist.record(static_cast<double>(i) * 1e-3); }
+  BOOST_REQUIRE(hist.count() == 1000);
+  BOOST_CHECK_CLOSE(hist.min(), 1e-3, 1e-6);
+  BOOST_CHECK_CLOSE(hist.max(), 1.0, 1e-6);
+  BOOST_CHECK_CLOSE(hist.mean(), 0.5005, 1e-6);
+  BOOST_CHECK_CLOSE(hist.percentile(50), 0.5, 1.6);
+  BOOST_CHECK_CLOSE(hist.percentile(99), 0.99, 1.6);
+  BOOST_CHECK(hist.percentile(99) >= 0.99);
+  BOOST_CHECK_CLOSE(hist.percentile(100), 1.0, 1e-6);
+
+  mc_rtc::LatencyHistogram other;
+  other.record(10.0);
+  hist.merge(other);
+  BOOST_REQUIRE(hist.count() == 1001);
+  BOOST_CHECK_CLOSE(hist.max(), 10.0, 1e-6);
+  BOOST_CHECK_CLOSE(hist.percentile(100), 10.0, 1e-6);
+
+  hist.reset();
+  BOOST_REQUIRE(hist.count() == 0);
+  BOOST_REQUIRE(hist.max() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestWorkerPool)
+{
+  for(size_t n : {1, 2, 4})
+  {
+    mc_rtc::WorkerPool pool(n, std::chrono::microseconds(10));
+    BOOST_REQUIRE(pool.size() == n);
+    std::vector<size_t> values(1000, 0);
+    for(size_t k = 0; k < 100; ++k)
+    {
+      pool.run(values.size(), [&](size_t i) { values[i] += i; });
+      // Let the workers park from time to time
+      if(k % 10 == 0) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+    }
+    for(size_t i = 0; i < values.size(); ++i) { BOOST_REQUIRE(values[i] == 100 * i); }
+    BOOST_REQUIRE_THROW(pool.run(values.size(),
+                                 [](size_t i)
+                                 {
+                                   if(i == 999) { throw std::runtime_error("failure"); }
+                                 }),
+                        std::runtime_error);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestAllocationTracker)
+{
+  using Tracker = mc_rtc::AllocationTracker;
+  // Prevent the compiler from eliding the allocations
+  void * (*volatile allocate)(size_t) = std::malloc;
+  auto allocateIn = [&](const char * name, size_t n)
+  {
+    Tracker::Phase phase(name);
+    for(size_t i = 0; i < n; ++i) { std::free(allocate(64)); }
+  };
+
+  Tracker::reset();
+  Tracker::start();
+  BOOST_REQUIRE(Tracker::tracking());
+  allocateIn("NoAllocation", 0);
+  Tracker::stop();
+  BOOST_REQUIRE(Tracker::allocations() == 0);
+  BOOST_REQUIRE_NO_THROW(Tracker::check());
+
+#if defined(MC_RTC_HAS_ALLOCATION_HOOKS) && defined(__GLIBC__)
+  BOOST_REQUIRE(Tracker::hooksLoaded());
+
+  Tracker::start();
+  allocateIn("First", 3);
+  allocateIn("Second", 2);
+  {
+    Tracker::Pause pause;
+    allocateIn("Paused", 1);
+  }
+  Tracker::stop();
+  // Not tracked
+  allocateIn("Stopped", 1);
+
+  BOOST_REQUIRE(Tracker::allocations() == 5);
+  auto report = Tracker::report();
+  BOOST_REQUIRE(report.bytes == 5 * 64);
+  BOOST_REQUIRE(report.phases.size() == 2);
+  BOOST_REQUIRE(report.phases.at("First") == 3);
+  BOOST_REQUIRE(report.phases.at("Second") == 2);
+  // Sites are sorted by decreasing number of allocations
+  BOOST_REQUIRE(!report.sites.empty());
+  uint64_t siteAllocations = 0;
+  for(size_t i = 0; i < report.sites.size(); ++i)
+  {
+    const auto & site = report.sites[i];
+    BOOST_REQUIRE(site.phase == "First" || site.phase == "Second");
+    BOOST_REQUIRE(!site.backtrace.empty());
+    if(i > 0) { BOOST_REQUIRE(site.count <= report.sites[i - 1].count); }
+    siteAllocations += site.count;
+  }
+  BOOST_REQUIRE(siteAllocations == 5);
+  BOOST_REQUIRE_NO_THROW(Tracker::check(5));
+  BOOST_REQUIRE_THROW(Tracker::check(), std::runtime_error);
+
+  Tracker::reset();
+  BOOST_REQUIRE(Tracker::allocations() == 0);
+  BOOST_REQUIRE(Tracker::report().sites.empty());
+#endif
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_control/mc_global_controller.h>
+#include <mc_rbdyn/RobotLoader.h>
+
+#include "utils.h"
+
+static bool initialized = configureRobotLoader();
+
+/** This test checks that MCGlobalController::SensorLayout follows the robots of the controller:
+ *
+ * - the layout keeps working when the indices of the robots change
+ * - the layout writes into the new robot when a robot is removed and loaded again
+ * - the layout is rejected when the new robot does not have the sensors of the layout
+ */
+
+namespace
+{
+
+bool ok = true;
+
+void check(bool cond, const std::string & what)
+{
+  if(!cond)
+  {
+    mc_rtc::log::critical("SensorLayout test failed: {}", what);
+    ok = false;
+  }
+}
+
+template<typename Callback>
+bool throws(Callback && cb)
+{
+  try
+  {
+    cb();
+  }
+  catch(const std::exception &)
+  {
+    return true;
+  }
+  return false;
+}
+
+/** Set the layout sensors and check that they were written to \p robot */
+void checkSetters(mc_control::MCGlobalController & gc,
+                  mc_control::MCGlobalController::SensorLayout & layout,
+                  const mc_rbdyn::Robot & robot,
+                  double value,
+                  const std::string & step)
+{
+  std::vector<sva::ForceVecd> wrenches(layout.forceSensors.size(), sva::ForceVecd(Eigen::Vector6d::Constant(value)));
+  std::vector<double> values(layout.joints.size(), value);
+  std::vector<Eigen::Quaterniond, Eigen::aligned_allocator<Eigen::Quaterniond>> oris(
+      layout.bodySensors.size(), Eigen::Quaterniond(Eigen::AngleAxisd(value, Eigen::Vector3d::UnitZ())));
+  gc.setWrenches(layout, wrenches);
+  gc.setJointMotorTemperatures(layout, values);
+  gc.setJointDriverTemperatures(layout, values.data(), values.size());
+  gc.setJointMotorCurrents(layout, values);
+  gc.setSensorOrientations(layout, oris);
+  for(const auto & fs : layout.forceSensors)
+  {
+    check(robot.forceSensor(fs).wrench().vector() == wrenches[0].vector(), step + ": wrench of " + fs);
+  }
+  for(const auto & j : layout.joints)
+  {
+    const auto & js = robot.jointJointSensor(j);
+    check(js.motorTemperature() == value, step + ": motor temperature of " + j);
+    check(js.driverTemperature() == value, step + ": driver temperature of " + j);
+    check(js.motorCurrent() == value, step + ": motor current of " + j);
+  }
+  for(const auto & bs : layout.bodySensors)
+  {
+    check(robot.bodySensor(bs).orientation().isApprox(oris[0]), step + ": orientation of " + bs);
+  }
+  check(throws([&]() { gc.setWrenches(layout, wrenches.data(), wrenches.size() + 1); }), step + ": size check");
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+  if(argc < 2)
+  {
+    mc_rtc::log::critical("Wrong usage, expected: {} [conf]", argv[0]);
+    return 1;
+  }
+  mc_control::MCGlobalController::GlobalConfiguration config(argv[1]);
+  config.enable_log = false;
+  config.enable_gui_server = false;
+  mc_control::MCGlobalController gc(config);
+  gc.init();
+  auto & robots = gc.controller().robots();
+  const auto & mainRobot = robots.robot();
+
+  // Two copies of the main robot, the layout refers to the second one
+  robots.robotCopy(mainRobot, "copyA");
+  robots.robotCopy(robots.robot(), "copyB");
+  std::vector<std::string> forceSensors;
+  for(const auto & fs : robots.robot("copyB").forceSensors()) { forceSensors.push_back(fs.name()); }
+  std::vector<std::string> bodySensors;
+  for(const auto & bs : robots.robot("copyB").bodySensors()) { bodySensors.push_back(bs.name()); }
+  std::vector<std::string> joints;
+  for(const auto & js : robots.robot("copyB").data()->jointSensors) { joints.push_back(js.joint()); }
+  check(!forceSensors.empty() && !bodySensors.empty() && !joints.empty(), "the test robot has sensors");
+  auto layout = gc.makeSensorLayout("copyB", forceSensors, joints, bodySensors);
+  checkSetters(gc, layout, robots.robot("copyB"), 1.0, "initial");
+
+  // Removing copyA changes the index of copyB
+  robots.removeRobot("copyA");
+  checkSetters(gc, layout, robots.robot("copyB"), 2.0, "index change");
+
+  // Removing and loading copyB again creates a new robot
+  robots.removeRobot("copyB");
+  check(throws([&]() { gc.setWrenches(layout, std::vector<sva::ForceVecd>(forceSensors.size())); }), "removed robot");
+  robots.robotCopy(robots.robot(), "copyB");
+  checkSetters(gc, layout, robots.robot("copyB"), 3.0, "reload");
+
+  // copyB is replaced by a robot that does not have the sensors of the layout
+  robots.removeRobot("copyB");
+  auto ground = mc_rbdyn::RobotLoader::get_robot_module("env/ground");
+  robots.load("copyB", *ground);
+  check(throws([&]() { gc.setWrenches(layout, std::vector<sva::ForceVecd>(forceSensors.size())); }),
+        "sensors layout change");
+  robots.removeRobot("copyB");
+
+  // A new layout for the main robot is resolved independently
+  auto mainLayout = gc.makeSensorLayout(mainRobot.name(), forceSensors, joints, bodySensors);
+  checkSetters(gc, mainLayout, robots.robot(), 4.0, "main robot");
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rbdyn/RobotLoader.h>
+#include <mc_rbdyn/SelfCollisionFilter.h>
+
+#include <mc_rtc/logging.h>
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+#include <iostream>
+
+int main(int argc, char * argv[])
+{
+  std::vector<std::string> robot;
+  std::string output;
+  mc_rbdyn::SelfCollisionFilter::Options options;
+  po::options_description desc("mc_self_collision_filter options");
+  // clang-format off
+  desc.add_options()
+    ("help", "Show this help message")
+    ("robot", po::value<std::vector<std::string>>(&robot)->multitoken()->required(), "Robot module parameters (e.g. JVRC1)")
+    ("samples,n", po::value<size_t>(&options.samples)->default_value(options.samples), "Number of sampled configurations")
+    ("distance,d", po::value<double>(&options.distance)->default_value(options.distance), "Pairs that never come closer than this distance (m) are excluded")
+    ("seed,s", po::value<unsigned int>(&options.seed)->default_value(options.seed), "Seed of the random generator")
+    ("threads,j", po::value<size_t>(&options.threads)->default_value(options.threads), "Number of threads (0: all hardware threads)")
+    ("output,o", po::value<std::string>(&output), "Output file (defaults to the location where the RobotLoader looks for it)");
+  // clang-format on
+  po::positional_options_description pos;
+  pos.add("robot", -1);
+  po::variables_map vm;
+  po::store(po::command_line_parser(argc, argv).options(desc).positional(pos).run(), vm);
+  if(vm.count("help"))
+  {
+    std::cout << "Usage: mc_self_collision_filter [options] robot [robot parameters...]\n\n" << desc << "\n";
+    return 0;
+  }
+  po::notify(vm);
+  auto rm = mc_rbdyn::RobotLoader::get_robot_module(robot);
+  if(output.empty()) { output = mc_rbdyn::SelfCollisionFilter::defaultPath(*rm); }
+  mc_rtc::log::info("Sampling {} configurations of {}", options.samples, rm->name);
+  auto filter = mc_rbdyn::SelfCollisionFilter::compute(*rm, options);
+  size_t adjacent = 0;
+  size_t far = 0;
+  for(const auto & e : filter.exclusions())
+  {
+    if(e.second.reason == mc_rbdyn::SelfCollisionFilter::Reason::Adjacent) { adjacent++; }
+    else { far++; }
+  }
+  mc_rtc::log::success("Excluded {} adjacent pairs and {} far pairs", adjacent, far);
+  filter.save(output);
+  mc_rtc::log::info("Saved to {}", output);
+  return 0;
+}